@@ -14,57 +14,297 @@ constexpr uint32_t kHeartbeatTtlSec = 10;
  */
 constexpr size_t kDesiredJsonCapacity = 192;
 
+/**
+ * Stream wire formats for Desired entries. `kWireJson` carries the JSON document in a
+ * single `p` field; `kWireCompact` packs it into integer fields `m` (1 = on), `b`
+ * (brightness), `v` (ver) and, only for fades, `f` (fade_ms), which Redis stores as
+ * packed integers in the stream listpack. Receivers advertise the newest format they
+ * decode in `room:{id}:wire`; writers fall back to JSON when that key is missing.
+ * Snapshot keys always stay JSON.
+ */
+constexpr uint8_t kWireJson = 1;
+constexpr uint8_t kWireCompact = 2;
+/** Compact, and the receiver runs `fade_ms` ramps itself (writers send one per ramp). */
+constexpr uint8_t kWireFade = 3;
+/** Number of stream arguments (name/value pairs) `encodeDesiredCompact` fills for a step. */
+constexpr uint8_t kCompactFieldArgs = 6;
+/** Same, when the snapshot carries a fade and the `f` pair is appended. */
+constexpr uint8_t kCompactFadeFieldArgs = 8;
+
+/**
+ * Change notifications published on the `evt:room:{id}` pub/sub channel by whoever
+ * rewrites the matching key. The message is just the event name; devices re-read the
+ * key on receipt and keep a slow fallback poll for messages missed while unsubscribed.
+ */
+constexpr const char *kEventCfg = "cfg";            // room:{id}:cfg
+constexpr const char *kEventOverride = "override";  // room:{id}:override
+constexpr const char *kEventWarning = "warning";    // room:{id}:latest_warning
+constexpr const char *kEventWard = "ward";          // room:{id}:ward
+/** Longest event name above, used to size receive buffers. */
+constexpr size_t kEventNameCapacity = 16;
+
+/**
+ * Where a Desired command was published. Room commands travel on `cmd:room:{id}` and
+ * carry the room's own `ver`; ward broadcasts travel on `cmd:ward:{ward}`, reach every
+ * receiver whose `room:{id}:ward` names that ward, and are versioned per ward, so each
+ * scope is deduplicated against its own counter. Broadcasts are always written in the
+ * JSON wire format since a ward mixes receivers of every firmware vintage.
+ */
+enum class Scope : uint8_t { Room, Ward };
+
+/**
+ * Command priorities (JSON `prio`, omitted when normal). A new command from the scope
+ * that set what a receiver shows always replaces it; one from the other scope needs at
+ * least the same priority, and between equals the later stream entry wins (see
+ * `outranks()`). A ward broadcast above normal therefore holds its rooms until the ward
+ * broadcasts again, e.g. at normal priority to release them, or the room leaves the ward.
+ */
+constexpr uint8_t kPriorityNormal = 0;
+constexpr uint8_t kPriorityMax = 9;
+
+/**
+ * Lua script shared by every writer of a snapshot key + stream pair
+ * (`room:{id}:desired` + `cmd:room:{id}`, `ward:{ward}:desired` + `cmd:ward:{ward}`,
+ * `room:{id}:reported` + `state:room:{id}`).
+ * KEYS[1] = snapshot key, KEYS[2] = stream; ARGV[1] = JSON payload, ARGV[2] = ver,
+ * ARGV[3] = approximate stream MAXLEN, ARGV[4] = `1` to accept a `ver` equal to the
+ * stored one (`0` otherwise), ARGV[5..] = optional stream field/value pairs used instead
+ * of `p <json>` (the compact wire format). The overwrite and the trimmed append only
+ * happen when `ver` is newer than the stored snapshot, so two writers that picked the
+ * same version cannot both land; only the receiver's `reported` write, which repeats the
+ * room's `ver` while it shows a ward broadcast, accepts an equal one. The script returns
+ * `ver` when it wrote, otherwise the stored version + 1 (always greater than `ver`): the
+ * lowest version the caller can retry with.
+ */
+const char kPublishScript[] PROGMEM = R"lua(
+local ver = tonumber(ARGV[2]) or 0
+local cur = redis.call('GET', KEYS[1])
+if cur then
+  local ok, doc = pcall(cjson.decode, cur)
+  if ok and type(doc) == 'table' then
+    local stored = tonumber(doc['ver'])
+    if stored and (stored > ver or (stored == ver and ARGV[4] ~= '1')) then
+      return stored + 1
+    end
+  end
+end
+redis.call('SET', KEYS[1], ARGV[1])
+if #ARGV > 4 then
+  redis.call('XADD', KEYS[2], 'MAXLEN', '~', ARGV[3], '*', unpack(ARGV, 5))
+else
+  redis.call('XADD', KEYS[2], 'MAXLEN', '~', ARGV[3], '*', 'p', ARGV[1])
+end
+return ver
+)lua";
+
 /**
  * Canonical Desired state snapshot that both firmware targets and the website understand.
+ * `fadeMs` (JSON `fade_ms`, omitted when 0) asks the receiver to ramp from whatever it
+ * shows now to `brightness` over that many milliseconds; 0 is an immediate step.
+ * `scope` (JSON `scope`, omitted for rooms) and `priority` decide precedence between
+ * room commands and ward broadcasts.
  */
 struct Desired {
   char mode[4] = "off";
   uint8_t brightness = 0;
   uint32_t ver = 0;
+  uint32_t fadeMs = 0;
+  Scope scope = Scope::Room;
+  uint8_t priority = kPriorityNormal;
 };
 
 /**
- * Utility to build a namespaced room key that ends with the provided suffix.
+ * Name pieces shared by the `String` helpers below and the prebuilt `RoomKeys`, so both
+ * always spell a key the same way. Sizes include the terminating NUL.
  */
-inline String makeRoomKey(const String &roomId, const char *suffix) {
-  String key("room:");
-  key.reserve(roomId.length() + strlen(suffix) + 6);
-  key += roomId;
+namespace keys {
+constexpr char kRoom[] = "room:";
+constexpr char kCfg[] = ":cfg";
+constexpr char kDesired[] = ":desired";
+constexpr char kReported[] = ":reported";
+constexpr char kOnline[] = ":online";
+constexpr char kOverride[] = ":override";
+constexpr char kLatestWarning[] = ":latest_warning";
+constexpr char kWire[] = ":wire";
+constexpr char kMetrics[] = ":metrics";
+constexpr char kWard[] = ":ward";
+constexpr char kCmdRoom[] = "cmd:room:";
+constexpr char kStateRoom[] = "state:room:";
+constexpr char kTelemetryRoom[] = "telemetry:room:";
+constexpr char kEventsRoom[] = "evt:room:";
+constexpr char kNone[] = "";
+}  // namespace keys
+
+/** Builds `{prefix}{id}{suffix}` as a `String`. */
+inline String makeKey(const char *prefix, const String &id, const char *suffix) {
+  String key(prefix);
+  key.reserve(strlen(prefix) + id.length() + strlen(suffix));
+  key += id;
   key += suffix;
   return key;
 }
 
+/**
+ * Utility to build a namespaced room key that ends with the provided suffix.
+ */
+inline String makeRoomKey(const String &roomId, const char *suffix) {
+  return makeKey(keys::kRoom, roomId, suffix);
+}
+
 /** Returns `room:{id}:cfg`. */
-inline String key_cfg(const String &roomId) { return makeRoomKey(roomId, ":cfg"); }
+inline String key_cfg(const String &roomId) { return makeRoomKey(roomId, keys::kCfg); }
 /** Returns `room:{id}:desired`. */
-inline String key_desired(const String &roomId) { return makeRoomKey(roomId, ":desired"); }
+inline String key_desired(const String &roomId) { return makeRoomKey(roomId, keys::kDesired); }
 /** Returns `room:{id}:reported`. */
-inline String key_reported(const String &roomId) { return makeRoomKey(roomId, ":reported"); }
+inline String key_reported(const String &roomId) { return makeRoomKey(roomId, keys::kReported); }
 /** Returns `room:{id}:online`. */
-inline String key_online(const String &roomId) { return makeRoomKey(roomId, ":online"); }
+inline String key_online(const String &roomId) { return makeRoomKey(roomId, keys::kOnline); }
 /** Returns `room:{id}:override`. */
-inline String key_override(const String &roomId) { return makeRoomKey(roomId, ":override"); }
+inline String key_override(const String &roomId) { return makeRoomKey(roomId, keys::kOverride); }
 /** Returns `room:{id}:latest_warning`. */
 inline String key_latest_warning(const String &roomId) {
-  return makeRoomKey(roomId, ":latest_warning");
+  return makeRoomKey(roomId, keys::kLatestWarning);
 }
 
+/** Returns `room:{id}:wire` (newest stream wire format the receiver decodes). */
+inline String key_wire(const String &roomId) { return makeRoomKey(roomId, keys::kWire); }
+/** Returns `room:{id}:metrics` (hash of per-device timing snapshots, see metrics.hpp). */
+inline String key_metrics(const String &roomId) { return makeRoomKey(roomId, keys::kMetrics); }
+
+/** Returns `room:{id}:ward` (the ward whose broadcasts this room follows; optional). */
+inline String key_ward(const String &roomId) { return makeRoomKey(roomId, keys::kWard); }
+
 /** Returns `cmd:room:{id}`. */
 inline String stream_cmd(const String &roomId) {
-  String key("cmd:room:");
-  key.reserve(roomId.length() + 9);
-  key += roomId;
-  return key;
+  return makeKey(keys::kCmdRoom, roomId, keys::kNone);
+}
+
+/** Returns `cmd:ward:{ward}` (broadcast commands for every room in the ward). */
+inline String stream_ward_cmd(const String &wardId) {
+  return makeKey("cmd:ward:", wardId, keys::kNone);
+}
+
+/** Returns `ward:{ward}:desired` (snapshot of the last broadcast, for writers). */
+inline String key_ward_desired(const String &wardId) {
+  return makeKey("ward:", wardId, keys::kDesired);
 }
 
 /** Returns `state:room:{id}`. */
 inline String stream_state(const String &roomId) {
-  String key("state:room:");
-  key.reserve(roomId.length() + 11);
-  key += roomId;
-  return key;
+  return makeKey(keys::kStateRoom, roomId, keys::kNone);
+}
+
+/** Returns `telemetry:room:{id}` (per-minute sound level summaries from the receiver). */
+inline String stream_telemetry(const String &roomId) {
+  return makeKey(keys::kTelemetryRoom, roomId, keys::kNone);
 }
 
+/** Returns `evt:room:{id}` (pub/sub channel for the events above). */
+inline String channel_events(const String &roomId) {
+  return makeKey(keys::kEventsRoom, roomId, keys::kNone);
+}
+
+/** Longest room id a `RoomKeys` set holds (provisioned ids are short decimal numbers). */
+constexpr size_t kRoomIdMaxLen = 15;
+
+/**
+ * One prebuilt `{prefix}{id}{suffix}` name. The buffer is sized at compile time from the
+ * two literals and `kRoomIdMaxLen`, so building and reading it never touches the heap.
+ * `c_str()`/`length()` let it go straight to `RedisLink` as a key view.
+ */
+template <size_t PrefixSize, size_t SuffixSize>
+class RoomKey {
+ public:
+  static constexpr size_t kCapacity = (PrefixSize - 1) + kRoomIdMaxLen + SuffixSize;
+
+  const char *c_str() const { return text_; }
+  size_t length() const { return len_; }
+
+  /** `id` must hold at most `kRoomIdMaxLen` characters (checked by `RoomKeys::assign`). */
+  void build(const char (&prefix)[PrefixSize], const char *id, size_t idLen,
+             const char (&suffix)[SuffixSize]) {
+    memcpy(text_, prefix, PrefixSize - 1);
+    memcpy(text_ + PrefixSize - 1, id, idLen);
+    memcpy(text_ + PrefixSize - 1 + idLen, suffix, SuffixSize);
+    len_ = static_cast<uint8_t>(PrefixSize - 1 + idLen + SuffixSize - 1);
+  }
+
+  void clear() {
+    text_[0] = '\0';
+    len_ = 0;
+  }
+
+ private:
+  char text_[kCapacity] = "";
+  uint8_t len_ = 0;
+};
+
+/** `RoomKey` type for `{prefix}{id}{suffix}` spelled with the `keys::` pieces. */
+#define CONTRACTS_ROOM_KEY(prefix, suffix) RoomKey<sizeof(keys::prefix), sizeof(keys::suffix)>
+
+/**
+ * Every per-room key and stream name, built once when the room id is assigned so the
+ * hot paths (`XREAD`, state publishes, heartbeats) pass fixed buffers instead of
+ * rebuilding `String`s on each call. Empty until `assign` succeeds.
+ */
+struct RoomKeys {
+  CONTRACTS_ROOM_KEY(kRoom, kCfg) cfg;
+  CONTRACTS_ROOM_KEY(kRoom, kDesired) desired;
+  CONTRACTS_ROOM_KEY(kRoom, kReported) reported;
+  CONTRACTS_ROOM_KEY(kRoom, kOnline) online;
+  CONTRACTS_ROOM_KEY(kRoom, kOverride) override_;
+  CONTRACTS_ROOM_KEY(kRoom, kLatestWarning) latestWarning;
+  CONTRACTS_ROOM_KEY(kRoom, kWire) wire;
+  CONTRACTS_ROOM_KEY(kRoom, kMetrics) metrics;
+  CONTRACTS_ROOM_KEY(kRoom, kWard) ward;
+  CONTRACTS_ROOM_KEY(kCmdRoom, kNone) cmd;
+  CONTRACTS_ROOM_KEY(kStateRoom, kNone) state;
+  CONTRACTS_ROOM_KEY(kTelemetryRoom, kNone) telemetry;
+  CONTRACTS_ROOM_KEY(kEventsRoom, kNone) events;
+
+  /** Builds every name for `roomId`; false (and everything cleared) when it is empty or too long. */
+  bool assign(const char *roomId) {
+    size_t len = strlen(roomId);
+    if (!len || len > kRoomIdMaxLen) {
+      clear();
+      return false;
+    }
+    cfg.build(keys::kRoom, roomId, len, keys::kCfg);
+    desired.build(keys::kRoom, roomId, len, keys::kDesired);
+    reported.build(keys::kRoom, roomId, len, keys::kReported);
+    online.build(keys::kRoom, roomId, len, keys::kOnline);
+    override_.build(keys::kRoom, roomId, len, keys::kOverride);
+    latestWarning.build(keys::kRoom, roomId, len, keys::kLatestWarning);
+    wire.build(keys::kRoom, roomId, len, keys::kWire);
+    metrics.build(keys::kRoom, roomId, len, keys::kMetrics);
+    ward.build(keys::kRoom, roomId, len, keys::kWard);
+    cmd.build(keys::kCmdRoom, roomId, len, keys::kNone);
+    state.build(keys::kStateRoom, roomId, len, keys::kNone);
+    telemetry.build(keys::kTelemetryRoom, roomId, len, keys::kNone);
+    events.build(keys::kEventsRoom, roomId, len, keys::kNone);
+    return true;
+  }
+  bool assign(const String &roomId) { return assign(roomId.c_str()); }
+
+  void clear() {
+    cfg.clear();
+    desired.clear();
+    reported.clear();
+    online.clear();
+    override_.clear();
+    latestWarning.clear();
+    wire.clear();
+    metrics.clear();
+    ward.clear();
+    cmd.clear();
+    state.clear();
+    telemetry.clear();
+    events.clear();
+  }
+};
+
+#undef CONTRACTS_ROOM_KEY
+
 /**
  * Copies a textual `mode` (`on` or `off`) into a Desired struct.
  */
@@ -75,8 +315,7 @@ inline bool copyMode(const char *src, Desired &dst) {
   if (strcmp(src, "on") != 0 && strcmp(src, "off") != 0) {
     return false;
   }
-  strncpy(dst.mode, src, sizeof(dst.mode) - 1);
-  dst.mode[sizeof(dst.mode) - 1] = '\0';
+  memcpy(dst.mode, src, strlen(src) + 1);  // "on"/"off" always fit
   return true;
 }
 
@@ -89,10 +328,202 @@ inline void clampBrightness(Desired &desired) {
   }
 }
 
+/** Parses a textual `scope` (`room` or `ward`). */
+inline bool parseScope(const char *src, size_t len, Scope &out) {
+  if (len == 4 && strncmp(src, "room", 4) == 0) {
+    out = Scope::Room;
+  } else if (len == 4 && strncmp(src, "ward", 4) == 0) {
+    out = Scope::Ward;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/** Stores a priority, saturating at `kPriorityMax`. */
+inline void setPriority(uint32_t value, Desired &desired) {
+  desired.priority = static_cast<uint8_t>(value > kPriorityMax ? kPriorityMax : value);
+}
+
+namespace detail {
+
+/** Skips JSON insignificant whitespace. */
+inline const char *skipJsonSpace(const char *p) {
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+    ++p;
+  }
+  return p;
+}
+
 /**
- * Populates a Desired struct by parsing serialized JSON.
+ * Scans a JSON string that contains no escapes, returning the character after the closing
+ * quote (or nullptr when the string needs the full parser).
  */
-inline bool decodeDesired(const String &json, Desired &out) {
+inline const char *scanPlainJsonString(const char *p, const char *&begin, size_t &len) {
+  if (*p != '"') {
+    return nullptr;
+  }
+  begin = ++p;
+  while (*p != '"') {
+    if (!*p || *p == '\\' || static_cast<unsigned char>(*p) < 0x20) {
+      return nullptr;
+    }
+    ++p;
+  }
+  len = static_cast<size_t>(p - begin);
+  return p + 1;
+}
+
+/**
+ * Scans a non-negative JSON integer. `fits` is cleared when it exceeds 32 bits; fractions,
+ * exponents and leading zeros return nullptr so the full parser decides.
+ */
+inline const char *scanJsonUint32(const char *p, uint32_t &value, bool &fits) {
+  if (*p < '0' || *p > '9' || (*p == '0' && p[1] >= '0' && p[1] <= '9')) {
+    return nullptr;
+  }
+  uint64_t acc = 0;
+  fits = true;
+  while (*p >= '0' && *p <= '9') {
+    if (fits) {
+      acc = acc * 10 + static_cast<uint8_t>(*p - '0');
+      fits = acc <= 0xFFFFFFFFULL;
+    }
+    ++p;
+  }
+  if (*p == '.' || *p == 'e' || *p == 'E') {
+    return nullptr;
+  }
+  value = static_cast<uint32_t>(acc);
+  return p;
+}
+
+/** True when the `len` bytes at `key` spell the NUL-terminated `name`. */
+inline bool jsonKeyIs(const char *key, size_t len, const char *name) {
+  return strncmp(key, name, len) == 0 && name[len] == '\0';
+}
+
+}  // namespace detail
+
+/**
+ * Single-pass decoder for the flat Desired schema (`mode`, `brightness`, `ver`, `fade_ms`,
+ * `scope`, `prio`, plus
+ * string/integer/literal extras such as `room` and `source`) that skips the ArduinoJson
+ * DOM. It gives the same result as `decodeDesired()` for every payload it accepts and
+ * returns false, leaving `out` untouched, for anything else (escapes, floats, negatives,
+ * nesting, invalid modes) so the caller can fall back to the full parser.
+ */
+inline bool decodeDesiredFast(const char *json, Desired &out) {
+  if (!json) {
+    return false;
+  }
+  Desired next = out;
+  next.fadeMs = 0;
+  next.scope = Scope::Room;
+  next.priority = kPriorityNormal;
+  bool sawMode = false;
+  const char *p = detail::skipJsonSpace(json);
+  if (*p++ != '{') {
+    return false;
+  }
+  p = detail::skipJsonSpace(p);
+  if (*p == '}') {
+    return false;
+  }
+  while (true) {
+    const char *key = nullptr;
+    size_t keyLen = 0;
+    p = detail::scanPlainJsonString(p, key, keyLen);
+    if (!p) {
+      return false;
+    }
+    p = detail::skipJsonSpace(p);
+    if (*p++ != ':') {
+      return false;
+    }
+    p = detail::skipJsonSpace(p);
+    if (*p == '"') {
+      const char *value = nullptr;
+      size_t valueLen = 0;
+      p = detail::scanPlainJsonString(p, value, valueLen);
+      if (!p) {
+        return false;
+      }
+      if (detail::jsonKeyIs(key, keyLen, "mode")) {
+        if (detail::jsonKeyIs(value, valueLen, "on")) {
+          copyMode("on", next);
+        } else if (detail::jsonKeyIs(value, valueLen, "off")) {
+          copyMode("off", next);
+        } else {
+          return false;
+        }
+        sawMode = true;
+      } else if (detail::jsonKeyIs(key, keyLen, "scope")) {
+        if (!parseScope(value, valueLen, next.scope)) {
+          return false;
+        }
+      } else if (detail::jsonKeyIs(key, keyLen, "brightness") || detail::jsonKeyIs(key, keyLen, "ver") ||
+                 detail::jsonKeyIs(key, keyLen, "fade_ms") || detail::jsonKeyIs(key, keyLen, "prio")) {
+        return false;
+      }
+    } else if (*p >= '0' && *p <= '9') {
+      uint32_t value = 0;
+      bool fits = false;
+      p = detail::scanJsonUint32(p, value, fits);
+      if (!p) {
+        return false;
+      }
+      if (detail::jsonKeyIs(key, keyLen, "brightness")) {
+        // Mirrors `doc["brightness"] | fallback`: values that do not fit uint8_t are ignored.
+        if (fits && value <= 0xFF) {
+          next.brightness = static_cast<uint8_t>(value);
+        }
+      } else if (detail::jsonKeyIs(key, keyLen, "ver")) {
+        if (fits) {
+          next.ver = value;
+        }
+      } else if (detail::jsonKeyIs(key, keyLen, "fade_ms")) {
+        if (fits) {
+          next.fadeMs = value;
+        }
+      } else if (detail::jsonKeyIs(key, keyLen, "prio")) {
+        setPriority(fits ? value : kPriorityNormal, next);
+      } else if (detail::jsonKeyIs(key, keyLen, "mode") || detail::jsonKeyIs(key, keyLen, "scope")) {
+        return false;
+      }
+    } else if (strncmp(p, "true", 4) == 0 || strncmp(p, "null", 4) == 0 || strncmp(p, "false", 5) == 0) {
+      if (detail::jsonKeyIs(key, keyLen, "mode") || detail::jsonKeyIs(key, keyLen, "brightness") ||
+          detail::jsonKeyIs(key, keyLen, "ver") || detail::jsonKeyIs(key, keyLen, "fade_ms") ||
+          detail::jsonKeyIs(key, keyLen, "scope") || detail::jsonKeyIs(key, keyLen, "prio")) {
+        return false;
+      }
+      p += (*p == 'f') ? 5 : 4;
+    } else {
+      return false;
+    }
+    p = detail::skipJsonSpace(p);
+    if (*p == ',') {
+      p = detail::skipJsonSpace(p + 1);
+      continue;
+    }
+    if (*p != '}') {
+      return false;
+    }
+    break;
+  }
+  if (*detail::skipJsonSpace(p + 1) != '\0' || !sawMode) {
+    return false;
+  }
+  clampBrightness(next);
+  out = next;
+  return true;
+}
+
+/**
+ * Populates a Desired struct by parsing serialized JSON with the ArduinoJson DOM. This is
+ * the reference path `decodeDesired()` falls back to for payloads of unexpected shape.
+ */
+inline bool decodeDesiredDom(const char *json, Desired &out) {
   StaticJsonDocument<kDesiredJsonCapacity> doc;
   DeserializationError err = deserializeJson(doc, json);
   if (err) {
@@ -105,9 +536,26 @@ inline bool decodeDesired(const String &json, Desired &out) {
   out.brightness = doc["brightness"] | out.brightness;
   clampBrightness(out);
   out.ver = doc["ver"] | out.ver;
+  out.fadeMs = doc["fade_ms"] | static_cast<uint32_t>(0);
+  const char *scope = doc["scope"] | "room";
+  if (!parseScope(scope, strlen(scope), out.scope)) {
+    out.scope = Scope::Room;
+  }
+  setPriority(doc["prio"] | static_cast<uint32_t>(kPriorityNormal), out);
   return true;
 }
 
+/**
+ * Populates a Desired struct by parsing serialized JSON, taking the single-pass fast path
+ * when the payload has the expected flat shape.
+ */
+inline bool decodeDesired(const char *json, Desired &out) {
+  return decodeDesiredFast(json, out) || decodeDesiredDom(json, out);
+}
+
+/** `String` convenience overload of `decodeDesired()`. */
+inline bool decodeDesired(const String &json, Desired &out) { return decodeDesired(json.c_str(), out); }
+
 /**
  * Serializes a Desired snapshot to JSON, optionally annotating the `room` field.
  */
@@ -116,6 +564,15 @@ inline bool encodeDesired(const Desired &desired, const String *roomId, String &
   doc["mode"] = desired.mode;
   doc["brightness"] = desired.brightness;
   doc["ver"] = desired.ver;
+  if (desired.fadeMs > 0) {
+    doc["fade_ms"] = desired.fadeMs;
+  }
+  if (desired.scope == Scope::Ward) {
+    doc["scope"] = "ward";
+  }
+  if (desired.priority != kPriorityNormal) {
+    doc["prio"] = desired.priority;
+  }
   if (roomId && roomId->length() > 0) {
     doc["room"] = *roomId;
   }
@@ -125,11 +582,110 @@ inline bool encodeDesired(const Desired &desired, const String *roomId, String &
   return serializeJson(doc, out) > 0;
 }
 
+/**
+ * Text form of the compact stream fields; the first `count` entries of `args` are the
+ * name/value pairs in the order `XADD` expects (`m`, `b`, `v`, then `f` for a fade),
+ * ready to pass to the publish script.
+ */
+struct CompactDesired {
+  char mode[2] = "0";
+  char brightness[4] = "0";
+  char ver[11] = "0";
+  char fade[11] = "0";
+  const char *args[kCompactFadeFieldArgs] = {"m", mode, "b", brightness, "v", ver, "f", fade};
+  uint8_t count = kCompactFieldArgs;
+
+  CompactDesired() = default;
+  CompactDesired(const CompactDesired &) = delete;
+  CompactDesired &operator=(const CompactDesired &) = delete;
+};
+
+/**
+ * Fills the compact stream fields for a Desired snapshot.
+ */
+inline void encodeDesiredCompact(const Desired &desired, CompactDesired &out) {
+  out.mode[0] = strcmp(desired.mode, "on") == 0 ? '1' : '0';
+  out.mode[1] = '\0';
+  snprintf(out.brightness, sizeof(out.brightness), "%u", static_cast<unsigned>(desired.brightness));
+  snprintf(out.ver, sizeof(out.ver), "%lu", static_cast<unsigned long>(desired.ver));
+  snprintf(out.fade, sizeof(out.fade), "%lu", static_cast<unsigned long>(desired.fadeMs));
+  out.count = desired.fadeMs > 0 ? kCompactFadeFieldArgs : kCompactFieldArgs;
+}
+
+/**
+ * Parses the compact `m`/`b`/`v`/`f` stream fields into a Desired struct. The first three
+ * must be present and numeric; a missing `f` means no fade. Compact entries are only
+ * used for room commands, so they always decode as room scope at normal priority. `out`
+ * is left untouched on failure.
+ */
+inline bool decodeDesiredCompact(const char *mode, const char *brightness, const char *ver, const char *fade,
+                                 Desired &out) {
+  if (!mode || !brightness || !ver || (strcmp(mode, "0") != 0 && strcmp(mode, "1") != 0)) {
+    return false;
+  }
+  char *end = nullptr;
+  unsigned long b = strtoul(brightness, &end, 10);
+  if (end == brightness || *end) {
+    return false;
+  }
+  unsigned long v = strtoul(ver, &end, 10);
+  if (end == ver || *end) {
+    return false;
+  }
+  unsigned long f = 0;
+  if (fade) {
+    f = strtoul(fade, &end, 10);
+    if (end == fade || *end) {
+      return false;
+    }
+  }
+  copyMode(mode[0] == '1' ? "on" : "off", out);
+  out.brightness = b > 100 ? 100 : static_cast<uint8_t>(b);
+  out.ver = static_cast<uint32_t>(v);
+  out.fadeMs = static_cast<uint32_t>(f);
+  out.scope = Scope::Room;
+  out.priority = kPriorityNormal;
+  return true;
+}
+
 /**
  * Compares Desired payloads for equality so we can skip redundant publishes.
  */
 inline bool sameDesired(const Desired &lhs, const Desired &rhs) {
-  return lhs.brightness == rhs.brightness && lhs.ver == rhs.ver && strcmp(lhs.mode, rhs.mode) == 0;
+  return lhs.brightness == rhs.brightness && lhs.ver == rhs.ver && lhs.fadeMs == rhs.fadeMs &&
+         lhs.scope == rhs.scope && lhs.priority == rhs.priority && strcmp(lhs.mode, rhs.mode) == 0;
+}
+
+/** Orders stream entry ids (`<ms>-<seq>`) numerically; an empty id sorts first. */
+inline int compareStreamIds(const char *lhs, const char *rhs) {
+  char *end = nullptr;
+  uint64_t lhsMs = strtoull(lhs, &end, 10);
+  uint64_t lhsSeq = *end == '-' ? strtoull(end + 1, nullptr, 10) : 0;
+  uint64_t rhsMs = strtoull(rhs, &end, 10);
+  uint64_t rhsSeq = *end == '-' ? strtoull(end + 1, nullptr, 10) : 0;
+  if (lhsMs != rhsMs) {
+    return lhsMs < rhsMs ? -1 : 1;
+  }
+  return lhsSeq == rhsSeq ? 0 : (lhsSeq < rhsSeq ? -1 : 1);
+}
+
+/**
+ * True when a new (not yet seen) command from stream entry `entryId` may replace what a
+ * receiver shows, which came from `shownScope` at `shownPriority` via `shownId`. The
+ * scope that set it may always replace it, so each scope can lower or release its own
+ * hold; across scopes a higher priority wins, a lower one never does, and between equals
+ * the later entry does. Entry ids carry the server's clock, so they also order a room's
+ * commands against its ward's.
+ */
+inline bool outranks(const Desired &next, const char *entryId, Scope shownScope, uint8_t shownPriority,
+                     const char *shownId) {
+  if (next.scope == shownScope) {
+    return true;
+  }
+  if (next.priority != shownPriority) {
+    return next.priority > shownPriority;
+  }
+  return compareStreamIds(entryId, shownId) > 0;
 }
 
 }  // namespace contracts
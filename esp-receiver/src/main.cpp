@@ -1,11 +1,18 @@
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
 #include <ArduinoJson.h>
+#include <EEPROM.h>
+#include <Ticker.h>
+#include <sys/time.h>
 #include <time.h>
 
 #include "config.h"
 #include "contracts.hpp"
+#include "log.hpp"
+#include "metrics.hpp"
 #include "redis_link.hpp"
+#include "scheduler.hpp"
+#include "spsc_ring.hpp"
 
 #ifndef PWMRANGE
 #define PWMRANGE 1023
@@ -14,8 +21,13 @@
 namespace {
 
 constexpr uint16_t kStreamTrimLen = 200;
+/** XREAD BLOCK window at the normal pace; `xreadBlockMs()` scales it with `cadence`. */
 constexpr uint32_t kXreadBlockMs = 1000;
+/** Non-blocking follow-up reads allowed per loop while a backlog fills whole batches. */
+constexpr uint8_t kXreadDrainRounds = 4;
 constexpr uint16_t kRedisTimeoutMs = 1500;
+/** Largest streamed command payload; encoded Desired JSON is well under this. */
+constexpr size_t kStreamPayloadCapacity = 192;
 
 #ifndef RECEIVER_LED_PIN
 #define RECEIVER_LED_PIN D4
@@ -48,17 +60,61 @@ constexpr uint16_t kRedisTimeoutMs = 1500;
 #define RECEIVER_STATUS_LED_ACTIVE_LOW 1
 #endif
 
+#ifndef RECEIVER_WIRE_FORMAT
+#define RECEIVER_WIRE_FORMAT 3
+#endif
+static_assert(RECEIVER_WIRE_FORMAT >= 1 && RECEIVER_WIRE_FORMAT <= 3,
+              "RECEIVER_WIRE_FORMAT must be 1 (JSON), 2 (compact) or 3 (compact + fades)");
+#ifndef RECEIVER_XREAD_COUNT
+#define RECEIVER_XREAD_COUNT 16
+#endif
+static_assert(RECEIVER_XREAD_COUNT >= 1 && RECEIVER_XREAD_COUNT <= 255, "RECEIVER_XREAD_COUNT must be 1-255");
+
+#ifndef RECEIVER_SESSION_RESUME
+#define RECEIVER_SESSION_RESUME 1
+#endif
+#ifndef RECEIVER_FAST_BOOT
+#define RECEIVER_FAST_BOOT 1
+#endif
+// Light sleep is not offered: it halts the PWM timer and the sound sampling ticker.
+#ifndef RECEIVER_MODEM_SLEEP
+#define RECEIVER_MODEM_SLEEP 0
+#endif
+#ifndef RECEIVER_FAST_BOOT_STATIC_IP
+#define RECEIVER_FAST_BOOT_STATIC_IP 0
+#endif
+#ifndef RECEIVER_FAST_CONNECT_TIMEOUT_MS
+#define RECEIVER_FAST_CONNECT_TIMEOUT_MS 4000
+#endif
+#ifndef RECEIVER_BOOT_SAVE_DELAY_MS
+#define RECEIVER_BOOT_SAVE_DELAY_MS 60000
+#endif
+
+#ifndef RECEIVER_FADE_TICK_MS
+#define RECEIVER_FADE_TICK_MS 10
+#endif
+static_assert(RECEIVER_FADE_TICK_MS >= 1 && RECEIVER_FADE_TICK_MS <= 100, "RECEIVER_FADE_TICK_MS must be 1-100");
+
 #ifndef RECEIVER_CFG_REFRESH_MS
 #define RECEIVER_CFG_REFRESH_MS 60000
 #endif
+#ifndef REDIS_EVENTS_ENABLED
+#define REDIS_EVENTS_ENABLED 1
+#endif
+#ifndef REDIS_EVENTS_FALLBACK_MS
+#define REDIS_EVENTS_FALLBACK_MS 300000
+#endif
+#ifndef REDIS_EVENTS_PING_MS
+#define REDIS_EVENTS_PING_MS 30000
+#endif
 #ifndef RECEIVER_SOUND_SENSOR_PIN
 #define RECEIVER_SOUND_SENSOR_PIN -1
 #endif
 #ifndef RECEIVER_SOUND_SAMPLE_INTERVAL_MS
 #define RECEIVER_SOUND_SAMPLE_INTERVAL_MS 200
 #endif
-#ifndef RECEIVER_SOUND_AVERAGE_SAMPLES
-#define RECEIVER_SOUND_AVERAGE_SAMPLES 4
+#ifndef RECEIVER_SOUND_SAMPLE_PERIOD_MS
+#define RECEIVER_SOUND_SAMPLE_PERIOD_MS 5
 #endif
 #ifndef RECEIVER_SOUND_SENSOR_MIN_DB
 #define RECEIVER_SOUND_SENSOR_MIN_DB 30.0f
@@ -72,6 +128,15 @@ constexpr uint16_t kRedisTimeoutMs = 1500;
 #ifndef RECEIVER_SOUND_WARNING_COOLDOWN_MS
 #define RECEIVER_SOUND_WARNING_COOLDOWN_MS 60000
 #endif
+#ifndef RECEIVER_TELEMETRY_ENABLED
+#define RECEIVER_TELEMETRY_ENABLED 1
+#endif
+#ifndef RECEIVER_TELEMETRY_BATCH
+#define RECEIVER_TELEMETRY_BATCH 5
+#endif
+#ifndef RECEIVER_TELEMETRY_MAXLEN
+#define RECEIVER_TELEMETRY_MAXLEN 1440
+#endif
 #ifndef RECEIVER_LED_HAS_RGB
 #if (RECEIVER_LED_RED_PIN >= 0) || (RECEIVER_LED_GREEN_PIN >= 0) || (RECEIVER_LED_BLUE_PIN >= 0)
 #define RECEIVER_LED_HAS_RGB 1
@@ -99,34 +164,67 @@ constexpr uint16_t percentToDuty(uint8_t percent) {
   return static_cast<uint16_t>((static_cast<uint32_t>(percent) * PWMRANGE) / 100);
 }
 
+/** Brightness steps covered by the per-channel duty tables (0-100 percent). */
+constexpr uint8_t kBrightnessSteps = 101;
+
+/**
+ * Perceptual correction: treats `percent` as CIE 1976 lightness L* and returns the linear
+ * duty in the PWM range, so equal brightness steps look equal instead of bunching up at
+ * the dim end. Below L* = 8 the curve is linear (Y = L* / 903.3), above it cubic.
+ */
+constexpr uint16_t perceivedDuty(uint8_t percent) {
+  return percent <= 8
+             ? static_cast<uint16_t>((static_cast<uint32_t>(percent) * PWMRANGE * 10 + 4516) / 9033)
+             : static_cast<uint16_t>((static_cast<uint64_t>(percent + 16) * (percent + 16) * (percent + 16) *
+                                          PWMRANGE +
+                                      116ULL * 116 * 116 / 2) /
+                                     (116ULL * 116 * 116));
+}
+
+/** analogWrite() values for every brightness percent, with the mix and polarity folded in. */
+struct DutyTable {
+  uint16_t duty[kBrightnessSteps];
+};
+
+constexpr DutyTable makeDutyTable(uint16_t maxDuty, bool activeLow) {
+  DutyTable table{};
+  for (uint8_t percent = 0; percent < kBrightnessSteps; ++percent) {
+    uint16_t duty = static_cast<uint16_t>(
+        (static_cast<uint32_t>(maxDuty) * perceivedDuty(percent) + PWMRANGE / 2) / PWMRANGE);
+    table.duty[percent] = activeLow ? static_cast<uint16_t>(PWMRANGE - duty) : duty;
+  }
+  return table;
+}
+
 struct LedChannel {
   uint8_t pin;
-  uint16_t maxDuty;
+  DutyTable table;
 };
 
 #if RECEIVER_LED_HAS_RGB
 constexpr LedChannel kLedChannels[] = {
 #if RECEIVER_LED_RED_PIN >= 0
     {static_cast<uint8_t>(RECEIVER_LED_RED_PIN),
-     percentToDuty(static_cast<uint8_t>(RECEIVER_LED_RED_PERCENT))},
+     makeDutyTable(percentToDuty(static_cast<uint8_t>(RECEIVER_LED_RED_PERCENT)), kLedActiveLow)},
 #endif
 #if RECEIVER_LED_GREEN_PIN >= 0
     {static_cast<uint8_t>(RECEIVER_LED_GREEN_PIN),
-     percentToDuty(static_cast<uint8_t>(RECEIVER_LED_GREEN_PERCENT))},
+     makeDutyTable(percentToDuty(static_cast<uint8_t>(RECEIVER_LED_GREEN_PERCENT)), kLedActiveLow)},
 #endif
 #if RECEIVER_LED_BLUE_PIN >= 0
     {static_cast<uint8_t>(RECEIVER_LED_BLUE_PIN),
-     percentToDuty(static_cast<uint8_t>(RECEIVER_LED_BLUE_PERCENT))},
+     makeDutyTable(percentToDuty(static_cast<uint8_t>(RECEIVER_LED_BLUE_PERCENT)), kLedActiveLow)},
 #endif
 };
 #else
 constexpr LedChannel kLedChannels[] = {
-    {static_cast<uint8_t>(RECEIVER_LED_PIN), percentToDuty(100)},
+    {static_cast<uint8_t>(RECEIVER_LED_PIN), makeDutyTable(percentToDuty(100), kLedActiveLow)},
 };
 #endif
 
 constexpr size_t kLedChannelCount = sizeof(kLedChannels) / sizeof(kLedChannels[0]);
 static_assert(kLedChannelCount > 0, "At least one LED channel must be configured");
+static_assert(perceivedDuty(0) == 0 && perceivedDuty(100) == PWMRANGE, "perceptual curve must span the PWM range");
 
 /**
  * Reports whether the status LED shares the same physical pin as a driver channel.
@@ -153,10 +251,15 @@ constexpr bool kStatusLedSharesDriver = kStatusLedEnabled && statusLedSharesDriv
 constexpr bool kStatusLedControllable = kStatusLedEnabled && !kStatusLedSharesDriver;
 constexpr unsigned long kStatusLedBlinkIntervalMs = 400;
 constexpr unsigned long kQuietConfigRefreshMs = RECEIVER_CFG_REFRESH_MS;
+constexpr bool kEventsEnabled = REDIS_EVENTS_ENABLED;
+constexpr unsigned long kEventFallbackRefreshMs = REDIS_EVENTS_FALLBACK_MS;
+constexpr unsigned long kEventPingIntervalMs = REDIS_EVENTS_PING_MS;
+constexpr uint8_t kEventsPerLoop = 4;
 constexpr bool kSoundSensorEnabled = (RECEIVER_SOUND_SENSOR_PIN >= 0);
 constexpr unsigned long kSoundSampleIntervalMs = RECEIVER_SOUND_SAMPLE_INTERVAL_MS;
-constexpr uint8_t kSoundSampleCount =
-    (RECEIVER_SOUND_AVERAGE_SAMPLES >= 1 ? RECEIVER_SOUND_AVERAGE_SAMPLES : 1);
+constexpr uint32_t kSoundSamplePeriodMs = RECEIVER_SOUND_SAMPLE_PERIOD_MS;
+/** Raw ADC readings buffered between analysis windows (~1.3 s at the default 200 Hz). */
+constexpr uint16_t kSoundRingCapacity = 256;
 constexpr uint16_t kMinutesPerDay = 24 * 60;
 constexpr time_t kMinValidEpoch = 1609459200;
 constexpr float kSoundMinDb = RECEIVER_SOUND_SENSOR_MIN_DB;
@@ -164,7 +267,41 @@ constexpr float kSoundMaxDb = RECEIVER_SOUND_SENSOR_MAX_DB;
 constexpr float kSoundThresholdDb = RECEIVER_SOUND_WARNING_THRESHOLD_DB;
 constexpr unsigned long kSoundWarningCooldownMs = RECEIVER_SOUND_WARNING_COOLDOWN_MS;
 constexpr float kSoundAdcMax = 1023.0f;
-static_assert(kSoundSampleCount >= 1, "RECEIVER_SOUND_AVERAGE_SAMPLES must be >= 1");
+/** One histogram bin per dB of the sensor range, for the per-minute p95. */
+constexpr uint16_t kSoundHistogramBins = static_cast<uint16_t>(kSoundMaxDb - kSoundMinDb) + 1;
+constexpr bool kTelemetryEnabled = RECEIVER_TELEMETRY_ENABLED;
+constexpr uint8_t kTelemetryBatch = RECEIVER_TELEMETRY_BATCH;
+constexpr uint16_t kTelemetryMaxLen = RECEIVER_TELEMETRY_MAXLEN;
+constexpr unsigned long kTelemetryMinuteMs = 60000;
+constexpr uint8_t kWireFormat = RECEIVER_WIRE_FORMAT;
+constexpr uint8_t kXreadCount = RECEIVER_XREAD_COUNT;
+constexpr uint32_t kFadeTickMs = RECEIVER_FADE_TICK_MS;
+constexpr bool kSessionResume = RECEIVER_SESSION_RESUME;
+/** Room and ward ids longer than this are not kept across resets (the ward is re-read). */
+constexpr size_t kResumeIdCapacity = 24;
+/** Layout tag of `ResumeRecord`; bump it whenever the struct changes. */
+constexpr uint32_t kResumeMagic = 0x52534d31;  // "RSM1"
+constexpr bool kFastBoot = RECEIVER_FAST_BOOT;
+constexpr bool kFastBootStaticIp = RECEIVER_FAST_BOOT_STATIC_IP;
+constexpr unsigned long kFastConnectTimeoutMs = RECEIVER_FAST_CONNECT_TIMEOUT_MS;
+constexpr unsigned long kBootSaveDelayMs = RECEIVER_BOOT_SAVE_DELAY_MS;
+/** Layout tag of `BootRecord`; bump it whenever the struct changes. */
+constexpr uint32_t kBootMagic = 0x42544631;  // "BTF1"
+
+/** Fade levels are perceived lightness in 1/256 percent, so slow ramps still move each tick. */
+constexpr uint16_t kFadeLevelScale = 256;
+constexpr bool kMetricsEnabled = METRICS_ENABLED;
+constexpr unsigned long kMetricsIntervalMs = METRICS_PUBLISH_INTERVAL_MS;
+/** The metrics hash survives two missed publishes, then expires with the devices. */
+constexpr uint16_t kMetricsTtlSec = 3 * (METRICS_PUBLISH_INTERVAL_MS / 1000);
+/** Fits the snapshot with every counter at its widest (~1040 bytes). */
+constexpr size_t kMetricsJsonCapacity = 1152;
+static_assert(METRICS_PUBLISH_INTERVAL_MS >= 1000 && METRICS_PUBLISH_INTERVAL_MS <= 1200000UL,
+              "METRICS_PUBLISH_INTERVAL_MS must be 1 s to 20 min");
+static_assert(RECEIVER_TELEMETRY_BATCH >= 1 && RECEIVER_TELEMETRY_BATCH <= RedisLink::kMaxPipelineDepth,
+              "RECEIVER_TELEMETRY_BATCH must fit one pipeline (1-8)");
+static_assert(RECEIVER_SOUND_SAMPLE_PERIOD_MS >= 1 && RECEIVER_SOUND_SAMPLE_PERIOD_MS <= RECEIVER_SOUND_SAMPLE_INTERVAL_MS,
+              "RECEIVER_SOUND_SAMPLE_PERIOD_MS must be 1 ms up to the analysis window");
 
 /**
  * Records retry scheduling information for Wi-Fi/Redis links.
@@ -172,9 +309,19 @@ static_assert(kSoundSampleCount >= 1, "RECEIVER_SOUND_AVERAGE_SAMPLES must be >=
 struct Backoff {
   unsigned long nextMs = 0;
   uint8_t slot = 0;
+  // Metrics window: successful connects, failed attempts/drops, and time spent between
+  // the first failure and the connect that ended it.
+  uint16_t connects = 0;
+  uint16_t failures = 0;
+  uint32_t downMs = 0;
+  unsigned long downSinceMs = 0;
   bool ready(unsigned long now) const { return now >= nextMs; }
   void schedule(unsigned long now) {
     static const uint16_t kSteps[] = {250, 500, 1000, 2000};
+    if (!slot) {
+      downSinceMs = now;
+    }
+    ++failures;
     uint8_t idx = slot < 3 ? slot : 3;
     nextMs = now + kSteps[idx] + random(0, 200);
     if (slot < 3) {
@@ -185,6 +332,19 @@ struct Backoff {
     nextMs = 0;
     slot = 0;
   }
+  /** Records a successful connect, closing the outage that preceded it. */
+  void connected(unsigned long now) {
+    if (slot) {
+      downMs += now - downSinceMs;
+    }
+    ++connects;
+    reset();
+  }
+  void clearStats() {
+    connects = 0;
+    failures = 0;
+    downMs = 0;
+  }
 };
 
 WiFiClient redisClient;
@@ -193,14 +353,233 @@ RedisLink redis(redisClient);
 Backoff wifiBackoff;
 Backoff redisBackoff;
 
+// Reader connection dedicated to the blocking `cmd:room:{id}` XREAD; `redis` above only
+// carries writes and short reads, so neither side ever waits for the other.
+WiFiClient streamClient;
+RedisLink streamLink(streamClient);
+Backoff streamBackoff;
+
+// Third connection parked in SUBSCRIBE on `evt:room:{id}` for cfg change events.
+WiFiClient eventClient;
+RedisLink events(eventClient);
+Backoff eventBackoff;
+bool eventsSubscribed = false;
+String eventsRoomId;
+
+/**
+ * One metrics window, written to `room:{id}:metrics` field `receiver` and reset every
+ * `METRICS_PUBLISH_INTERVAL_MS`. Command latencies are measured from the stream entry
+ * id (the server's clock at XADD) to this device's SNTP clock, so they include any
+ * clock offset between the two.
+ */
+struct ReceiverMetrics {
+  metrics::LinkMetrics links;
+  metrics::Histogram loopUs;
+  metrics::Histogram applyMs;
+  metrics::Histogram reportedMs;
+  metrics::LoopTimer loopTimer;
+  uint32_t minFreeHeap = UINT32_MAX;
+  uint16_t wifiConnects = 0;
+  uint32_t wifiBlockedMs = 0;
+  unsigned long windowStartMs = 0;
+};
+ReceiverMetrics receiverMetrics;
+char metricsScratch[kMetricsJsonCapacity];
+unsigned long lastEventPingMs = 0;
+unsigned long lastEventRxMs = 0;
+
 String roomId;
 String deviceId;
 contracts::Desired lastDesired;
 bool hasDesired = false;
+/** Newest room command seen (applied, or held back by a higher-priority broadcast). */
 uint32_t lastAppliedVer = 0;
-String lastStreamId;
+/** Same for the ward's broadcasts, which are versioned per ward. */
+uint32_t lastWardVer = 0;
+/** Scope, priority and stream entry of what is shown now (see `contracts::outranks()`). */
+contracts::Scope activeScope = contracts::Scope::Room;
+uint8_t activePriority = contracts::kPriorityNormal;
+char activeId[RedisLink::kStreamIdCapacity] = "";
+/** `room:{id}:ward`, empty when the room follows no ward. */
+String wardId;
+bool wardChanged = false;
+/** Every key of `roomId`, built once when the id is assigned (empty while unprovisioned). */
+contracts::RoomKeys roomKeys;
+
+/** Command streams a receiver follows: its room's own, then its ward's broadcasts. */
+enum CommandSource : uint8_t { kRoomSource, kWardSource, kCommandSources };
+/** `cmd:ward:{ward}`, empty when the room follows no ward (the room's is `roomKeys.cmd`). */
+String wardStream;
+char streamCursors[kCommandSources][RedisLink::kStreamIdCapacity] = {};
+
+struct CommandBatchVisitor;
+bool decodeStreamEntry(const CommandBatchVisitor &entry, contracts::Desired &desired);
+bool recordState(const contracts::Desired &desired, const String &json);
+bool timeIsValid();
+
+/**
+ * Collects an `XREAD` batch from `cmd:room:{id}` and, when the room has a ward, from
+ * `cmd:ward:{ward}`. Entries arrive in either wire format (the JSON `p` field or the
+ * compact `m`/`b`/`v`/`f` integer fields) and are decoded as they are parsed, but only
+ * the newest `ver` of each stream is kept, so a backlog queued during an outage costs
+ * one round-trip and at most one PWM update. `lastId` follows every entry, including
+ * superseded and malformed ones, so each cursor moves past all of them.
+ */
+struct CommandBatchVisitor : RedisLink::StreamVisitor {
+  /** Newest command found on one stream. */
+  struct Newest {
+    contracts::Desired desired;
+    char id[RedisLink::kStreamIdCapacity] = "";
+    bool found = false;
+  };
+
+  // Fields of the entry currently being parsed.
+  uint8_t source = kRoomSource;
+  char id[RedisLink::kStreamIdCapacity] = "";
+  char payload[kStreamPayloadCapacity] = "";
+  char mode[2] = "";
+  char brightness[4] = "";
+  char ver[11] = "";
+  char fade[11] = "";
+  // Batch results, per source.
+  char lastId[kCommandSources][RedisLink::kStreamIdCapacity] = {};
+  Newest newest[kCommandSources];
+  uint8_t received[kCommandSources] = {};
+  uint16_t total = 0;
+
+  void reset() {
+    for (uint8_t i = 0; i < kCommandSources; ++i) {
+      lastId[i][0] = '\0';
+      newest[i].found = false;
+      received[i] = 0;
+    }
+    source = kRoomSource;
+    total = 0;
+  }
+  /** True when a stream filled the whole `COUNT`, i.e. more entries are waiting. */
+  bool backlogged() const {
+    for (uint8_t count : received) {
+      if (count >= kXreadCount) {
+        return true;
+      }
+    }
+    return false;
+  }
+  /**
+   * Reply streams are told apart by request position (`{roomKeys.cmd, wardStream}`);
+   * entries of any other stream (`RedisLink::kUnknownStream`) are skipped.
+   */
+  void streamAt(uint8_t index) { source = index; }
+  bool entry(const char *entryId) {
+    if (source >= kCommandSources || strlen(entryId) >= sizeof(id)) {
+      return false;
+    }
+    strcpy(id, entryId);
+    strcpy(lastId[source], entryId);
+    ++received[source];
+    ++total;
+    payload[0] = mode[0] = brightness[0] = ver[0] = fade[0] = '\0';
+    return true;
+  }
+  char *field(const char *name, size_t &cap) {
+    if (!name[0] || name[1]) {
+      return nullptr;
+    }
+    switch (name[0]) {
+      case 'p':
+        cap = sizeof(payload);
+        return payload;
+      case 'm':
+        cap = sizeof(mode);
+        return mode;
+      case 'b':
+        cap = sizeof(brightness);
+        return brightness;
+      case 'v':
+        cap = sizeof(ver);
+        return ver;
+      case 'f':
+        cap = sizeof(fade);
+        return fade;
+      default:
+        return nullptr;
+    }
+  }
+  void entryDone(bool complete) {
+    contracts::Desired desired;
+    if (!complete || !(payload[0] || ver[0]) || !decodeStreamEntry(*this, desired)) {
+      return;
+    }
+    // The stream, not the payload, decides the scope and thus which version counter applies.
+    desired.scope = source == kWardSource ? contracts::Scope::Ward : contracts::Scope::Room;
+    // Later entries win ties so a re-sent version still lands on its newest content.
+    Newest &best = newest[source];
+    if (!best.found || desired.ver >= best.desired.ver) {
+      best.desired = desired;
+      strcpy(best.id, id);
+      best.found = true;
+    }
+  }
+};
+
+CommandBatchVisitor commandBatch;
+contracts::CompactDesired compactScratch;
 bool streamCursorValid = false;
-unsigned long lastHeartbeatMs = 0;
+/** The last `reported` write failed with the link; a resumed session repeats it. */
+bool reportPending = false;
+
+/**
+ * Session kept in RTC user memory, which survives resets but not a power cycle: the room,
+ * its ward, both stream cursors and what is shown. A warm start restores it and continues
+ * the streams where it stopped instead of provisioning and re-reading the snapshot.
+ * `check` (FNV-1a over everything after it) rejects the garbage found after power-on.
+ */
+struct ResumeRecord {
+  uint32_t magic;
+  uint32_t check;
+  char room[kResumeIdCapacity];
+  char ward[kResumeIdCapacity];
+  char cursors[kCommandSources][RedisLink::kStreamIdCapacity];
+  char activeId[RedisLink::kStreamIdCapacity];
+  uint32_t lastAppliedVer;
+  uint32_t lastWardVer;
+  contracts::Desired shown;
+};
+static_assert(sizeof(ResumeRecord) % 4 == 0 && sizeof(ResumeRecord) <= 512,
+              "ResumeRecord must fill whole words of the 512-byte RTC user memory");
+/** `check` of the record in RTC memory, 0 when none is stored. */
+uint32_t savedResumeCheck = 0;
+
+/**
+ * Cold-start state kept in flash (the `EEPROM` sector): the access point's BSSID and
+ * channel, the last DHCP lease, the provisioned room and the level last shown. A power
+ * cycle rejoins without a scan, relights the LEDs before Wi-Fi is up and adopts the room
+ * while provisioning re-confirms it in the background.
+ */
+struct BootRecord {
+  uint32_t magic;
+  uint32_t check;
+  uint8_t bssid[6];
+  uint8_t channel;  // 0: no access point stored
+  uint8_t brightness;
+  char mode[4];
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  char room[kResumeIdCapacity];
+};
+BootRecord bootRecord = {};
+bool bootRecordValid = false;
+/** Provisioning confirmed `roomId` on this boot (a restored room is only assumed). */
+bool roomProvisioned = false;
+unsigned long lastBootCheckMs = 0;
+uint32_t pendingBootCheck = 0;
+unsigned long pendingBootSinceMs = 0;
+/** Refresh `room:{id}:online` on the next pass instead of waiting out the interval. */
+bool heartbeatDue = true;
+/** Activity and latency pace for the adaptive intervals (see scheduler.hpp). */
+sched::Cadence cadence;
 unsigned long lastAnnounceMs = 0;
 String jsonScratch;
 bool wifiAnnounced = false;
@@ -209,6 +588,25 @@ bool timeConfigured = false;
 bool timeAnnounced = false;
 unsigned long lastTimeSyncAttemptMs = 0;
 
+/**
+ * Progress of the current fade. The ticker callback runs from the SDK timer task, which
+ * only gets the CPU while `loop()` yields, so it never interleaves with `applyPwm()`.
+ */
+struct FadeState {
+  uint16_t level = 0;  // shown now
+  uint16_t from = 0;
+  uint16_t to = 0;
+  uint32_t startMs = 0;
+  uint32_t durationMs = 0;
+  uint32_t rate = 0;  // levels per ms, Q16, so ticks need no division
+  bool rising = false;
+  bool active = false;
+  uint16_t written[kLedChannelCount] = {};  // last analogWrite() value per channel
+};
+
+FadeState fade;
+Ticker fadeTicker;
+
 /** Parsed quiet-hours schedule pulled from Redis. */
 struct QuietHoursWindow {
   bool enabled = false;
@@ -219,10 +617,47 @@ struct QuietHoursWindow {
 
 QuietHoursWindow quietWindow;
 bool quietWindowLoaded = false;
-unsigned long lastQuietFetchMs = 0;
+bool quietCfgChanged = true;
 unsigned long lastSoundSampleMs = 0;
 unsigned long lastWarningPublishedMs = 0;
 
+/** ADC readings taken by `soundTicker` and drained by `monitorSound()`. */
+SpscRing<uint16_t, kSoundRingCapacity> soundRing;
+Ticker soundTicker;
+
+/** Levels over one analysis window, all mapped onto the sensor's dB scale. */
+struct SoundWindow {
+  float leqDb = 0.0f;   // energy average (equivalent continuous level)
+  float rmsDb = 0.0f;   // RMS of the readings
+  float peakDb = 0.0f;  // loudest single reading
+  uint16_t samples = 0;
+};
+
+/** Running summary of the window Leq values seen during the current minute. */
+struct SoundMinute {
+  uint32_t startEpoch = 0;  // 0 while the clock is not set
+  unsigned long startMs = 0;
+  uint16_t windows = 0;
+  float minDb = 0.0f;
+  float maxDb = 0.0f;
+  float sumDb = 0.0f;
+  uint16_t histogram[kSoundHistogramBins] = {};
+};
+
+/** A finished minute, in tenths of a dB, waiting for the next batched flush. */
+struct TelemetryRecord {
+  uint32_t ts = 0;
+  uint16_t windows = 0;
+  int16_t minDd = 0;
+  int16_t maxDd = 0;
+  int16_t meanDd = 0;
+  int16_t p95Dd = 0;
+};
+
+SoundMinute soundMinute;
+TelemetryRecord telemetryPending[kTelemetryBatch];
+uint8_t telemetryPendingCount = 0;
+
 enum class StatusLedMode { Off, Solid, Blink };
 StatusLedMode statusLedMode = StatusLedMode::Off;
 bool statusLedBlinkState = true;
@@ -230,60 +665,31 @@ int8_t statusLedAppliedState = -1;
 unsigned long statusLedLastToggleMs = 0;
 
 /**
- * Parses a Desired payload from JSON while logging helpful errors for operators.
+ * Parses a Desired payload with `contracts::decodeDesired()` (fast path, then the DOM)
+ * and logs the payload for operators when it is rejected.
  */
-bool decodeDesiredJson(const String &payload,
+bool decodeDesiredJson(const char *payload,
                        contracts::Desired &desired,
                        const __FlashStringHelper *context) {
-  StaticJsonDocument<contracts::kDesiredJsonCapacity> doc;
-  DeserializationError err = deserializeJson(doc, payload);
-  if (err) {
-    Serial.print(F("[desired] "));
-    if (context) {
-      Serial.print(context);
-      Serial.print(' ');
-    }
-    Serial.print(F("json error: "));
-    Serial.println(err.c_str());
-    Serial.print(F("[desired] payload: "));
-    Serial.println(payload);
-    return false;
-  }
-  JsonVariantConst modeVar = doc["mode"];
-  const char *modePtr = nullptr;
-  String modeStr;
-  if (modeVar.is<const char *>()) {
-    modePtr = modeVar.as<const char *>();
-  } else if (modeVar.is<String>()) {
-    modeStr = modeVar.as<String>();
-    modePtr = modeStr.c_str();
-  }
-  if (!contracts::copyMode(modePtr, desired)) {
-    Serial.print(F("[desired] "));
-    if (context) {
-      Serial.print(context);
-      Serial.print(' ');
-    }
-    Serial.print(F("invalid mode: "));
-    Serial.println(modePtr ? modePtr : "(null)");
-    Serial.print(F("[desired] payload: "));
-    Serial.println(payload);
-    return false;
-  }
-  desired.brightness = doc["brightness"] | desired.brightness;
-  contracts::clampBrightness(desired);
-  desired.ver = doc["ver"] | desired.ver;
-  return true;
+  if (contracts::decodeDesired(payload, desired)) {
+    return true;
+  }
+  LOG_WARN("[desired] %S invalid json or mode: %s", context, payload);
+  return false;
 }
 
 /**
- * Lua script invoked via EVAL to map MAC addresses to room ids in Redis.
+ * Lua script invoked via EVAL to map MAC addresses to room ids in Redis. Every room it
+ * returns is also listed in `rooms:index`, which the website's fleet view pages.
  */
 const char kProvisionScript[] PROGMEM = R"lua(
 local dev = ARGV[1]
 local base = tonumber(ARGV[2]) or 100
 local rid = redis.call('GET','device:'..dev..':room')
-if rid then return rid end
+if rid then
+  redis.call('ZADD','rooms:index',0,rid)
+  return rid
+end
 local next_id = redis.call('INCR','rooms:next_id')
 if next_id < base then
   next_id = base
@@ -295,21 +701,13 @@ redis.call('SET','room:'..rid..':device',dev)
 if redis.call('EXISTS','room:'..rid..':desired') == 0 then
   redis.call('SET','room:'..rid..':desired','{"mode":"off","brightness":0,"ver":0}')
 end
+redis.call('ZADD','rooms:index',0,rid)
 return rid
 )lua";
 
-/** Emits a tagged receiver log line. */
-void logInfo(const __FlashStringHelper *msg) {
-  Serial.print(F("[receiver] "));
-  Serial.println(msg);
-}
-
 /** Logs the most recent Redis error string with additional context. */
 void logRedisFailure(const __FlashStringHelper *where) {
-  Serial.print(F("[redis] "));
-  Serial.print(where);
-  Serial.print(F(": "));
-  Serial.println(redis.lastError());
+  LOG_WARN("[redis] %S: %s", where, redis.lastError().c_str());
 }
 
 /** Returns the corrected duty cycle when the output is active-low. */
@@ -368,90 +766,256 @@ void updateStatusLed(unsigned long now) {
   }
 }
 
+/** FNV-1a over `bytes[from, size)`, i.e. a stored record past its header. */
+uint32_t recordCheck(const void *record, size_t from, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(record);
+  uint32_t hash = 2166136261UL;
+  for (size_t i = from; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619UL;
+  }
+  return hash | 1;  // never 0, which marks "nothing stored"
+}
+
+uint32_t resumeCheck(const ResumeRecord &record) {
+  return recordCheck(&record, offsetof(ResumeRecord, room), sizeof(record));
+}
+
+uint32_t bootCheck(const BootRecord &record) {
+  return recordCheck(&record, offsetof(BootRecord, bssid), sizeof(record));
+}
+
+/** True once the room, its snapshot and the stream cursors are all known. */
+bool sessionResumable() { return kSessionResume && roomId.length() && hasDesired && streamCursorValid; }
+
+/** Copies the session into RTC memory when it changed since the last write. */
+void saveSession() {
+  if (!sessionResumable() || roomId.length() >= kResumeIdCapacity) {
+    return;
+  }
+  ResumeRecord record;
+  memset(static_cast<void *>(&record), 0, sizeof(record));  // padding too, it is checksummed
+  record.magic = kResumeMagic;
+  strcpy(record.room, roomId.c_str());
+  memcpy(record.cursors, streamCursors, sizeof(record.cursors));
+  if (wardId.length() < kResumeIdCapacity) {
+    strcpy(record.ward, wardId.c_str());
+  } else {
+    record.cursors[kWardSource][0] = '\0';
+  }
+  strcpy(record.activeId, activeId);
+  record.lastAppliedVer = lastAppliedVer;
+  record.lastWardVer = lastWardVer;
+  memcpy(&record.shown, &lastDesired, sizeof(record.shown));
+  record.check = resumeCheck(record);
+  if (record.check == savedResumeCheck) {
+    return;
+  }
+  if (ESP.rtcUserMemoryWrite(0, reinterpret_cast<uint32_t *>(&record), sizeof(record))) {
+    savedResumeCheck = record.check;
+  }
+}
+
+/** Invalidates the stored session so the next start provisions from scratch. */
+void clearSession() {
+  if (!savedResumeCheck) {
+    return;
+  }
+  uint32_t header[2] = {0, 0};
+  ESP.rtcUserMemoryWrite(0, header, sizeof(header));
+  savedResumeCheck = 0;
+}
+
 /** Clears cached room-specific state so resyncs start from scratch. */
 void resetRoomState(bool dropRoomId = true) {
+  clearSession();
+  reportPending = false;
   hasDesired = false;
+  if (dropRoomId) {
+    roomProvisioned = false;
+  }
   lastAppliedVer = 0;
-  lastHeartbeatMs = 0;
+  lastWardVer = 0;
+  activeScope = contracts::Scope::Room;
+  activePriority = contracts::kPriorityNormal;
+  activeId[0] = '\0';
+  heartbeatDue = true;
   lastAnnounceMs = 0;
   streamCursorValid = false;
-  lastStreamId.remove(0);
+  for (char *cursor : streamCursors) {
+    cursor[0] = '\0';
+  }
+  if (streamLink.asyncPending()) {
+    // The outstanding read targets the old room/cursor; its reply must not be applied.
+    streamLink.stop();
+  }
   quietWindow = QuietHoursWindow();
   quietWindowLoaded = false;
-  lastQuietFetchMs = 0;
+  quietCfgChanged = true;
   lastSoundSampleMs = 0;
   lastWarningPublishedMs = 0;
   if (dropRoomId) {
+    // Telemetry measured under the old room id must not land in the new room's stream.
+    telemetryPendingCount = 0;
     roomId.remove(0);
+    wardId.remove(0);
+    wardStream.remove(0);
+    roomKeys.clear();
+  }
+}
+
+/**
+ * Closes the reader link after a failure. Room state and the stream cursor survive, so
+ * the next read resumes exactly where this one stopped.
+ */
+void dropStreamLink(const __FlashStringHelper *context) {
+  LOG_WARN("[stream] %S: %s", context, streamLink.lastError().c_str());
+  streamLink.stop();
+  streamClient.stop();
+  streamBackoff.schedule(millis());
+}
+
+/** Connects and authenticates the reader link with its own backoff. */
+bool ensureStreamLink(unsigned long now) {
+  if (streamLink.connected()) {
+    return true;
   }
+  if (!streamBackoff.ready(now)) {
+    return false;
+  }
+  streamLink.stop();
+  if (!streamClient.connect(REDIS_HOST, REDIS_PORT)) {
+    streamBackoff.schedule(now);
+    return false;
+  }
+  streamLink.setTimeout(kRedisTimeoutMs);
+  streamClient.setNoDelay(true);
+  if (!streamLink.auth(REDIS_PASSWORD)) {
+    dropStreamLink(F("auth"));
+    return false;
+  }
+  streamBackoff.connected(now);
+  LOG_INFO("[stream] reader connected");
+  return true;
 }
 
-/** Tears down the Redis link after logging the failure. */
+/**
+ * Tears down the Redis link after logging the failure. A resumable session keeps its
+ * room state and cursors for `resumeSession()`; anything else starts over.
+ */
 void dropRedis(const __FlashStringHelper *context) {
   logRedisFailure(context);
   redis.stop();
-  resetRoomState();
+  if (!sessionResumable()) {
+    resetRoomState();
+  }
 }
 
 /**
- * Initializes the stream cursor so the receiver resumes consuming at the tail.
+ * Picks the session up after a reconnect (or a warm start from RTC memory) without
+ * provisioning or re-reading the snapshot: the stream cursors already mark what was
+ * consumed, so the next XREAD delivers whatever was published meanwhile. Only a
+ * `reported` write that failed with the link is repeated.
+ */
+void resumeSession() {
+  LOG_INFO("[redis] resuming room %s at %s", roomId.c_str(), streamCursors[kRoomSource]);
+  heartbeatDue = true;
+  wardChanged = true;  // one GET; the assignment may have moved while the link was down
+  if (reportPending && contracts::encodeDesired(lastDesired, &roomId, jsonScratch)) {
+    recordState(lastDesired, jsonScratch);
+  }
+}
+
+/**
+ * Initializes the room stream cursor so the receiver resumes consuming at the tail. The
+ * snapshot just applied is the room's newest command, so its tail entry becomes the one
+ * later commands are ranked against.
  */
 bool primeStreamCursor() {
   if (!roomId.length()) {
     return false;
   }
-  String tailId;
-  if (!redis.streamTailId(contracts::stream_cmd(roomId), tailId)) {
+  char *cursor = streamCursors[kRoomSource];
+  if (!streamLink.streamTailId(roomKeys.cmd, cursor, RedisLink::kStreamIdCapacity)) {
     return false;
   }
-  if (tailId.length()) {
-    lastStreamId = tailId;
-  } else {
-    lastStreamId = F("0-0");
+  if (!cursor[0]) {
+    strcpy(cursor, "0-0");
   }
+  strcpy(activeId, cursor);
   streamCursorValid = true;
   return true;
 }
 
 /** Prints the current Wi-Fi status plus IP information. */
 void logWifiSnapshot(const __FlashStringHelper *prefix) {
-  Serial.print(F("[wifi] "));
-  if (prefix) {
-    Serial.print(prefix);
-    Serial.print(' ');
-  }
-  wl_status_t status = WiFi.status();
-  Serial.print(F("status="));
-  Serial.print(static_cast<int>(status));
-  Serial.print(F(" ip="));
-  Serial.print(WiFi.localIP());
-  Serial.print(F(" gw="));
-  Serial.print(WiFi.gatewayIP());
-  Serial.print(F(" rssi="));
-  Serial.println(WiFi.RSSI());
+  LOG_INFO("[wifi] %S status=%d ip=%s gw=%s rssi=%d", prefix, static_cast<int>(WiFi.status()),
+           WiFi.localIP().toString().c_str(), WiFi.gatewayIP().toString().c_str(), static_cast<int>(WiFi.RSSI()));
+}
+
+/**
+ * Rejoins the access point from the boot record on its stored channel and BSSID, which
+ * skips the scan (and, with `RECEIVER_FAST_BOOT_STATIC_IP`, DHCP by reusing the stored
+ * lease). After `RECEIVER_FAST_CONNECT_TIMEOUT_MS` the stored AP is dropped for this boot
+ * and false tells the caller to fall back to a full connect.
+ */
+bool connectWifiFast() {
+  if (!kFastBoot || !bootRecordValid || !bootRecord.channel) {
+    return false;
+  }
+  const bool staticLease = kFastBootStaticIp && bootRecord.ip;
+  if (staticLease) {
+    WiFi.config(IPAddress(bootRecord.ip), IPAddress(bootRecord.gateway), IPAddress(bootRecord.subnet),
+                IPAddress(bootRecord.dns));
+  }
+  WiFi.begin(WIFI_SSID, WIFI_PASS, bootRecord.channel, bootRecord.bssid);
+  LOG_INFO("[wifi] fast connect to %s ch=%u%s", WIFI_SSID, static_cast<unsigned>(bootRecord.channel),
+           staticLease ? " (stored lease)" : "");
+  const unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start > kFastConnectTimeoutMs) {
+      LOG_WARN("[wifi] fast connect timed out, scanning");
+      bootRecord.channel = 0;
+      if (staticLease) {
+        WiFi.config(IPAddress(0u), IPAddress(0u), IPAddress(0u));  // back to DHCP
+      }
+      return false;
+    }
+    logging::pump();
+    delay(10);
+  }
+  return true;
 }
 
 /** Connects to Wi-Fi STA mode, retrying until the link is healthy. */
 void connectWifiBlocking() {
+  const unsigned long blockedSinceMs = millis();
+  if (connectWifiFast()) {
+    ++receiverMetrics.wifiConnects;
+    receiverMetrics.wifiBlockedMs += millis() - blockedSinceMs;
+    logWifiSnapshot(F("connected (fast)"));
+    return;
+  }
   WiFi.mode(WIFI_STA);
   WiFi.persistent(false);
   WiFi.disconnect(true);
   delay(500);
   WiFi.begin(WIFI_SSID, WIFI_PASS);
-  Serial.print(F("[wifi] blocking connect to "));
-  Serial.println(F(WIFI_SSID));
+  LOG_INFO("[wifi] blocking connect to %s", WIFI_SSID);
   unsigned long start = millis();
   while (WiFi.status() != WL_CONNECTED) {
-    Serial.print(F("[wifi] status="));
-    Serial.println(static_cast<int>(WiFi.status()));
+    LOG_DEBUG("[wifi] status=%d", static_cast<int>(WiFi.status()));
+    logging::pump();
     delay(500);
     if (millis() - start > 20000) {
-      Serial.println(F("[wifi] retrying blocking connect"));
+      LOG_WARN("[wifi] retrying blocking connect");
       WiFi.disconnect(false);
       WiFi.begin(WIFI_SSID, WIFI_PASS);
       start = millis();
     }
   }
+  ++receiverMetrics.wifiConnects;
+  receiverMetrics.wifiBlockedMs += millis() - blockedSinceMs;
   logWifiSnapshot(F("connected (blocking)"));
 }
 
@@ -487,29 +1051,31 @@ bool ensureRedis() {
   }
   redis.stop();
   redisClient.stop();
-  Serial.printf("[redis] connect %s:%u\n", REDIS_HOST, static_cast<unsigned>(REDIS_PORT));
+  LOG_INFO("[redis] connect %s:%u", REDIS_HOST, static_cast<unsigned>(REDIS_PORT));
   if (!redisClient.connect(REDIS_HOST, REDIS_PORT)) {
-    Serial.println("[redis] tcp connect failed");
+    LOG_WARN("[redis] tcp connect failed");
     redisBackoff.schedule(now);
     return false;
   }
   redis.setTimeout(kRedisTimeoutMs);
   redisClient.setNoDelay(true);
-  if (!redis.auth(REDIS_PASSWORD)) {
-    Serial.println("[redis] auth failed");
+  redis.beginPipeline();
+  redis.queueAuth(REDIS_PASSWORD);
+  redis.queuePing();
+  if (!redis.execPipeline()) {
+    LOG_WARN("[redis] auth/ping failed");
     redisBackoff.schedule(now);
-    dropRedis(F("auth"));
+    dropRedis(F("auth/ping"));
     return false;
   }
-  if (!redis.ping()) {
-    Serial.println("[redis] ping failed");
-    redisBackoff.schedule(now);
-    dropRedis(F("ping"));
-    return false;
+  LOG_INFO("[redis] connected");
+  redisBackoff.connected(now);
+  if (sessionResumable()) {
+    resumeSession();
+    return redis.connected();
   }
-  Serial.println("[redis] connected");
-  redisBackoff.reset();
-  resetRoomState();
+  // A room assumed from the boot record stays until provisioning answers otherwise.
+  resetRoomState(roomProvisioned);
   return true;
 }
 
@@ -522,11 +1088,66 @@ void announceRoom(bool force) {
   if (!force && (now - lastAnnounceMs) < ROOM_ANNOUNCE_INTERVAL_MS) {
     return;
   }
-  Serial.print(F("ROOM:"));
-  Serial.println(roomId);
+  // Console protocol for the sender, not a log line: always sent, in order with the logs.
+  logging::sink().printf_P(PSTR("ROOM:%s\n"), roomId.c_str());
   lastAnnounceMs = now;
 }
 
+/**
+ * Reads `room:{id}:ward` and follows that ward's broadcast stream, or none when unset
+ * or longer than `contracts::kRoomIdMaxLen`. A new ward starts from its newest
+ * broadcast (see `primeWardCursor()`).
+ */
+bool refreshWard() {
+  String ward;
+  bool isNull = false;
+  if (!redis.get(roomKeys.ward, ward, &isNull)) {
+    dropRedis(F("get ward"));
+    return false;
+  }
+  ward.trim();
+  if (ward.length() > contracts::kRoomIdMaxLen) {
+    LOG_WARN("[redis] ward id too long, ignored: %s", ward.c_str());
+    ward = String();
+  }
+  if (ward == wardId) {
+    return true;
+  }
+  wardId = ward;
+  wardStream = wardId.length() ? contracts::stream_ward_cmd(wardId) : String();
+  streamCursors[kWardSource][0] = '\0';
+  lastWardVer = 0;
+  if (activeScope == contracts::Scope::Ward) {
+    // The old ward's broadcast stays shown, but no longer holds the room.
+    activePriority = contracts::kPriorityNormal;
+  }
+  if (streamLink.asyncPending()) {
+    // The outstanding read lists the old streams.
+    streamLink.stop();
+  }
+  if (wardId.length()) {
+    LOG_INFO("[redis] room %s follows ward %s", roomId.c_str(), wardId.c_str());
+  } else {
+    LOG_INFO("[redis] room %s follows no ward", roomId.c_str());
+  }
+  return true;
+}
+
+/**
+ * Adopts `rid` as this receiver's room and builds its keys once, so the XREAD, publish
+ * and heartbeat paths never format a key. Ids longer than `contracts::kRoomIdMaxLen`
+ * are refused.
+ */
+bool assignRoomId(const String &rid) {
+  if (!roomKeys.assign(rid)) {
+    LOG_ERROR("[redis] room id '%s' is longer than %u characters", rid.c_str(),
+              static_cast<unsigned>(contracts::kRoomIdMaxLen));
+    return false;
+  }
+  roomId = rid;
+  return true;
+}
+
 /**
  * Runs the provisioning script so each receiver learns which room it controls.
  */
@@ -535,56 +1156,147 @@ bool provisionRoom() {
     return false;
   }
   String rid;
-  Serial.println("[redis] provisioning room");
+  LOG_INFO("[redis] provisioning room");
   if (!redis.evalRoomScript(FPSTR(kProvisionScript), deviceId, PROVISIONING_BASE_ID, rid)) {
-    Serial.println("[redis] provision failed");
+    LOG_WARN("[redis] provision failed");
     dropRedis(F("provision"));
     return false;
   }
-  Serial.print("[redis] provisioned room ");
-  Serial.println(rid);
+  LOG_INFO("[redis] provisioned room %s", rid.c_str());
   if (!rid.length()) {
     return false;
   }
   if (rid != roomId) {
-    roomId = rid;
+    if (!assignRoomId(rid)) {
+      return false;
+    }
     resetRoomState(false);
   }
+  char wire[4];
+  snprintf(wire, sizeof(wire), "%u", static_cast<unsigned>(kWireFormat));
+  if (!redis.set(roomKeys.wire, wire)) {
+    dropRedis(F("wire format"));
+    return false;
+  }
+  if (!refreshWard()) {
+    return false;
+  }
+  roomProvisioned = true;
   announceRoom(true);
   return true;
 }
 
+/** Re-reads the ward assignment after a `ward` event (or a resubscribe). */
+void maybeRefreshWard() {
+  if (!wardChanged || !roomId.length() || !redis.connected()) {
+    return;
+  }
+  if (refreshWard()) {
+    wardChanged = false;
+  }
+}
+
 /**
- * Applies a Desired snapshot to every configured LED channel.
+ * Drives every LED channel at `level` from its duty table, interpolating between the two
+ * neighbouring percents; channels whose value did not change are not rewritten.
+ */
+void writeFadeLevel(uint16_t level, bool force) {
+  fade.level = level;
+  uint8_t index = static_cast<uint8_t>(level / kFadeLevelScale);
+  uint16_t frac = level % kFadeLevelScale;
+  for (size_t i = 0; i < kLedChannelCount; ++i) {
+    const DutyTable &table = kLedChannels[i].table;
+    uint16_t duty = table.duty[index];
+    if (frac) {
+      uint16_t next = table.duty[index + 1];
+      duty = next >= duty ? static_cast<uint16_t>(duty + (static_cast<uint32_t>(next - duty) * frac >> 8))
+                          : static_cast<uint16_t>(duty - (static_cast<uint32_t>(duty - next) * frac >> 8));
+    }
+    if (duty == fade.written[i] && !force) {
+      continue;
+    }
+    fade.written[i] = duty;
+    // Polarity is already folded into the table.
+    analogWrite(kLedChannels[i].pin, duty);
+  }
+}
+
+/** Ticker callback: moves the fade along and stops the ticker once it lands. */
+void fadeTick() {
+  if (!fade.active) {
+    fadeTicker.detach();
+    return;
+  }
+  uint32_t elapsed = millis() - fade.startMs;
+  uint16_t level = fade.to;
+  uint32_t span = fade.rising ? fade.to - fade.from : fade.from - fade.to;
+  uint32_t step = static_cast<uint32_t>((static_cast<uint64_t>(fade.rate) * elapsed) >> 16);
+  if (elapsed < fade.durationMs && step < span) {
+    level = static_cast<uint16_t>(fade.rising ? fade.from + step : fade.from - step);
+  } else {
+    fade.active = false;
+    fadeTicker.detach();
+  }
+  writeFadeLevel(level, false);
+}
+
+/**
+ * Applies a Desired snapshot to every configured LED channel: a step when `fadeMs` is 0
+ * (or shorter than a tick), otherwise a ticker-driven fade from the level shown now.
  */
 void applyPwm(const contracts::Desired &desired) {
-  uint16_t brightnessDuty = 0;
+  uint16_t target = 0;
   if (strcmp(desired.mode, "on") == 0 && desired.brightness > 0) {
-    brightnessDuty = map(desired.brightness, 0, 100, 0, PWMRANGE);
-  }
-  for (const auto &channel : kLedChannels) {
-    uint32_t duty = (static_cast<uint32_t>(channel.maxDuty) * brightnessDuty) / PWMRANGE;
-    writeLedDuty(channel.pin, static_cast<uint16_t>(duty), kLedActiveLow);
+    target = static_cast<uint16_t>(desired.brightness * kFadeLevelScale);
   }
-  Serial.printf("[pwm] duty=%u mode=%s brightness=%u\n",
-                static_cast<unsigned>(brightnessDuty),
-                desired.mode,
-                static_cast<unsigned>(desired.brightness));
+  fadeTicker.detach();
+  fade.active = false;
+  if (desired.fadeMs < kFadeTickMs || target == fade.level) {
+    writeFadeLevel(target, true);
+  } else {
+    fade.from = fade.level;
+    fade.to = target;
+    fade.rising = target > fade.level;
+    uint32_t span = fade.rising ? target - fade.level : fade.level - target;
+    fade.startMs = millis();
+    fade.durationMs = desired.fadeMs;
+    fade.rate = (span << 16) / desired.fadeMs;
+    fade.active = true;
+    fadeTicker.attach_ms(kFadeTickMs, fadeTick);
+  }
+  LOG_DEBUG("[pwm] duty=%u mode=%s brightness=%u fade=%lums",
+            static_cast<unsigned>(kLedChannels[0].table.duty[target / kFadeLevelScale]),
+            desired.mode,
+            static_cast<unsigned>(desired.brightness),
+            static_cast<unsigned long>(fade.active ? desired.fadeMs : 0));
 }
 
 /**
- * Writes the applied Desired snapshot to both the reported key and stream.
+ * Writes the applied Desired snapshot to both the reported key and stream in one atomic
+ * script call; the server skips the write when it already holds a newer version. An equal
+ * version is accepted, since a ward broadcast is reported under the room's current `ver`.
  */
-bool recordState(const String &json) {
-  if (!redis.set(contracts::key_reported(roomId), json)) {
-    dropRedis(F("set reported"));
+bool recordState(const contracts::Desired &desired, const String &json) {
+  const uint32_t ver = desired.ver;
+  uint32_t storedVer = 0;
+  const char *const *fields = nullptr;
+  uint8_t fieldCount = 0;
+  if (kWireFormat >= contracts::kWireCompact) {
+    contracts::encodeDesiredCompact(desired, compactScratch);
+    fields = compactScratch.args;
+    fieldCount = compactScratch.count;
+  }
+  if (!redis.evalPublishScript(FPSTR(contracts::kPublishScript), roomKeys.reported, roomKeys.state, json,
+                               ver, kStreamTrimLen, storedVer, fields, fieldCount, true)) {
+    reportPending = true;
+    dropRedis(F("record state"));
     return false;
   }
-  if (!redis.xaddJson(contracts::stream_state(roomId), json)) {
-    dropRedis(F("xadd state"));
-    return false;
+  reportPending = false;
+  if (storedVer != ver) {
+    LOG_WARN("[redis] reported v=%lu stale, server holds v=%lu",
+             static_cast<unsigned long>(ver), static_cast<unsigned long>(storedVer - 1));
   }
-  redis.xtrimApprox(contracts::stream_state(roomId), kStreamTrimLen);
   return true;
 }
 
@@ -594,7 +1306,7 @@ bool recordState(const String &json) {
 bool pullSnapshot() {
   bool isNull = false;
   String stored;
-  if (!redis.get(contracts::key_desired(roomId), stored, &isNull)) {
+  if (!redis.get(roomKeys.desired, stored, &isNull)) {
     dropRedis(F("get desired"));
     return false;
   }
@@ -602,7 +1314,7 @@ bool pullSnapshot() {
     stored = F("{\"mode\":\"off\",\"brightness\":0,\"ver\":0}");
   }
   contracts::Desired desired;
-  if (!decodeDesiredJson(stored, desired, F("snapshot"))) {
+  if (!decodeDesiredJson(stored.c_str(), desired, F("snapshot"))) {
     desired = contracts::Desired();
   }
   if (!contracts::encodeDesired(desired, &roomId, jsonScratch)) {
@@ -611,76 +1323,349 @@ bool pullSnapshot() {
   applyPwm(desired);
   lastDesired = desired;
   lastAppliedVer = desired.ver;
+  activeScope = desired.scope;
+  activePriority = desired.priority;
   hasDesired = true;
-  if (!recordState(jsonScratch)) {
+  if (!recordState(desired, jsonScratch)) {
     return false;
   }
   streamCursorValid = false;
-  lastStreamId.remove(0);
+  for (char *cursor : streamCursors) {
+    cursor[0] = '\0';
+  }
   return true;
 }
 
-/** Decodes a streamed command and applies it when the version is newer. */
-void handlePayload(const String &payload) {
-  contracts::Desired desired = lastDesired;
-  if (!decodeDesiredJson(payload, desired, F("stream"))) {
-    return;
+/**
+ * Milliseconds from the stream entry id's timestamp (`<ms>-<seq>`, stamped by the server
+ * at XADD) to now, or -1 while the clock is not synced. Clock skew can make the raw
+ * difference negative; that is reported as 0.
+ */
+long commandAgeMs(const char *entryId) {
+  if (!kMetricsEnabled || !entryId[0] || !timeIsValid()) {
+    return -1;
+  }
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  uint64_t nowMs = static_cast<uint64_t>(tv.tv_sec) * 1000 + static_cast<uint64_t>(tv.tv_usec / 1000);
+  uint64_t sentMs = strtoull(entryId, nullptr, 10);
+  return nowMs > sentMs ? static_cast<long>(nowMs - sentMs) : 0;
+}
+
+/** Records a command's version in its scope; false when the version was already seen. */
+bool consumeCommand(const contracts::Desired &desired) {
+  uint32_t &seen = desired.scope == contracts::Scope::Ward ? lastWardVer : lastAppliedVer;
+  if (desired.ver <= seen) {
+    return false;
   }
-  if (desired.ver <= lastAppliedVer) {
-    return;
+  seen = desired.ver;
+  return true;
+}
+
+/**
+ * Records a streamed command as seen and, when its version is new in its scope and it
+ * outranks what is shown (`contracts::outranks()`), makes it the active one. Returns
+ * true when the command should be shown.
+ */
+bool admitCommand(const contracts::Desired &desired, const char *entryId) {
+  if (!consumeCommand(desired)) {
+    return false;
   }
-  if (!contracts::encodeDesired(desired, &roomId, jsonScratch)) {
+  if (!contracts::outranks(desired, entryId, activeScope, activePriority, activeId)) {
+    LOG_INFO("[desired] %s v=%lu held back: priority %u below %u",
+             desired.scope == contracts::Scope::Ward ? "ward" : "room",
+             static_cast<unsigned long>(desired.ver), desired.priority, activePriority);
+    return false;
+  }
+  activeScope = desired.scope;
+  activePriority = desired.priority;
+  strcpy(activeId, entryId);
+  return true;
+}
+
+/**
+ * Shows an admitted command. A ward broadcast is reported under the room's own `ver`
+ * (tagged with its scope and priority), which keeps `room:{id}:reported` monotonic per
+ * room. `entryId` is the stream entry it came from, used to time publish → apply →
+ * reported.
+ */
+void showCommand(const contracts::Desired &desired, const char *entryId) {
+  contracts::Desired shown = desired;
+  if (desired.scope == contracts::Scope::Ward) {
+    shown.ver = lastAppliedVer;
+  }
+  if (!contracts::encodeDesired(shown, &roomId, jsonScratch)) {
     return;
   }
-  applyPwm(desired);
-  lastDesired = desired;
-  lastAppliedVer = desired.ver;
+  applyPwm(shown);
+  long appliedAge = commandAgeMs(entryId);
+  if (appliedAge >= 0) {
+    receiverMetrics.applyMs.record(static_cast<uint32_t>(appliedAge));
+  }
+  lastDesired = shown;
   hasDesired = true;
-  recordState(jsonScratch);
+  if (recordState(shown, jsonScratch) && appliedAge >= 0) {
+    receiverMetrics.reportedMs.record(static_cast<uint32_t>(commandAgeMs(entryId)));
+  }
+}
+
+/** Decodes a streamed command in whichever wire format it arrived. */
+bool decodeStreamEntry(const CommandBatchVisitor &entry, contracts::Desired &desired) {
+  desired = lastDesired;
+  // Missing fields default to what is shown, but never its scope or priority.
+  desired.scope = contracts::Scope::Room;
+  desired.priority = contracts::kPriorityNormal;
+  if (entry.payload[0]) {
+    return decodeDesiredJson(entry.payload, desired, F("stream"));
+  }
+  if (!contracts::decodeDesiredCompact(entry.mode, entry.brightness, entry.ver,
+                                       entry.fade[0] ? entry.fade : nullptr, desired)) {
+    LOG_WARN("[desired] stream invalid compact entry m=%s b=%s v=%s",
+             entry.mode, entry.brightness, entry.ver);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Admits the newest room command and ward broadcast collected by `commandBatch`, older
+ * entry first, then shows the last one admitted. When both are admitted the earlier one
+ * only moves the precedence state, so one batch never drives the PWM twice.
+ */
+void applyCommandBatch() {
+  CommandBatchVisitor::Newest *first = &commandBatch.newest[kRoomSource];
+  CommandBatchVisitor::Newest *second = &commandBatch.newest[kWardSource];
+  if (!first->found) {
+    first = second;
+    second = nullptr;
+  } else if (!second->found) {
+    second = nullptr;
+  } else if (contracts::compareStreamIds(first->id, second->id) > 0) {
+    CommandBatchVisitor::Newest *later = first;
+    first = second;
+    second = later;
+  }
+  if (!first->found) {
+    return;
+  }
+  cadence.touch(millis());
+  LOG_DEBUG("[stream] %u entr%s, newest id %s ver %u", commandBatch.total,
+            commandBatch.total == 1 ? "y" : "ies", (second ? second : first)->id,
+            static_cast<unsigned>((second ? second : first)->desired.ver));
+  const bool showFirst = admitCommand(first->desired, first->id);
+  if (second && admitCommand(second->desired, second->id)) {
+    showCommand(second->desired, second->id);
+  } else if (showFirst) {
+    showCommand(first->desired, first->id);
+  }
+}
+
+/** Moves each stream cursor past everything the last read returned. */
+void advanceStreamCursor() {
+  for (uint8_t i = 0; i < kCommandSources; ++i) {
+    if (commandBatch.lastId[i][0]) {
+      strcpy(streamCursors[i], commandBatch.lastId[i]);
+    }
+  }
+}
+
+/** Number of streams to `XREAD`: the room's, plus the ward's when it has one. */
+uint8_t followedStreams() { return wardId.length() ? kCommandSources : 1; }
+
+/**
+ * Starts following a (new) ward at its newest broadcast, which is replayed through the
+ * usual precedence rules: a standing high-priority broadcast is honoured right away, an
+ * equal-priority one only if it is newer than what the room shows.
+ */
+bool primeWardCursor() {
+  commandBatch.reset();
+  commandBatch.source = kWardSource;
+  if (!streamLink.streamTail(wardStream, commandBatch)) {
+    return false;
+  }
+  const char *tail = commandBatch.lastId[kWardSource];
+  strcpy(streamCursors[kWardSource], tail[0] ? tail : "0-0");
+  applyCommandBatch();
+  return true;
 }
 
 /**
- * Continuously blocks on `XREAD` so new commands are applied with minimal latency.
+ * Re-evaluates `cadence` for this pass: a running fade holds it active, recent commands
+ * and warnings keep it there for a while, and a slow `redis` link backs it off.
  */
-void pumpStream() {
+void updatePace(unsigned long now) {
+  if (cadence.update(now, fade.active, redis.smoothedRttUs())) {
+    LOG_DEBUG("[sched] pace %s", sched::paceName(cadence.pace()));
+  }
+}
+
+/**
+ * XREAD BLOCK window: short while active, so cursors, the saved session and ward
+ * switches keep up with a busy room; long when idle or slow, for fewer round trips.
+ */
+uint16_t xreadBlockMs() { return static_cast<uint16_t>(cadence.scale(kXreadBlockMs)); }
+
+/**
+ * Keeps an `XREAD BLOCK <xreadBlockMs()> COUNT RECEIVER_XREAD_COUNT` outstanding on the
+ * reader link without stalling `loop()`: one call sends it, later calls poll for the
+ * reply, so sound sampling, the status LED and every write on `redis` keep their cadence
+ * while the server blocks. A full batch means a backlog: it is drained with a few
+ * non-blocking reads and only the newest version found across them is applied.
+ */
+void pumpStream(unsigned long now) {
   if (!roomId.length() || !hasDesired) {
     return;
   }
-  if (!streamCursorValid) {
-    if (!primeStreamCursor()) {
-      dropRedis(F("stream tail"));
-      return;
+  if (!ensureStreamLink(now)) {
+    return;
+  }
+  if (!streamLink.asyncPending()) {
+    if (!streamCursorValid) {
+      if (!primeStreamCursor()) {
+        dropStreamLink(F("tail"));
+        return;
+      }
+    }
+    if (wardId.length() && !streamCursors[kWardSource][0]) {
+      if (!primeWardCursor()) {
+        dropStreamLink(F("ward tail"));
+        return;
+      }
+      if (!roomId.length()) {
+        return;  // reporting the replayed broadcast failed and dropped the room
+      }
+    }
+    const char *cursors[kCommandSources];
+    for (uint8_t i = 0; i < kCommandSources; ++i) {
+      cursors[i] = streamCursors[i][0] ? streamCursors[i] : "0-0";
     }
+    saveSession();
+    commandBatch.reset();
+    const RedisLink::KeyView streams[kCommandSources] = {roomKeys.cmd, wardStream};
+    if (!streamLink.beginXreadStreams(streams, cursors, followedStreams(), xreadBlockMs(),
+                                      kXreadCount)) {
+      dropStreamLink(F("xread"));
+    }
+    return;
   }
-  String payload;
-  String entryId;
-  const String cursor = lastStreamId.length() ? lastStreamId : String(F("0-0"));
-  if (redis.xreadLatest(contracts::stream_cmd(roomId), kXreadBlockMs, cursor, entryId, payload)) {
-    Serial.print("[stream] id: ");
-    Serial.print(entryId);
-    Serial.print(" payload: ");
-    Serial.println(payload);
-    lastStreamId = entryId;
-    handlePayload(payload);
-  } else if (redis.lastError().length()) {
-    dropRedis(F("xread"));
+  RedisLink::AsyncResult result = streamLink.pollXread(commandBatch);
+  if (result == RedisLink::AsyncResult::Pending) {
+    return;
+  }
+  if (result == RedisLink::AsyncResult::Failed) {
+    dropStreamLink(F("xread"));
+    return;
   }
+  advanceStreamCursor();
+  for (uint8_t round = 1; round < kXreadDrainRounds && commandBatch.backlogged(); ++round) {
+    const char *cursors[kCommandSources] = {streamCursors[kRoomSource], streamCursors[kWardSource]};
+    memset(commandBatch.received, 0, sizeof(commandBatch.received));
+    const RedisLink::KeyView streams[kCommandSources] = {roomKeys.cmd, wardStream};
+    if (!streamLink.xreadStreams(streams, cursors, followedStreams(), 0, kXreadCount, commandBatch)) {
+      // Keep what was already collected; the cursor only moved past parsed batches.
+      dropStreamLink(F("xread drain"));
+      break;
+    }
+    advanceStreamCursor();
+    yield();
+  }
+  applyCommandBatch();
+  saveSession();
   yield();
 }
 
-/** Periodically refreshes the `room:{id}:online` key so ops can detect outages. */
-void maintainHeartbeat(unsigned long now) {
+/**
+ * Heartbeat task: refreshes the `room:{id}:online` key so ops can detect outages. Stays
+ * due until a room is known.
+ */
+bool sendHeartbeat(unsigned long) {
   if (!roomId.length() || !redis.connected()) {
+    return false;
+  }
+  if (!redis.setHeartbeat(roomKeys.online, contracts::kHeartbeatTtlSec)) {
+    dropRedis(F("heartbeat"));
+    return false;
+  }
+  heartbeatDue = false;
+  return true;
+}
+
+/** Heartbeats keep a fixed cadence: the key expires after `kHeartbeatTtlSec`. */
+unsigned long heartbeatIntervalMs() { return RECEIVER_HEARTBEAT_MS; }
+
+/**
+ * Writes the current metrics window as JSON to `room:{id}:metrics` field `receiver`
+ * (with a TTL on the hash) and starts a new window.
+ */
+void publishMetrics(unsigned long now) {
+  if (!kMetricsEnabled || !roomId.length() || !redis.connected()) {
     return;
   }
-  if ((now - lastHeartbeatMs) < RECEIVER_HEARTBEAT_MS) {
+  ReceiverMetrics &m = receiverMetrics;
+  if (now - m.windowStartMs < kMetricsIntervalMs) {
     return;
   }
-  if (!redis.setHeartbeat(contracts::key_online(roomId), contracts::kHeartbeatTtlSec)) {
-    dropRedis(F("heartbeat"));
+  metrics::SnapshotWriter out(metricsScratch, sizeof(metricsScratch));
+  out.appendf(PSTR("{\"ts\":%lu,\"window_ms\":%lu,\"uptime_s\":%lu,"),
+              static_cast<unsigned long>(timeIsValid() ? time(nullptr) : 0),
+              static_cast<unsigned long>(now - m.windowStartMs), static_cast<unsigned long>(now / 1000));
+  out.appendf(PSTR("\"heap\":{\"free\":%lu,\"min_free\":%lu,\"max_block\":%u,\"frag\":%u},"),
+              static_cast<unsigned long>(ESP.getFreeHeap()), static_cast<unsigned long>(m.minFreeHeap),
+              static_cast<unsigned>(ESP.getMaxFreeBlockSize()), static_cast<unsigned>(ESP.getHeapFragmentation()));
+  out.histogram("loop_us", m.loopUs);
+  out.appendf(PSTR(","));
+  out.rtt(m.links);
+  out.appendf(PSTR(",\"cmd_ms\":{"));
+  out.histogram("applied", m.applyMs);
+  out.appendf(PSTR(","));
+  out.histogram("reported", m.reportedMs);
+  out.appendf(PSTR("},\"links\":{\"wifi\":{\"connects\":%u,\"blocked_ms\":%lu}"),
+              static_cast<unsigned>(m.wifiConnects), static_cast<unsigned long>(m.wifiBlockedMs));
+  const struct {
+    const char *name;
+    Backoff &backoff;
+  } links[] = {{"redis", redisBackoff}, {"stream", streamBackoff}, {"events", eventBackoff}};
+  for (const auto &link : links) {
+    out.appendf(PSTR(",\"%s\":{\"connects\":%u,\"failures\":%u,\"down_ms\":%lu}"), link.name,
+                static_cast<unsigned>(link.backoff.connects), static_cast<unsigned>(link.backoff.failures),
+                static_cast<unsigned long>(link.backoff.downMs));
+  }
+  out.appendf(PSTR("}}"));
+  if (!out.ok()) {
+    LOG_WARN("[metrics] snapshot exceeds %u bytes, skipped", static_cast<unsigned>(kMetricsJsonCapacity));
+  } else {
+    redis.beginPipeline();
+    redis.queueHset(roomKeys.metrics, "receiver", out.c_str());
+    redis.queueExpire(roomKeys.metrics, kMetricsTtlSec);
+    if (!redis.execPipeline()) {
+      dropRedis(F("metrics"));
+      return;
+    }
+    LOG_DEBUG("[metrics] %s", out.c_str());
+  }
+  m.links.reset();
+  m.loopUs.reset();
+  m.applyMs.reset();
+  m.reportedMs.reset();
+  m.minFreeHeap = UINT32_MAX;
+  m.wifiConnects = 0;
+  m.wifiBlockedMs = 0;
+  for (const auto &link : links) {
+    link.backoff.clearStats();
+  }
+  m.windowStartMs = now;
+}
+
+/** Samples loop timing and free heap for the metrics window. */
+void sampleMetrics() {
+  if (!kMetricsEnabled) {
     return;
   }
-  lastHeartbeatMs = now;
+  receiverMetrics.loopTimer.tick(receiverMetrics.loopUs);
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < receiverMetrics.minFreeHeap) {
+    receiverMetrics.minFreeHeap = freeHeap;
+  }
 }
 
 /** Returns true once SNTP has provided a modern epoch. */
@@ -708,10 +1693,10 @@ void ensureClockSync(unsigned long now) {
                NTP_SERVER_TERTIARY);
     timeConfigured = true;
     lastTimeSyncAttemptMs = now;
-    Serial.println(F("[time] requested SNTP sync"));
+    LOG_INFO("[time] requested SNTP sync");
   }
   if (timeIsValid() && !timeAnnounced) {
-    Serial.println(F("[time] clock synchronized"));
+    LOG_INFO("[time] clock synchronized");
     timeAnnounced = true;
   }
 }
@@ -740,7 +1725,7 @@ bool fetchQuietHours() {
   }
   String payload;
   bool isNull = false;
-  if (!redis.get(contracts::key_cfg(roomId), payload, &isNull)) {
+  if (!redis.get(roomKeys.cfg, payload, &isNull)) {
     dropRedis(F("get cfg"));
     return false;
   }
@@ -754,8 +1739,7 @@ bool fetchQuietHours() {
     StaticJsonDocument<384> doc;
     DeserializationError err = deserializeJson(doc, payload);
     if (err) {
-      Serial.print(F("[quiet] cfg json error: "));
-      Serial.println(err.c_str());
+      LOG_WARN("[quiet] cfg json error: %s", err.c_str());
     } else {
       JsonVariantConst night = doc["night"];
       JsonVariantConst wake = doc["wake"];
@@ -775,30 +1759,122 @@ bool fetchQuietHours() {
   }
   quietWindow = next;
   quietWindowLoaded = true;
-  Serial.print(F("[quiet] window "));
-  Serial.print(quietWindow.enabled ? F("enabled") : F("disabled"));
-  Serial.print(F(" start="));
-  Serial.print(quietWindow.startMinutes / 60);
-  Serial.print(':');
-  Serial.print(quietWindow.startMinutes % 60);
-  Serial.print(F(" end="));
-  Serial.print(quietWindow.endMinutes / 60);
-  Serial.print(':');
-  Serial.println(quietWindow.endMinutes % 60);
+  LOG_INFO("[quiet] window %s start=%u:%02u end=%u:%02u", quietWindow.enabled ? "enabled" : "disabled",
+           quietWindow.startMinutes / 60, quietWindow.startMinutes % 60, quietWindow.endMinutes / 60,
+           quietWindow.endMinutes % 60);
   return true;
 }
 
-/** Refreshes the quiet-hours schedule based on a timer. */
-void maybeRefreshQuietHours(unsigned long now) {
-  if (!roomId.length() || !redis.connected()) {
+/** True while the event subscription is up, so the cfg poll can back off. */
+bool eventsLive() { return kEventsEnabled && eventsSubscribed && events.connected(); }
+
+/** Closes the event link and falls back to polling until it is re-established. */
+void dropEvents(const __FlashStringHelper *context) {
+  LOG_WARN("[events] %S: %s", context, events.lastError().c_str());
+  events.stop();
+  eventClient.stop();
+  eventsSubscribed = false;
+  eventBackoff.schedule(millis());
+}
+
+/**
+ * Keeps a subscription on this room's event channel. Reprovisioning moves it to the
+ * new room; every (re)subscribe refetches the cfg because events sent meanwhile are lost.
+ */
+void ensureEvents(unsigned long now) {
+  if (!kEventsEnabled || !roomId.length()) {
+    return;
+  }
+  if (eventsSubscribed && eventsRoomId != roomId) {
+    events.stop();
+    eventClient.stop();
+    eventsSubscribed = false;
+    eventBackoff.reset();
+  }
+  if (eventsSubscribed) {
+    if (events.connected()) {
+      return;
+    }
+    dropEvents(F("link lost, polling"));
+  }
+  if (!eventBackoff.ready(now)) {
+    return;
+  }
+  events.stop();
+  if (!eventClient.connect(REDIS_HOST, REDIS_PORT)) {
+    eventBackoff.schedule(now);
+    return;
+  }
+  events.setTimeout(kRedisTimeoutMs);
+  const RedisLink::KeyView channel(roomKeys.events);
+  if (!events.auth(REDIS_PASSWORD) || !events.subscribe(&channel, 1)) {
+    dropEvents(F("subscribe"));
     return;
   }
-  if (quietWindowLoaded && (now - lastQuietFetchMs) < kQuietConfigRefreshMs) {
+  eventsSubscribed = true;
+  eventsRoomId = roomId;
+  eventBackoff.connected(now);
+  lastEventPingMs = now;
+  lastEventRxMs = now;
+  quietCfgChanged = true;
+  wardChanged = true;
+  LOG_INFO("[events] subscribed %s", roomKeys.events.c_str());
+}
+
+/**
+ * Drains pending event messages without blocking and pings the subscription so a dead
+ * link is noticed and the cfg poll resumes.
+ */
+void pumpEvents(unsigned long now) {
+  if (!eventsSubscribed) {
     return;
   }
-  if (fetchQuietHours()) {
-    lastQuietFetchMs = now;
+  for (uint8_t i = 0; i < kEventsPerLoop; ++i) {
+    char channel[48];
+    char name[contracts::kEventNameCapacity];
+    RedisLink::PollResult result = events.pollMessage(channel, sizeof(channel), name, sizeof(name));
+    if (result == RedisLink::PollResult::Failed) {
+      dropEvents(F("poll"));
+      return;
+    }
+    if (result == RedisLink::PollResult::Idle) {
+      break;
+    }
+    lastEventRxMs = now;
+    if (result == RedisLink::PollResult::Message && strcmp(name, contracts::kEventCfg) == 0) {
+      quietCfgChanged = true;
+    } else if (result == RedisLink::PollResult::Message && strcmp(name, contracts::kEventWard) == 0) {
+      wardChanged = true;
+    }
+  }
+  if ((now - lastEventPingMs) >= kEventPingIntervalMs) {
+    lastEventPingMs = now;
+    if (!events.subscriberPing()) {
+      dropEvents(F("ping"));
+      return;
+    }
+  }
+  if ((now - lastEventRxMs) > 2 * kEventPingIntervalMs + kRedisTimeoutMs) {
+    dropEvents(F("no pong"));
+  }
+}
+
+/**
+ * Cfg task: refreshes the quiet-hours schedule on `cfg` events (`quietCfgChanged`) or
+ * when `quietPollIntervalMs()` lapses; a failed read stays due.
+ */
+bool refreshQuietHours(unsigned long) {
+  if (!redis.connected() || !fetchQuietHours()) {
+    return false;
   }
+  quietCfgChanged = false;
+  return true;
+}
+
+/** Cfg poll interval at the current pace, stretched while `cfg` events are live. */
+unsigned long quietPollIntervalMs() {
+  unsigned long interval = cadence.scale(kQuietConfigRefreshMs);
+  return eventsLive() && kEventFallbackRefreshMs > interval ? kEventFallbackRefreshMs : interval;
 }
 
 /** Returns true when the current time falls inside the configured quiet window. */
@@ -819,45 +1895,66 @@ bool quietHoursActive(const tm &localNow) {
   return minutes >= start || minutes < end;
 }
 
+/** Ticker callback: takes one ADC reading per `kSoundSamplePeriodMs`. */
+void sampleSound() {
+  soundRing.push(static_cast<uint16_t>(analogRead(RECEIVER_SOUND_SENSOR_PIN)));
+}
+
+/** Maps a raw (or averaged) ADC reading onto the sensor's linear dB scale. */
+float soundCountsToDb(float counts) {
+  if (counts < 0.0f) {
+    counts = 0.0f;
+  } else if (counts > kSoundAdcMax) {
+    counts = kSoundAdcMax;
+  }
+  return kSoundMinDb + (counts / kSoundAdcMax) * (kSoundMaxDb - kSoundMinDb);
+}
+
 /**
- * Samples the analog sound sensor and converts it to an estimated dB value.
+ * Drains every reading buffered since the previous window and reduces it to Leq, RMS and
+ * peak. Returns false when nothing was sampled (e.g. right after boot).
  */
-float readSoundDecibels() {
-  if (!kSoundSensorEnabled) {
-    return 0.0f;
-  }
-  uint32_t accumulator = 0;
-  for (uint8_t i = 0; i < kSoundSampleCount; ++i) {
-    uint16_t reading = static_cast<uint16_t>(analogRead(RECEIVER_SOUND_SENSOR_PIN));
-    accumulator += reading;
-    delayMicroseconds(200);
+bool readSoundWindow(SoundWindow &window) {
+  uint16_t reading = 0;
+  uint32_t count = 0;
+  uint16_t peak = 0;
+  uint64_t sumSquares = 0;
+  float energy = 0.0f;
+  while (soundRing.pop(reading)) {
+    ++count;
+    if (reading > peak) {
+      peak = reading;
+    }
+    sumSquares += static_cast<uint32_t>(reading) * reading;
+    energy += powf(10.0f, soundCountsToDb(reading) / 10.0f);
   }
-  float average = static_cast<float>(accumulator) / static_cast<float>(kSoundSampleCount);
-  if (average < 0.0f) {
-    average = 0.0f;
-  } else if (average > kSoundAdcMax) {
-    average = kSoundAdcMax;
+  uint32_t dropped = soundRing.takeDropped();
+  if (dropped) {
+    LOG_WARN("[sound] ring full, dropped %lu samples", static_cast<unsigned long>(dropped));
   }
-  float normalized = average / kSoundAdcMax;
-  float decibels = kSoundMinDb + normalized * (kSoundMaxDb - kSoundMinDb);
-  if (decibels < kSoundMinDb) {
-    decibels = kSoundMinDb;
-  } else if (decibels > kSoundMaxDb) {
-    decibels = kSoundMaxDb;
+  if (!count) {
+    return false;
   }
-  return decibels;
+  window.samples = static_cast<uint16_t>(count > 0xFFFF ? 0xFFFF : count);
+  window.leqDb = 10.0f * log10f(energy / static_cast<float>(count));
+  window.rmsDb = soundCountsToDb(sqrtf(static_cast<float>(sumSquares) / static_cast<float>(count)));
+  window.peakDb = soundCountsToDb(peak);
+  return true;
 }
 
 /**
- * Serializes the quiet-hour warning payload and stores it in Redis.
+ * Serializes the quiet-hour warning payload, stores it in Redis and announces it on the
+ * room's event channel.
  */
-bool publishSoundWarning(float decibels, uint32_t capturedAt) {
+bool publishSoundWarning(const SoundWindow &window, uint32_t capturedAt) {
   if (!redis.connected() || !roomId.length()) {
     return false;
   }
-  StaticJsonDocument<192> doc;
+  StaticJsonDocument<256> doc;
   doc["room"] = roomId;
-  doc["decibels"] = decibels;
+  doc["decibels"] = window.leqDb;
+  doc["peak_db"] = window.peakDb;
+  doc["rms_db"] = window.rmsDb;
   doc["threshold"] = kSoundThresholdDb;
   doc["captured_at"] = capturedAt;
   doc["quiet"] = true;
@@ -869,18 +1966,104 @@ bool publishSoundWarning(float decibels, uint32_t capturedAt) {
   if (serializeJson(doc, warningScratch) == 0) {
     return false;
   }
-  if (!redis.set(contracts::key_latest_warning(roomId), warningScratch)) {
+  redis.beginPipeline();
+  redis.queueSet(roomKeys.latestWarning, warningScratch);
+  redis.queuePublish(roomKeys.events, contracts::kEventWarning);
+  if (!redis.execPipeline()) {
     dropRedis(F("set warning"));
     return false;
   }
-  Serial.print(F("[sound] warning "));
-  Serial.print(decibels, 1);
-  Serial.println(F(" dB"));
+  LOG_INFO("[sound] warning Leq %.1f dB peak %.1f dB", window.leqDb, window.peakDb);
   return true;
 }
 
+/** Converts dB to the integer tenths stored in telemetry entries. */
+int16_t toDecibelTenths(float db) {
+  return static_cast<int16_t>(lroundf(db * 10.0f));
+}
+
+/** Adds one window's Leq to the current minute's summary. */
+void recordSoundMinute(float leqDb, unsigned long now) {
+  SoundMinute &minute = soundMinute;
+  if (!minute.windows) {
+    time_t epoch = time(nullptr);
+    minute.startEpoch = epoch >= kMinValidEpoch ? static_cast<uint32_t>(epoch) : 0;
+    minute.startMs = now;
+    minute.minDb = minute.maxDb = leqDb;
+  }
+  ++minute.windows;
+  minute.minDb = leqDb < minute.minDb ? leqDb : minute.minDb;
+  minute.maxDb = leqDb > minute.maxDb ? leqDb : minute.maxDb;
+  minute.sumDb += leqDb;
+  int bin = static_cast<int>(leqDb - kSoundMinDb + 0.5f);
+  bin = bin < 0 ? 0 : (bin >= kSoundHistogramBins ? kSoundHistogramBins - 1 : bin);
+  ++minute.histogram[bin];
+}
+
+/** Closes the current minute into `telemetryPending`, dropping the oldest when full. */
+void closeSoundMinute() {
+  SoundMinute &minute = soundMinute;
+  uint32_t rank = (static_cast<uint32_t>(minute.windows) * 95 + 99) / 100;
+  uint32_t seen = 0;
+  uint16_t bin = 0;
+  for (; bin < kSoundHistogramBins - 1; ++bin) {
+    seen += minute.histogram[bin];
+    if (seen >= rank) {
+      break;
+    }
+  }
+  float p95 = kSoundMinDb + bin;
+  p95 = p95 < minute.minDb ? minute.minDb : (p95 > minute.maxDb ? minute.maxDb : p95);
+  if (telemetryPendingCount == kTelemetryBatch) {
+    memmove(telemetryPending, telemetryPending + 1, sizeof(telemetryPending[0]) * (kTelemetryBatch - 1));
+    --telemetryPendingCount;
+  }
+  TelemetryRecord &record = telemetryPending[telemetryPendingCount++];
+  record.ts = minute.startEpoch;
+  record.windows = minute.windows;
+  record.minDd = toDecibelTenths(minute.minDb);
+  record.maxDd = toDecibelTenths(minute.maxDb);
+  record.meanDd = toDecibelTenths(minute.sumDb / minute.windows);
+  record.p95Dd = toDecibelTenths(p95);
+  minute = SoundMinute();
+}
+
+/**
+ * Appends the pending minutes to `telemetry:room:{id}` once a full batch is ready, one
+ * trimmed `XADD` per minute in a single pipeline. Entries hold integer fields `ts` (epoch
+ * of the minute start, 0 without a clock), `n` (windows) and `min`/`max`/`mean`/`p95`
+ * in tenths of a dB.
+ */
+void flushSoundTelemetry() {
+  if (telemetryPendingCount < kTelemetryBatch || !redis.connected() || !roomId.length()) {
+    return;
+  }
+  char text[6][12];
+  const char *fields[12] = {"ts",  text[0], "n",    text[1], "min", text[2],
+                            "max", text[3], "mean", text[4], "p95", text[5]};
+  redis.beginPipeline();
+  for (uint8_t i = 0; i < telemetryPendingCount; ++i) {
+    const TelemetryRecord &record = telemetryPending[i];
+    snprintf(text[0], sizeof(text[0]), "%lu", static_cast<unsigned long>(record.ts));
+    snprintf(text[1], sizeof(text[1]), "%u", static_cast<unsigned>(record.windows));
+    snprintf(text[2], sizeof(text[2]), "%d", record.minDd);
+    snprintf(text[3], sizeof(text[3]), "%d", record.maxDd);
+    snprintf(text[4], sizeof(text[4]), "%d", record.meanDd);
+    snprintf(text[5], sizeof(text[5]), "%d", record.p95Dd);
+    // Arguments are copied into the link's frame buffer, so `text` is reused.
+    redis.queueXadd(roomKeys.telemetry, kTelemetryMaxLen, fields, 12);
+  }
+  if (!redis.execPipeline()) {
+    dropRedis(F("telemetry"));
+    return;
+  }
+  LOG_INFO("[sound] telemetry +%u minutes", static_cast<unsigned>(telemetryPendingCount));
+  telemetryPendingCount = 0;
+}
+
 /**
- * Samples the sound sensor, checks quiet-hour state, and publishes warnings.
+ * Analyses the readings buffered over the last window, checks quiet-hour state, and
+ * publishes warnings when the window's Leq crosses the threshold.
  */
 void monitorSound(unsigned long now) {
   if (!kSoundSensorEnabled) {
@@ -890,10 +2073,19 @@ void monitorSound(unsigned long now) {
     return;
   }
   lastSoundSampleMs = now;
-  float decibels = readSoundDecibels();
-  Serial.print(F("[sound] sample "));
-  Serial.print(decibels, 1);
-  Serial.println(F(" dB"));
+  SoundWindow window;
+  if (!readSoundWindow(window)) {
+    return;
+  }
+  LOG_DEBUG("[sound] Leq %.1f dB rms %.1f dB peak %.1f dB (%u samples)", window.leqDb, window.rmsDb, window.peakDb,
+            static_cast<unsigned>(window.samples));
+  if (kTelemetryEnabled) {
+    if (soundMinute.windows && (now - soundMinute.startMs) >= kTelemetryMinuteMs) {
+      closeSoundMinute();
+    }
+    recordSoundMinute(window.leqDb, now);
+    flushSoundTelemetry();
+  }
   if (!roomId.length() || !redis.connected() || !quietWindowLoaded || !quietWindow.enabled) {
     return;
   }
@@ -901,7 +2093,7 @@ void monitorSound(unsigned long now) {
   if (!acquireLocalTime(localNow) || !quietHoursActive(localNow)) {
     return;
   }
-  if (decibels < kSoundThresholdDb) {
+  if (window.leqDb < kSoundThresholdDb) {
     return;
   }
   time_t epoch = time(nullptr);
@@ -911,35 +2103,170 @@ void monitorSound(unsigned long now) {
   if ((now - lastWarningPublishedMs) < kSoundWarningCooldownMs) {
     return;
   }
-  if (publishSoundWarning(decibels, static_cast<uint32_t>(epoch))) {
+  if (publishSoundWarning(window, static_cast<uint32_t>(epoch))) {
     lastWarningPublishedMs = now;
+    cadence.touch(now);
   }
 }
 
+/**
+ * Restores the session a reset left in RTC memory and shows its state right away, before
+ * Wi-Fi is up; `ensureRedis()` then resumes it. The ward is re-read once in case it
+ * changed while the device was down.
+ */
+bool restoreSession() {
+  if (!kSessionResume) {
+    return false;
+  }
+  ResumeRecord record;
+  if (!ESP.rtcUserMemoryRead(0, reinterpret_cast<uint32_t *>(&record), sizeof(record)) ||
+      record.magic != kResumeMagic || record.check != resumeCheck(record)) {
+    return false;
+  }
+  if (!assignRoomId(record.room)) {
+    return false;
+  }
+  wardId = record.ward;
+  wardStream = wardId.length() ? contracts::stream_ward_cmd(wardId) : String();
+  memcpy(streamCursors, record.cursors, sizeof(streamCursors));
+  strcpy(activeId, record.activeId);
+  lastAppliedVer = record.lastAppliedVer;
+  lastWardVer = record.lastWardVer;
+  memcpy(&lastDesired, &record.shown, sizeof(lastDesired));
+  activeScope = lastDesired.scope;
+  activePriority = lastDesired.priority;
+  hasDesired = true;
+  streamCursorValid = true;
+  wardChanged = true;
+  savedResumeCheck = record.check;
+  contracts::Desired shown = lastDesired;
+  shown.fadeMs = 0;
+  applyPwm(shown);
+  LOG_INFO("[receiver] restored room %s v=%lu from rtc", roomId.c_str(), static_cast<unsigned long>(lastAppliedVer));
+  return true;
+}
+
+/** Reads the boot record from flash; an erased or foreign sector just disables fast boot. */
+void loadBootRecord() {
+  if (!kFastBoot) {
+    return;
+  }
+  EEPROM.begin(sizeof(BootRecord));
+  EEPROM.get(0, bootRecord);
+  bootRecordValid = bootRecord.magic == kBootMagic && bootRecord.check == bootCheck(bootRecord);
+  if (!bootRecordValid) {
+    bootRecord = BootRecord();
+  }
+}
+
+/**
+ * Cold start: shows the level from the boot record and adopts its room, so the snapshot
+ * read can follow the first Redis connect; `provisionRoom()` confirms the room later (see
+ * `loop()`), and a different answer resets to the provisioned one.
+ */
+void restoreBootState() {
+  if (!bootRecordValid) {
+    return;
+  }
+  contracts::Desired shown;
+  if (contracts::copyMode(bootRecord.mode, shown)) {
+    shown.brightness = bootRecord.brightness;
+    contracts::clampBrightness(shown);
+    applyPwm(shown);
+  }
+  if (!bootRecord.room[0]) {
+    return;
+  }
+  if (!assignRoomId(bootRecord.room)) {
+    return;
+  }
+  LOG_INFO("[receiver] assuming room %s from flash", roomId.c_str());
+}
+
+/**
+ * Writes the boot record once its contents (access point, lease, confirmed room and the
+ * shown level) have held still for `RECEIVER_BOOT_SAVE_DELAY_MS`, so fades, ramps and
+ * roaming never wear the flash sector. Versions are left out for the same reason.
+ */
+void maybeSaveBootRecord(unsigned long now) {
+  if (!kFastBoot || now - lastBootCheckMs < 1000) {
+    return;
+  }
+  lastBootCheckMs = now;
+  if (WiFi.status() != WL_CONNECTED || !roomProvisioned || !hasDesired) {
+    return;
+  }
+  BootRecord next = {};
+  next.magic = kBootMagic;
+  memcpy(next.bssid, WiFi.BSSID(), sizeof(next.bssid));
+  next.channel = static_cast<uint8_t>(WiFi.channel());
+  next.brightness = lastDesired.brightness;
+  strcpy(next.mode, lastDesired.mode);
+  next.ip = static_cast<uint32_t>(WiFi.localIP());
+  next.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+  next.subnet = static_cast<uint32_t>(WiFi.subnetMask());
+  next.dns = static_cast<uint32_t>(WiFi.dnsIP());
+  if (roomId.length() < kResumeIdCapacity) {
+    strcpy(next.room, roomId.c_str());
+  }
+  next.check = bootCheck(next);
+  if (bootRecordValid && next.check == bootRecord.check) {
+    pendingBootCheck = 0;
+    return;
+  }
+  if (next.check != pendingBootCheck) {
+    pendingBootCheck = next.check;
+    pendingBootSinceMs = now;
+    return;
+  }
+  if (now - pendingBootSinceMs < kBootSaveDelayMs) {
+    return;
+  }
+  EEPROM.put(0, next);
+  pendingBootCheck = 0;
+  if (!EEPROM.commit()) {
+    LOG_WARN("[boot] flash write failed");
+    return;
+  }
+  bootRecord = next;
+  bootRecordValid = true;
+  LOG_INFO("[boot] stored room %s ch=%u %s/%u", next.room, static_cast<unsigned>(next.channel), next.mode,
+           static_cast<unsigned>(next.brightness));
+}
+
 }  // namespace
 
 /** Arduino setup entry point that initializes IO and connectivity. */
 void setup() {
   Serial.begin(115200);
   delay(100);
-  logInfo(F("boot"));
+  LOG_INFO("[receiver] boot");
   analogWriteRange(PWMRANGE);
   for (const auto &channel : kLedChannels) {
     pinMode(channel.pin, OUTPUT);
-    writeLedDuty(channel.pin, 0, kLedActiveLow);
+  }
+  writeFadeLevel(0, true);
+  loadBootRecord();
+  if (!restoreSession()) {
+    restoreBootState();
   }
   if (kSoundSensorEnabled) {
     pinMode(RECEIVER_SOUND_SENSOR_PIN, INPUT);
+    soundTicker.attach_ms(kSoundSamplePeriodMs, sampleSound);
   }
   if (kStatusLedControllable) {
     pinMode(static_cast<uint8_t>(kStatusLedPin), OUTPUT);
     setStatusLed(false);
   }
   WiFi.mode(WIFI_STA);
-  WiFi.setSleepMode(WIFI_NONE_SLEEP);
+  // Modem sleep keeps the CPU (and PWM) running; commands then wait for the next DTIM beacon.
+  WiFi.setSleepMode(RECEIVER_MODEM_SLEEP ? WIFI_MODEM_SLEEP : WIFI_NONE_SLEEP);
   WiFi.persistent(false);
-  WiFi.disconnect(true);
-  delay(200);
+  if (!bootRecordValid || !bootRecord.channel) {
+    // Fast connect joins straight away; only a full connect starts from a clean slate.
+    WiFi.disconnect(true);
+    delay(200);
+  }
 #ifdef WIFI_HOSTNAME
   WiFi.hostname(WIFI_HOSTNAME);
 #endif
@@ -947,11 +2274,24 @@ void setup() {
   randomSeed(ESP.getChipId());
   jsonScratch.reserve(128);
   warningScratch.reserve(160);
+  if (kMetricsEnabled) {
+    redis.attachMetrics(&receiverMetrics.links);
+    streamLink.attachMetrics(&receiverMetrics.links);
+  }
 }
 
+/** Periodic tasks run once Redis is up: fixed-interval heartbeat, `cadence`-paced cfg poll. */
+sched::Task receiverTasks[] = {
+    {sendHeartbeat, heartbeatIntervalMs, &heartbeatDue, 0},
+    {refreshQuietHours, quietPollIntervalMs, &quietCfgChanged, 0},
+};
+sched::TaskTable tasks(receiverTasks);
+
 /** Main firmware loop orchestrating Wi-Fi/Redis, PWM, and monitoring. */
 void loop() {
   unsigned long now = millis();
+  logging::pump();
+  sampleMetrics();
   updateStatusLed(now);
   if (!ensureWifi()) {
     delay(25);
@@ -968,9 +2308,18 @@ void loop() {
   if (roomId.length() && !hasDesired) {
     pullSnapshot();
   }
-  maintainHeartbeat(now);
   announceRoom(false);
-  maybeRefreshQuietHours(now);
-  pumpStream();
+  ensureEvents(now);
+  pumpEvents(now);
+  updatePace(now);
+  tasks.runDue(now);
+  maybeRefreshWard();
+  pumpStream(now);
+  if (roomId.length() && hasDesired && !roomProvisioned) {
+    // A room restored from flash or RTC memory is confirmed once the lights are back.
+    provisionRoom();
+  }
+  maybeSaveBootRecord(now);
   monitorSound(now);
+  publishMetrics(now);
 }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Fixed-capacity single-producer/single-consumer ring buffer. One context (a timer
+ * callback) calls `push()`, another (`loop()`) calls `pop()`; each side only writes its
+ * own index, so no locks or interrupt masking are needed. When the consumer falls behind
+ * the newest samples are dropped and counted rather than overwriting unread ones.
+ */
+template <typename T, uint16_t Capacity>
+class SpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+ public:
+  /** Producer side: stores `value`, or counts an overrun and returns false when full. */
+  bool push(const T &value) {
+    uint16_t head = head_.load(std::memory_order_relaxed);
+    if (static_cast<uint16_t>(head - tail_.load(std::memory_order_acquire)) == Capacity) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    slots_[head & kMask] = value;
+    head_.store(static_cast<uint16_t>(head + 1), std::memory_order_release);
+    return true;
+  }
+
+  /** Consumer side: takes the oldest value, or returns false when empty. */
+  bool pop(T &value) {
+    uint16_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = slots_[tail & kMask];
+    tail_.store(static_cast<uint16_t>(tail + 1), std::memory_order_release);
+    return true;
+  }
+
+  /** Consumer side: discards everything queued so far. */
+  void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+  /** Consumer side: returns and resets the number of values dropped while full. */
+  uint32_t takeDropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+ private:
+  static constexpr uint16_t kMask = Capacity - 1;
+
+  T slots_[Capacity] = {};
+  std::atomic<uint16_t> head_{0};
+  std::atomic<uint16_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
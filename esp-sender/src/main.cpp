@@ -3,11 +3,21 @@
 #include <ArduinoJson.h>
 #include <cstring>
 #include <cstdio>
+#include <sys/time.h>
 #include <time.h>
 
+extern "C" {
+#include <gpio.h>
+#include <user_interface.h>
+}
+
 #include "config.h"
 #include "contracts.hpp"
+#include "log.hpp"
+#include "metrics.hpp"
 #include "redis_link.hpp"
+#include "schedule.hpp"
+#include "scheduler.hpp"
 
 #ifndef SENDER_DISPLAY_ENABLED
 #define SENDER_DISPLAY_ENABLED 1
@@ -56,44 +66,17 @@
 #define SCHEDULE_PUBLISH_MIN_INTERVAL_MS 1000
 #endif
 
-#ifndef SCHEDULE_DEFAULT_WAKE_HOUR
-#define SCHEDULE_DEFAULT_WAKE_HOUR 7
-#endif
-
-#ifndef SCHEDULE_DEFAULT_WAKE_MINUTE
-#define SCHEDULE_DEFAULT_WAKE_MINUTE 0
-#endif
-
-#ifndef SCHEDULE_DEFAULT_WAKE_DURATION_MIN
-#define SCHEDULE_DEFAULT_WAKE_DURATION_MIN 20
-#endif
-
-#ifndef SCHEDULE_DEFAULT_WAKE_BRIGHTNESS
-#define SCHEDULE_DEFAULT_WAKE_BRIGHTNESS 100
+#ifndef SENDER_PUBLISH_COALESCE_MS
+#define SENDER_PUBLISH_COALESCE_MS 200
 #endif
 
-#ifndef SCHEDULE_DEFAULT_NIGHT_HOUR
-#define SCHEDULE_DEFAULT_NIGHT_HOUR 22
+#ifndef SENDER_SLEEP_MODE
+#define SENDER_SLEEP_MODE 0
 #endif
-
-#ifndef SCHEDULE_DEFAULT_NIGHT_MINUTE
-#define SCHEDULE_DEFAULT_NIGHT_MINUTE 0
-#endif
-
-#ifndef SCHEDULE_DEFAULT_NIGHT_BRIGHTNESS
-#define SCHEDULE_DEFAULT_NIGHT_BRIGHTNESS 5
-#endif
-
-#ifndef SCHEDULE_DEFAULT_BASELINE_BRIGHTNESS
-#define SCHEDULE_DEFAULT_BASELINE_BRIGHTNESS 0
-#endif
-
-#ifndef QUIET_HOURS_DIM_MINUTES
-#define QUIET_HOURS_DIM_MINUTES 90
-#endif
-
-#ifndef WAKE_BRIGHTEN_MINUTES
-#define WAKE_BRIGHTEN_MINUTES 30
+static_assert(SENDER_SLEEP_MODE >= 0 && SENDER_SLEEP_MODE <= 2,
+              "SENDER_SLEEP_MODE must be 0 (always on), 1 (modem sleep) or 2 (light sleep)");
+#ifndef SENDER_SLEEP_MAX_MS
+#define SENDER_SLEEP_MAX_MS 1000
 #endif
 
 #ifndef SOUND_WARNING_DISPLAY_MS
@@ -160,8 +143,40 @@
 #define SENDER_STATUS_LED_ACTIVE_LOW 1
 #endif
 
+#ifndef SENDER_WIRE_FORMAT
+#define SENDER_WIRE_FORMAT 3
+#endif
+static_assert(SENDER_WIRE_FORMAT >= 1 && SENDER_WIRE_FORMAT <= 3,
+              "SENDER_WIRE_FORMAT must be 1 (JSON), 2 (compact) or 3 (compact + fades)");
+
+#ifndef SENDER_MAX_ROOMS
+#define SENDER_MAX_ROOMS 8
+#endif
+
+#ifndef SENDER_EXTRA_ROOM_IDS
+#define SENDER_EXTRA_ROOM_IDS ""
+#endif
+
+#ifndef REDIS_EVENTS_ENABLED
+#define REDIS_EVENTS_ENABLED 1
+#endif
+
+#ifndef REDIS_EVENTS_FALLBACK_MS
+#define REDIS_EVENTS_FALLBACK_MS 300000
+#endif
+
+#ifndef REDIS_EVENTS_PING_MS
+#define REDIS_EVENTS_PING_MS 30000
+#endif
+
 namespace {
 
+using scheduling::clampPercent;
+using scheduling::CompiledSchedule;
+using scheduling::kMinutesPerDay;
+using scheduling::kSecondsPerDay;
+using scheduling::RoomSchedule;
+
 constexpr uint16_t kStreamTrimLen = 200;
 constexpr uint16_t kRedisTimeoutMs = 1500;
 constexpr unsigned long kRoomRequestIntervalMs = 1500;
@@ -169,23 +184,47 @@ constexpr size_t kConsoleMaxBytes = 128;
 constexpr unsigned long kConsoleFlushMs = 500;
 constexpr unsigned long kConfigRefreshIntervalMs = SCHEDULE_REFRESH_MS;
 constexpr unsigned long kSchedulePublishIntervalMs = SCHEDULE_PUBLISH_MIN_INTERVAL_MS;
+constexpr unsigned long kPublishCoalesceMs = SENDER_PUBLISH_COALESCE_MS;
+constexpr uint8_t kSleepMode = SENDER_SLEEP_MODE;
+constexpr unsigned long kSleepMaxMs = SENDER_SLEEP_MAX_MS;
+/** Idle stretches shorter than this are not worth entering. */
+constexpr unsigned long kSleepMinMs = 5;
+/**
+ * Idle time is spent in `delay()` slices of at most this long, so a button edge, a socket
+ * with data or console input ends it within one slice (the SDK sleeps inside each).
+ */
+constexpr unsigned long kSleepSliceMs = 50;
 constexpr time_t kMinValidEpoch = 1609459200;  // 2021-01-01
-constexpr uint16_t kMinutesPerDay = 24 * 60;
-constexpr uint32_t kSecondsPerDay = static_cast<uint32_t>(kMinutesPerDay) * 60UL;
-constexpr uint16_t kQuietLeadMinutes = QUIET_HOURS_DIM_MINUTES;
-constexpr uint16_t kWakeLeadMinutes = WAKE_BRIGHTEN_MINUTES;
 constexpr uint16_t kOverrideAnalogMin = OVERRIDE_ANALOG_MIN;
 constexpr uint16_t kOverrideAnalogMax = OVERRIDE_ANALOG_MAX;
 constexpr uint8_t kOverrideAnalogMinDelta = OVERRIDE_ANALOG_MIN_DELTA;
 constexpr unsigned long kOverrideButtonDebounceMs = OVERRIDE_BUTTON_DEBOUNCE_MS;
 constexpr unsigned long kOverrideRefreshIntervalMs = 2000;
+constexpr bool kEventsEnabled = REDIS_EVENTS_ENABLED;
+constexpr unsigned long kEventFallbackRefreshMs = REDIS_EVENTS_FALLBACK_MS;
+constexpr unsigned long kEventPingIntervalMs = REDIS_EVENTS_PING_MS;
+constexpr uint8_t kEventsPerLoop = 4;
 constexpr int8_t kStatusLedPin = SENDER_STATUS_LED_PIN;
 constexpr bool kStatusLedActiveLow = SENDER_STATUS_LED_ACTIVE_LOW;
 constexpr bool kStatusLedEnabled = (SENDER_STATUS_LED_PIN >= 0);
 constexpr bool kStatusLedControllable = kStatusLedEnabled;
 constexpr unsigned long kStatusLedBlinkIntervalMs = 400;
+constexpr uint8_t kMaxWireFormat = SENDER_WIRE_FORMAT;
+constexpr uint8_t kMaxRooms = SENDER_MAX_ROOMS;
+/** Rooms per publish pipeline; one slot stays free for the override snapshot. */
+constexpr uint8_t kPublishBatchMax = RedisLink::kMaxPipelineDepth - 1;
+static_assert(SENDER_MAX_ROOMS >= 1 && SENDER_MAX_ROOMS <= 64, "SENDER_MAX_ROOMS must be 1-64");
+constexpr bool kMetricsEnabled = METRICS_ENABLED;
+constexpr unsigned long kMetricsIntervalMs = METRICS_PUBLISH_INTERVAL_MS;
+/** The metrics hash survives two missed publishes, then expires with the devices. */
+constexpr uint16_t kMetricsTtlSec = 3 * (METRICS_PUBLISH_INTERVAL_MS / 1000);
+/** Fits the snapshot with every counter at its widest (~1080 bytes). */
+constexpr size_t kMetricsJsonCapacity = 1152;
+static_assert(METRICS_PUBLISH_INTERVAL_MS >= 1000 && METRICS_PUBLISH_INTERVAL_MS <= 1200000UL,
+              "METRICS_PUBLISH_INTERVAL_MS must be 1 s to 20 min");
 
 void dropRedis(const __FlashStringHelper *context);
+unsigned long refreshInterval(unsigned long pollMs);
 
 #if SENDER_DISPLAY_ENABLED
 constexpr uint8_t kDisplayWidth = SENDER_DISPLAY_WIDTH;
@@ -201,7 +240,7 @@ bool displayReady = false;
 unsigned long lastDisplayRefreshMs = 0;
 constexpr unsigned long kWarningOverlayDurationMs = SOUND_WARNING_DISPLAY_MS;
 constexpr unsigned long kWarningRefreshIntervalMs = 2000;
-constexpr size_t kWarningJsonCapacity = 320;
+constexpr size_t kWarningJsonCapacity = 384;
 constexpr uint32_t kWarningFreshWindowSec = 90;
 constexpr unsigned long kWarningTimeGateMs = 8000;
 
@@ -218,6 +257,67 @@ struct DisplayPayload {
 };
 
 DisplayPayload lastDisplayPayload{};
+/** Set when the next render must redraw and send the whole frame (boot, overlay swap). */
+bool displayFullRedraw = true;
+
+/** One text line of the status screen; the built-in font is 6×8 px per char at size 1. */
+struct DisplayLine {
+  uint8_t y;
+  uint8_t size;
+};
+constexpr DisplayLine kClockLine{0, 2};
+constexpr DisplayLine kQuietLabelLine{32, 1};
+constexpr DisplayLine kQuietRangeLine{46, 1};
+constexpr DisplayLine kWarningLine{26, 1};
+constexpr uint8_t kDisplayPages = kDisplayHeight / 8;
+/** Data bytes per I²C transaction, after the 0x40 control byte (the ESP8266 Wire buffer). */
+constexpr uint8_t kDisplayI2cChunk = 31;
+
+/**
+ * Column span per 8-px page of the frame buffer that differs from what the panel shows.
+ * Only those spans are sent, so a minute tick costs a couple of glyphs instead of the
+ * full 1 KiB frame.
+ */
+struct DisplayDirty {
+  uint8_t firstCol[kDisplayPages];
+  uint8_t lastCol[kDisplayPages];
+
+  DisplayDirty() { clear(); }
+
+  void clear() {
+    memset(firstCol, 0xFF, sizeof(firstCol));
+    memset(lastCol, 0, sizeof(lastCol));
+  }
+
+  void markAll() { mark(0, kDisplayWidth - 1, 0, kDisplayHeight - 1); }
+
+  /** Marks the pixel rectangle [x0, x1] × [y0, y1]. */
+  void mark(int16_t x0, int16_t x1, int16_t y0, int16_t y1) {
+    if (x0 < 0) {
+      x0 = 0;
+    }
+    if (x1 >= kDisplayWidth) {
+      x1 = kDisplayWidth - 1;
+    }
+    if (y1 >= kDisplayHeight) {
+      y1 = kDisplayHeight - 1;
+    }
+    if (x0 > x1 || y0 < 0 || y0 > y1) {
+      return;
+    }
+    for (int16_t page = y0 / 8; page <= y1 / 8; ++page) {
+      if (x0 < firstCol[page]) {
+        firstCol[page] = static_cast<uint8_t>(x0);
+      }
+      if (x1 > lastCol[page]) {
+        lastCol[page] = static_cast<uint8_t>(x1);
+      }
+    }
+  }
+
+  bool pageDirty(uint8_t page) const { return firstCol[page] <= lastCol[page]; }
+};
+DisplayDirty displayDirty;
 /**
  * Latest quiet-hour sound warning published by the receiver.
  */
@@ -227,7 +327,7 @@ struct SoundWarningState {
 };
 SoundWarningState latestWarning;
 unsigned long warningOverlayUntilMs = 0;
-unsigned long lastWarningFetchMs = 0;
+bool warningChanged = false;
 unsigned long warningFetchGateStartMs = 0;
 bool warningFetchGateOpen = false;
 bool warningBootstrapPending = true;
@@ -235,7 +335,6 @@ String warningFetchJson;
 #endif
 
 HardwareSerial &consoleSerial = Serial;
-HardwareSerial &logSerial = Serial;
 
 /**
  * Simple exponential-ish backoff helper shared by Wi-Fi/Redis reconnection loops.
@@ -243,9 +342,19 @@ HardwareSerial &logSerial = Serial;
 struct Backoff {
   unsigned long nextMs = 0;
   uint8_t slot = 0;
+  // Metrics window: successful connects, failed attempts/drops, and time spent between
+  // the first failure and the connect that ended it.
+  uint16_t connects = 0;
+  uint16_t failures = 0;
+  uint32_t downMs = 0;
+  unsigned long downSinceMs = 0;
   bool ready(unsigned long now) const { return now >= nextMs; }
   void schedule(unsigned long now) {
     static const uint16_t kSteps[] = {250, 500, 1000, 2000};
+    if (!slot) {
+      downSinceMs = now;
+    }
+    ++failures;
     uint8_t idx = slot < 3 ? slot : 3;
     nextMs = now + kSteps[idx] + random(0, 200);
     if (slot < 3) {
@@ -256,6 +365,19 @@ struct Backoff {
     nextMs = 0;
     slot = 0;
   }
+  /** Records a successful connect, closing the outage that preceded it. */
+  void connected(unsigned long now) {
+    if (slot) {
+      downMs += now - downSinceMs;
+    }
+    ++connects;
+    reset();
+  }
+  void clearStats() {
+    connects = 0;
+    failures = 0;
+    downMs = 0;
+  }
 };
 
 WiFiClient redisClient;
@@ -263,18 +385,67 @@ RedisLink redis(redisClient);
 Backoff wifiBackoff;
 Backoff redisBackoff;
 
-String roomId;
-bool needsVersionSeed = true;
-uint32_t localVer = 0;
+// Second connection parked in SUBSCRIBE on the rooms' `evt:room:{id}` channels.
+WiFiClient eventClient;
+RedisLink events(eventClient);
+Backoff eventBackoff;
+bool eventsSubscribed = false;
+bool eventsResubscribe = false;
+unsigned long lastEventPingMs = 0;
+unsigned long lastEventRxMs = 0;
+
+/** What ended an idle stretch (see `idleUntilWork()`). */
+enum WakeReason : uint8_t { kWakeTimer, kWakeButton, kWakeSocket, kWakeConsole, kWakeReasons };
+
+/**
+ * One metrics window, written to the primary room's `room:{id}:metrics` field `sender`
+ * and reset every `METRICS_PUBLISH_INTERVAL_MS`.
+ */
+struct SenderMetrics {
+  metrics::LinkMetrics links;
+  metrics::Histogram loopUs;
+  metrics::LoopTimer loopTimer;
+  // Power mode: time spent idle (sleeping when SENDER_SLEEP_MODE allows), wakes by
+  // reason, and wake → publish batch written, for wakes that led to a publish.
+  uint32_t idleMs = 0;
+  uint16_t wakes[kWakeReasons] = {};
+  metrics::Histogram wakePublishMs;
+  /** Time spent sending one display update over I²C. */
+  metrics::Histogram displayUs;
+  unsigned long wakeMs = 0;
+  bool wakePending = false;
+  uint32_t minFreeHeap = UINT32_MAX;
+  uint16_t wifiConnects = 0;
+  uint32_t wifiBlockedMs = 0;
+  unsigned long windowStartMs = 0;
+};
+SenderMetrics senderMetrics;
+char metricsScratch[kMetricsJsonCapacity];
+
 String jsonScratch;
+contracts::CompactDesired compactScratch;
 String overrideJsonScratch;
-contracts::Desired lastDesired;
 bool overridePublishHint = false;
-bool desiredForcePublish = false;
+bool publishRetryHint = false;
 
 bool acquireLocalTime(tm &out);
 bool timeIsValid();
 
+/** Set by the button interrupt so an idle stretch ends on the press, not the next poll. */
+volatile bool overrideButtonEdge = false;
+/** True while the light-sleep GPIO wake (a level interrupt) replaces the CHANGE one. */
+volatile bool buttonWakeArmed = false;
+
+IRAM_ATTR void onOverrideButtonEdge() {
+  overrideButtonEdge = true;
+  if (buttonWakeArmed) {
+    // A level interrupt fires for as long as the button is held: mask it until
+    // `disarmButtonWake()` puts the edge interrupt back.
+    GPC(OVERRIDE_BUTTON_PIN) &= ~(0xF << GPCI);
+    buttonWakeArmed = false;
+  }
+}
+
 /**
  * Snapshot of the manual override hardware inputs (button + potentiometer).
  */
@@ -300,7 +471,109 @@ struct OverrideMirror {
 
 OverrideMirror overrideMirror;
 bool overrideDirty = false;
-unsigned long lastOverrideFetchMs = 0;
+
+/**
+ * Writes waiting for the next flush, at most one per key: a newer Desired for a room
+ * replaces the one still queued, and the override snapshot is encoded from the live
+ * state when it goes out. The first write into an empty queue starts the
+ * `SENDER_PUBLISH_COALESCE_MS` budget; once it lapses (or the batch is full) everything
+ * is written in one pipeline, so a potentiometer sweep costs a handful of stream entries.
+ * Versions are assigned at flush time, so superseded updates never consume one.
+ */
+struct OutboundQueue {
+  uint8_t slots[kPublishBatchMax];
+  contracts::Desired desired[kPublishBatchMax];
+  uint8_t count = 0;
+  bool overridePending = false;
+  unsigned long openedMs = 0;
+  /** Updates replaced (or withdrawn) before they were written, this metrics window. */
+  uint32_t superseded = 0;
+
+  bool empty() const { return !count && !overridePending; }
+  bool full() const { return count >= kPublishBatchMax; }
+
+  /** Queues `next` for room `slot`; false when the batch is full and `slot` not in it. */
+  bool queueDesired(uint8_t slot, const contracts::Desired &next, unsigned long now) {
+    for (uint8_t i = 0; i < count; ++i) {
+      if (slots[i] == slot) {
+        if (!contracts::sameDesired(desired[i], next)) {
+          desired[i] = next;
+          ++superseded;
+        }
+        return true;
+      }
+    }
+    if (full()) {
+      return false;
+    }
+    open(now);
+    slots[count] = slot;
+    desired[count] = next;
+    ++count;
+    return true;
+  }
+
+  /** Withdraws a queued update whose room is back at the value last written. */
+  void dropDesired(uint8_t slot) {
+    if (erase(slot)) {
+      ++superseded;
+    }
+  }
+
+  /** Discards room `slot`'s queued update after its slot was reset (not a supersede). */
+  void discard(uint8_t slot) { erase(slot); }
+
+  /** Forgets room `slot` after it left the room table; later slots move down by one. */
+  void removeSlot(uint8_t slot) {
+    erase(slot);
+    for (uint8_t i = 0; i < count; ++i) {
+      if (slots[i] > slot) {
+        --slots[i];
+      }
+    }
+  }
+
+  void queueOverride(unsigned long now) {
+    if (!overridePending) {
+      open(now);
+      overridePending = true;
+    }
+  }
+
+  bool due(unsigned long now) const {
+    return !empty() && (full() || (now - openedMs) >= kPublishCoalesceMs);
+  }
+
+  void clear() {
+    count = 0;
+    overridePending = false;
+  }
+
+ private:
+  void open(unsigned long now) {
+    if (empty()) {
+      openedMs = now;
+    }
+  }
+
+  bool erase(uint8_t slot) {
+    for (uint8_t i = 0; i < count; ++i) {
+      if (slots[i] != slot) {
+        continue;
+      }
+      for (uint8_t j = i; j + 1 < count; ++j) {
+        slots[j] = slots[j + 1];
+        desired[j] = desired[j + 1];
+      }
+      --count;
+      return true;
+    }
+    return false;
+  }
+};
+
+OutboundQueue outbound;
+bool overrideChanged = false;
 enum class StatusLedMode { Off, Solid, Blink };
 StatusLedMode statusLedMode = StatusLedMode::Off;
 bool statusLedBlinkState = true;
@@ -308,27 +581,37 @@ int8_t statusLedAppliedState = -1;
 unsigned long statusLedLastToggleMs = 0;
 
 /**
- * Cached quiet-hours schedule pulled from Redis.
+ * Per-room scheduling state. Slot 0 is the room bound to the console/override panel and
+ * the display; the remaining slots are schedule-only rooms sharing the same connection.
  */
-struct RoomSchedule {
-  bool wakeEnabled = true;
-  uint16_t wakeStartMin = static_cast<uint16_t>(SCHEDULE_DEFAULT_WAKE_HOUR * 60 +
-                                                SCHEDULE_DEFAULT_WAKE_MINUTE);
-  uint16_t wakeDurationMin = SCHEDULE_DEFAULT_WAKE_DURATION_MIN;
-  uint8_t wakePeakBrightness = SCHEDULE_DEFAULT_WAKE_BRIGHTNESS;
-  bool nightEnabled = true;
-  uint16_t nightStartMin = static_cast<uint16_t>(SCHEDULE_DEFAULT_NIGHT_HOUR * 60 +
-                                                 SCHEDULE_DEFAULT_NIGHT_MINUTE);
-  uint8_t nightBrightness = SCHEDULE_DEFAULT_NIGHT_BRIGHTNESS;
-  uint8_t baselineBrightness = SCHEDULE_DEFAULT_BASELINE_BRIGHTNESS;
-  uint32_t version = 0;
+struct RoomSlot {
+  String roomId;
+  /** Keys of `roomId`, rebuilt only when the id changes (see `setSlotRoom`). */
+  contracts::RoomKeys keys;
+  RoomSchedule schedule;
+  bool scheduleLoaded = false;
+  unsigned long lastScheduleFetchMs = 0;
+  bool cfgChanged = false;
+  bool needsVersionSeed = true;
+  uint32_t localVer = 0;
+  uint8_t wireFormat = contracts::kWireJson;
+  contracts::Desired lastDesired;
+  bool forcePublish = false;
+  // Breakpoint table built from `schedule` on every reload, and the epoch before which
+  // the scheduled output cannot change (0 = evaluate on the next tick).
+  CompiledSchedule compiled;
+  time_t nextChangeEpoch = 0;
 };
 
-RoomSchedule scheduleCfg;
-bool scheduleLoaded = false;
-unsigned long lastScheduleFetchMs = 0;
+RoomSlot roomSlots[kMaxRooms];
+RoomSlot &primaryRoom = roomSlots[0];
+uint8_t roomSlotCount = 1;
+uint8_t publishCursor = 0;
+uint8_t scheduleCursor = 0;
 unsigned long lastSchedulePublishMs = 0;
 unsigned long lastRoomPromptMs = 0;
+/** Activity and latency pace for the adaptive poll intervals (see scheduler.hpp). */
+sched::Cadence cadence;
 bool timeConfigured = false;
 bool timeAnnounced = false;
 unsigned long lastTimeSyncAttemptMs = 0;
@@ -392,34 +675,115 @@ bool payloadChanged(const DisplayPayload &a, const DisplayPayload &b) {
 }
 
 /**
- * Draws either the warning overlay or the quiet-hours summary on the SSD1306.
+ * Redraws `line` from `prev` to `next` in the frame buffer. Only the character cells
+ * between the first and last difference are cleared and marked dirty; the whole string is
+ * drawn again so the untouched cells come out identical. `prev` is "" for a fresh frame.
+ */
+void drawDisplayLine(const DisplayLine &line, const char *prev, const char *next) {
+  size_t prevLen = strlen(prev);
+  size_t nextLen = strlen(next);
+  size_t first = 0;
+  while (first < prevLen && first < nextLen && prev[first] == next[first]) {
+    ++first;
+  }
+  size_t prevEnd = prevLen;
+  size_t nextEnd = nextLen;
+  if (prevLen == nextLen) {
+    while (prevEnd > first && prev[prevEnd - 1] == next[nextEnd - 1]) {
+      --prevEnd;
+      --nextEnd;
+    }
+  }
+  size_t end = prevEnd > nextEnd ? prevEnd : nextEnd;
+  if (end <= first) {
+    return;
+  }
+  const int16_t charWidth = 6 * line.size;
+  const int16_t lineHeight = 8 * line.size;
+  int16_t x0 = static_cast<int16_t>(first * charWidth);
+  int16_t x1 = static_cast<int16_t>(end * charWidth) - 1;
+  senderDisplay.fillRect(x0, line.y, x1 - x0 + 1, lineHeight, SSD1306_BLACK);
+  senderDisplay.setTextSize(line.size);
+  senderDisplay.setCursor(0, line.y);
+  senderDisplay.print(next);
+  displayDirty.mark(x0, x1, line.y, line.y + lineHeight - 1);
+}
+
+/**
+ * Sends the dirty column spans to the panel, one page at a time: the page/column window
+ * is set with `PAGEADDR`/`COLUMNADDR`, then the bytes follow in horizontal addressing
+ * mode, exactly as the library's full-frame `display()` does for the whole buffer.
+ */
+void flushDisplayDirty() {
+  const uint32_t startUs = micros();
+  const uint8_t *buffer = senderDisplay.getBuffer();
+  bool sent = false;
+  for (uint8_t page = 0; page < kDisplayPages; ++page) {
+    if (!displayDirty.pageDirty(page)) {
+      continue;
+    }
+    const uint8_t first = displayDirty.firstCol[page];
+    const uint8_t last = displayDirty.lastCol[page];
+    senderDisplay.ssd1306_command(SSD1306_PAGEADDR);
+    senderDisplay.ssd1306_command(page);
+    senderDisplay.ssd1306_command(page);
+    senderDisplay.ssd1306_command(SSD1306_COLUMNADDR);
+    senderDisplay.ssd1306_command(first);
+    senderDisplay.ssd1306_command(last);
+    const uint8_t *bytes = buffer + static_cast<size_t>(page) * kDisplayWidth + first;
+    for (uint16_t remaining = last - first + 1; remaining;) {
+      uint8_t chunk = remaining < kDisplayI2cChunk ? remaining : kDisplayI2cChunk;
+      Wire.beginTransmission(kDisplayI2cAddress);
+      Wire.write(static_cast<uint8_t>(0x40));  // Co = 0, D/C = 1: display data follows
+      for (uint8_t i = 0; i < chunk; ++i) {
+        Wire.write(*bytes++);
+      }
+      Wire.endTransmission();
+      remaining -= chunk;
+    }
+    sent = true;
+  }
+  displayDirty.clear();
+  if (sent) {
+    senderMetrics.displayUs.record(micros() - startUs);
+  }
+}
+
+/**
+ * Draws either the warning overlay or the quiet-hours summary on the SSD1306. Switching
+ * between the two (or the first frame) repaints everything; otherwise only the text that
+ * changed since `previous` is redrawn and sent (see `flushDisplayDirty()`).
  */
-void renderDisplay(const DisplayPayload &payload) {
+void renderDisplay(const DisplayPayload &payload, const DisplayPayload &previous) {
   if (!displayReady) {
     return;
   }
-  if (payload.warningActive) {
+  const bool full = displayFullRedraw || payload.warningActive != previous.warningActive;
+  senderDisplay.setTextColor(SSD1306_WHITE);
+  if (full) {
     senderDisplay.clearDisplay();
-    senderDisplay.setTextColor(SSD1306_WHITE);
-    senderDisplay.setTextSize(1);
-    senderDisplay.setCursor(0, 26);
-    senderDisplay.println(F("Sound Levels Exceeded"));
-    senderDisplay.display();
+    displayDirty.markAll();
+    displayFullRedraw = false;
+  }
+  if (payload.warningActive) {
+    if (full) {
+      drawDisplayLine(kWarningLine, "", "Sound Levels Exceeded");
+    }
+    flushDisplayDirty();
     return;
   }
-  senderDisplay.clearDisplay();
-  senderDisplay.setTextColor(SSD1306_WHITE);
-  senderDisplay.setTextSize(2);
-  senderDisplay.setCursor(0, 0);
-  senderDisplay.println(payload.current);
-  senderDisplay.setTextSize(1);
-  senderDisplay.setCursor(0, 32);
-  senderDisplay.println(F("Quiet Hours:"));
-  senderDisplay.setCursor(0, 46);
+  drawDisplayLine(kClockLine, full ? "" : previous.current, payload.current);
+  if (full) {
+    drawDisplayLine(kQuietLabelLine, "", "Quiet Hours:");
+  }
   char range[32];
+  char previousRange[32] = "";
   std::snprintf(range, sizeof(range), "%s - %s", payload.quietStart, payload.quietEnd);
-  senderDisplay.println(range);
-  senderDisplay.display();
+  if (!full) {
+    std::snprintf(previousRange, sizeof(previousRange), "%s - %s", previous.quietStart, previous.quietEnd);
+  }
+  drawDisplayLine(kQuietRangeLine, previousRange, range);
+  flushDisplayDirty();
 }
 
 /**
@@ -440,10 +804,11 @@ void composeDisplayPayload(DisplayPayload &payload) {
   } else {
     writeTimePlaceholder(payload.current, sizeof(payload.current));
   }
-  payload.quietEnabled = scheduleCfg.nightEnabled && scheduleCfg.wakeEnabled;
+  const RoomSchedule &schedule = primaryRoom.schedule;
+  payload.quietEnabled = schedule.nightEnabled && schedule.wakeEnabled;
   if (payload.quietEnabled) {
-    formatMinutes12(scheduleCfg.nightStartMin, payload.quietStart, sizeof(payload.quietStart));
-    formatMinutes12(scheduleCfg.wakeStartMin, payload.quietEnd, sizeof(payload.quietEnd));
+    formatMinutes12(schedule.nightStartMin, payload.quietStart, sizeof(payload.quietStart));
+    formatMinutes12(schedule.wakeStartMin, payload.quietEnd, sizeof(payload.quietEnd));
   } else {
     writeTimePlaceholder(payload.quietStart, sizeof(payload.quietStart));
     writeTimePlaceholder(payload.quietEnd, sizeof(payload.quietEnd));
@@ -459,7 +824,7 @@ void initDisplayHardware() {
   }
   Wire.begin(kDisplaySdaPin, kDisplaySclPin);
   if (!senderDisplay.begin(SSD1306_SWITCHCAPVCC, kDisplayI2cAddress)) {
-    logSerial.println(F("[display] init failed"));
+    LOG_ERROR("[display] init failed");
     return;
   }
   senderDisplay.clearDisplay();
@@ -469,6 +834,7 @@ void initDisplayHardware() {
   senderDisplay.println(F("Booting..."));
   senderDisplay.display();
   displayReady = true;
+  displayFullRedraw = true;
   lastDisplayPayload = DisplayPayload();
 }
 
@@ -488,7 +854,7 @@ void maybeUpdateDisplay(unsigned long now) {
   if (!payloadChanged(payload, lastDisplayPayload)) {
     return;
   }
-  renderDisplay(payload);
+  renderDisplay(payload, lastDisplayPayload);
   lastDisplayPayload = payload;
 }
 
@@ -499,8 +865,7 @@ bool decodeWarningJson(const String &payload, SoundWarningState &out) {
   StaticJsonDocument<kWarningJsonCapacity> doc;
   DeserializationError err = deserializeJson(doc, payload);
   if (err) {
-    logSerial.print(F("[display] warning parse failed: "));
-    logSerial.println(err.c_str());
+    LOG_WARN("[display] warning parse failed: %s", err.c_str());
     return false;
   }
   uint32_t captured = doc["captured_at"] | 0;
@@ -529,11 +894,12 @@ bool warningIsFresh(const SoundWarningState &state) {
 }
 
 /**
- * Polls Redis for the latest sound warning and toggles the display overlay.
+ * Warning task: fetches the latest sound warning on `warning` events (or when
+ * `warningPollIntervalMs()` lapses) and toggles the display overlay.
  */
-void maybeFetchLatestWarning(unsigned long now) {
-  if (!roomId.length() || !redis.connected()) {
-    return;
+bool pollLatestWarning(unsigned long now) {
+  if (!primaryRoom.roomId.length() || !redis.connected()) {
+    return true;
   }
   if (!warningFetchGateOpen) {
     if (warningFetchGateStartMs == 0) {
@@ -543,44 +909,42 @@ void maybeFetchLatestWarning(unsigned long now) {
     if (timeReady || (now - warningFetchGateStartMs) >= kWarningTimeGateMs) {
       warningFetchGateOpen = true;
     } else {
-      return;
+      return true;
     }
   }
-  if ((now - lastWarningFetchMs) < kWarningRefreshIntervalMs) {
-    return;
-  }
-  lastWarningFetchMs = now;
+  warningChanged = false;
   bool isNull = false;
-  if (!redis.get(contracts::key_latest_warning(roomId), warningFetchJson, &isNull)) {
+  if (!redis.get(primaryRoom.keys.latestWarning, warningFetchJson, &isNull)) {
     dropRedis(F("get warning"));
-    return;
+    return false;
   }
   if (isNull || !warningFetchJson.length()) {
     if (warningBootstrapPending) {
       warningBootstrapPending = false;
     }
-    return;
+    return true;
   }
   SoundWarningState next;
   if (!decodeWarningJson(warningFetchJson, next)) {
-    return;
+    return true;
   }
   if (next.capturedAt <= latestWarning.capturedAt) {
-    return;
+    return true;
   }
   bool fresh = warningIsFresh(next);
   latestWarning = next;
   if (warningBootstrapPending && !fresh) {
     warningBootstrapPending = false;
-    return;
+    return true;
   }
   warningBootstrapPending = false;
   if (!fresh) {
-    return;
+    return true;
   }
   warningOverlayUntilMs = now + kWarningOverlayDurationMs;
-  logSerial.printf("[display] sound warning %.1f dB\n", latestWarning.decibels);
+  LOG_INFO("[display] sound warning %.1f dB", latestWarning.decibels);
   lastDisplayRefreshMs = 0;
+  return true;
 }
 #endif
 
@@ -588,22 +952,11 @@ char consoleBuffer[kConsoleMaxBytes]{};
 size_t consoleLen = 0;
 unsigned long consoleLastByteMs = 0;
 
-/**
- * Convenience wrapper for emitting tagged log lines.
- */
-void log(const __FlashStringHelper *msg) {
-  logSerial.print(F("[sender] "));
-  logSerial.println(msg);
-}
-
 /**
  * Prints the most recent Redis protocol error with some context.
  */
 void logRedisFailure(const __FlashStringHelper *where) {
-  logSerial.print(F("[redis] "));
-  logSerial.print(where);
-  logSerial.print(F(": "));
-  logSerial.println(redis.lastError());
+  LOG_WARN("[redis] %S: %s", where, redis.lastError().c_str());
 }
 
 /**
@@ -657,22 +1010,33 @@ void updateStatusLed(unsigned long now) {
   }
 }
 
+/** Clears one room's cached schedule and version seed so it resyncs from Redis. */
+void resetRoomSlot(RoomSlot &slot) {
+  slot.localVer = 0;
+  slot.needsVersionSeed = true;
+  slot.wireFormat = contracts::kWireJson;
+  slot.scheduleLoaded = false;
+  slot.lastScheduleFetchMs = 0;
+  slot.forcePublish = false;
+  slot.nextChangeEpoch = 0;
+}
+
 /**
- * Clears cached schedule/override state so the next Redis sync starts fresh.
+ * Clears cached schedule/override state of the primary room so the next Redis sync
+ * starts fresh. Writes queued for the extra rooms stay queued.
  */
 void resetState() {
-  localVer = 0;
-  needsVersionSeed = true;
-  scheduleLoaded = false;
-  lastScheduleFetchMs = 0;
+  resetRoomSlot(primaryRoom);
   lastSchedulePublishMs = 0;
   overrideMirror = OverrideMirror();
   overrideDirty = false;
-  lastOverrideFetchMs = 0;
+  outbound.discard(0);
+  outbound.overridePending = false;
+  overrideChanged = true;
 #if SENDER_DISPLAY_ENABLED
   latestWarning = SoundWarningState();
   warningOverlayUntilMs = 0;
-  lastWarningFetchMs = 0;
+  warningChanged = true;
   warningFetchGateStartMs = 0;
   warningFetchGateOpen = false;
   warningBootstrapPending = true;
@@ -686,35 +1050,38 @@ void dropRedis(const __FlashStringHelper *context) {
   logRedisFailure(context);
   redis.stop();
   resetState();
+  for (uint8_t i = 1; i < roomSlotCount; ++i) {
+    resetRoomSlot(roomSlots[i]);
+  }
+  outbound.clear();
 }
 
 /**
  * Performs a blocking Wi-Fi connect loop until STA mode is online.
  */
 void connectWifiBlocking() {
-  logSerial.print(F("[wifi] connecting to "));
-  logSerial.println(WIFI_SSID);
+  LOG_INFO("[wifi] connecting to %s", WIFI_SSID);
   WiFi.mode(WIFI_STA);
   WiFi.persistent(false);
   WiFi.disconnect(true);
   delay(200);
   WiFi.begin(WIFI_SSID, WIFI_PASS);
   unsigned long start = millis();
+  const unsigned long blockedSinceMs = start;
   while (WiFi.status() != WL_CONNECTED) {
-    logSerial.print(F("[wifi] status="));
-    logSerial.println(static_cast<int>(WiFi.status()));
+    LOG_DEBUG("[wifi] status=%d", static_cast<int>(WiFi.status()));
+    logging::pump();
     delay(500);
     if ((millis() - start) > 20000) {
-      logSerial.println(F("[wifi] retrying connection"));
+      LOG_WARN("[wifi] retrying connection");
       WiFi.disconnect(false);
       WiFi.begin(WIFI_SSID, WIFI_PASS);
       start = millis();
     }
   }
-  logSerial.print(F("[wifi] connected ip="));
-  logSerial.print(WiFi.localIP());
-  logSerial.print(F(" rssi="));
-  logSerial.println(WiFi.RSSI());
+  ++senderMetrics.wifiConnects;
+  senderMetrics.wifiBlockedMs += millis() - blockedSinceMs;
+  LOG_INFO("[wifi] connected ip=%s rssi=%d", WiFi.localIP().toString().c_str(), static_cast<int>(WiFi.RSSI()));
 }
 
 /**
@@ -753,21 +1120,279 @@ bool ensureRedis() {
   }
   redis.setTimeout(kRedisTimeoutMs);
   redisClient.setNoDelay(true);
-  if (!redis.auth(REDIS_PASSWORD)) {
+  redis.beginPipeline();
+  redis.queueAuth(REDIS_PASSWORD);
+  redis.queuePing();
+  if (!redis.execPipeline()) {
     redisBackoff.schedule(now);
-    dropRedis(F("auth"));
+    dropRedis(F("auth/ping"));
     return false;
   }
-  if (!redis.ping()) {
-    redisBackoff.schedule(now);
-    dropRedis(F("ping"));
+  redisBackoff.connected(now);
+  for (uint8_t i = 0; i < roomSlotCount; ++i) {
+    roomSlots[i].needsVersionSeed = true;
+  }
+  return true;
+}
+
+/** True while the event subscription is up, so the periodic GETs can back off. */
+bool eventsLive() { return kEventsEnabled && eventsSubscribed && events.connected(); }
+
+/**
+ * Poll interval for a key that also has change events: `pollMs` at the current pace,
+ * stretched to the fallback interval while the events are live.
+ */
+unsigned long refreshInterval(unsigned long pollMs) {
+  pollMs = cadence.scale(pollMs);
+  return eventsLive() && kEventFallbackRefreshMs > pollMs ? kEventFallbackRefreshMs : pollMs;
+}
+
+unsigned long overridePollIntervalMs() { return refreshInterval(kOverrideRefreshIntervalMs); }
+#if SENDER_DISPLAY_ENABLED
+unsigned long warningPollIntervalMs() { return refreshInterval(kWarningRefreshIntervalMs); }
+#endif
+
+/** Marks every cached key stale; used whenever notifications may have been missed. */
+void markEventKeysChanged() {
+  for (uint8_t i = 0; i < roomSlotCount; ++i) {
+    roomSlots[i].cfgChanged = true;
+  }
+  overrideChanged = true;
+#if SENDER_DISPLAY_ENABLED
+  warningChanged = true;
+#endif
+}
+
+/** Closes the event link and falls back to polling until it is re-established. */
+void dropEvents(const __FlashStringHelper *context) {
+  LOG_WARN("[events] %S: %s", context, events.lastError().c_str());
+  events.stop();
+  eventClient.stop();
+  eventsSubscribed = false;
+  eventBackoff.schedule(millis());
+}
+
+/** Subscribes to `evt:room:{id}` for every room slot, a bounded batch at a time. */
+bool subscribeRoomEvents() {
+  RedisLink::KeyView channels[RedisLink::kMaxSubscribeChannels];
+  uint8_t batched = 0;
+  for (uint8_t i = 0; i < roomSlotCount; ++i) {
+    if (!roomSlots[i].roomId.length()) {
+      continue;
+    }
+    channels[batched++] = roomSlots[i].keys.events;
+    if (batched == RedisLink::kMaxSubscribeChannels) {
+      if (!events.subscribe(channels, batched)) {
+        return false;
+      }
+      batched = 0;
+    }
+  }
+  return !batched || events.subscribe(channels, batched);
+}
+
+/**
+ * Keeps the event subscription open next to the command link. Every (re)subscribe marks
+ * all cached keys stale because notifications sent while unsubscribed are lost.
+ */
+void ensureEvents(unsigned long now) {
+  if (!kEventsEnabled) {
+    return;
+  }
+  if (eventsResubscribe) {
+    eventsResubscribe = false;
+    if (eventsSubscribed) {
+      events.stop();
+      eventClient.stop();
+      eventsSubscribed = false;
+    }
+    eventBackoff.reset();
+  }
+  if (eventsSubscribed) {
+    if (events.connected()) {
+      return;
+    }
+    dropEvents(F("link lost, polling"));
+  }
+  if (!primaryRoom.roomId.length() || !eventBackoff.ready(now)) {
+    return;
+  }
+  events.stop();
+  if (!eventClient.connect(REDIS_HOST, REDIS_PORT)) {
+    eventBackoff.schedule(now);
+    return;
+  }
+  events.setTimeout(kRedisTimeoutMs);
+  if (!events.auth(REDIS_PASSWORD) || !subscribeRoomEvents()) {
+    dropEvents(F("subscribe"));
+    return;
+  }
+  eventsSubscribed = true;
+  eventBackoff.connected(now);
+  lastEventPingMs = now;
+  lastEventRxMs = now;
+  markEventKeysChanged();
+  LOG_INFO("[events] subscribed rooms=%u", static_cast<unsigned>(roomSlotCount));
+}
+
+/** Routes one `evt:room:{id}` message to the matching cached key. */
+void handleRoomEvent(const char *channel, const char *name) {
+  static const char kPrefix[] = "evt:room:";
+  if (strncmp(channel, kPrefix, sizeof(kPrefix) - 1) != 0) {
+    return;
+  }
+  const char *rid = channel + sizeof(kPrefix) - 1;
+  for (uint8_t i = 0; i < roomSlotCount; ++i) {
+    if (roomSlots[i].roomId != rid) {
+      continue;
+    }
+    if (strcmp(name, contracts::kEventCfg) == 0) {
+      roomSlots[i].cfgChanged = true;
+    } else if (i == 0 && strcmp(name, contracts::kEventOverride) == 0) {
+      overrideChanged = true;
+#if SENDER_DISPLAY_ENABLED
+    } else if (i == 0 && strcmp(name, contracts::kEventWarning) == 0) {
+      warningChanged = true;
+#endif
+    }
+    return;
+  }
+}
+
+/**
+ * Drains pending event messages without blocking and keeps the link honest with a
+ * periodic pub/sub PING; a link that stops answering is dropped back to polling.
+ */
+void pumpEvents(unsigned long now) {
+  if (!eventsSubscribed) {
+    return;
+  }
+  for (uint8_t i = 0; i < kEventsPerLoop; ++i) {
+    char channel[48];
+    char name[contracts::kEventNameCapacity];
+    RedisLink::PollResult result = events.pollMessage(channel, sizeof(channel), name, sizeof(name));
+    if (result == RedisLink::PollResult::Failed) {
+      dropEvents(F("poll"));
+      return;
+    }
+    if (result == RedisLink::PollResult::Idle) {
+      break;
+    }
+    lastEventRxMs = now;
+    if (result == RedisLink::PollResult::Message) {
+      handleRoomEvent(channel, name);
+    }
+  }
+  if ((now - lastEventPingMs) >= kEventPingIntervalMs) {
+    lastEventPingMs = now;
+    if (!events.subscriberPing()) {
+      dropEvents(F("ping"));
+      return;
+    }
+  }
+  if ((now - lastEventRxMs) > 2 * kEventPingIntervalMs + kRedisTimeoutMs) {
+    dropEvents(F("no pong"));
+  }
+}
+
+/**
+ * Binds `slot` to room `rid` and builds its keys. Ids longer than
+ * `contracts::kRoomIdMaxLen` are refused and leave the slot unchanged.
+ */
+bool setSlotRoom(RoomSlot &slot, const String &rid) {
+  contracts::RoomKeys keys;
+  if (!keys.assign(rid)) {
+    LOG_WARN("[sender] room id '%s' is longer than %u characters", rid.c_str(),
+             static_cast<unsigned>(contracts::kRoomIdMaxLen));
     return false;
   }
-  redisBackoff.reset();
-  needsVersionSeed = true;
+  slot.roomId = rid;
+  slot.keys = keys;
   return true;
 }
 
+/** Unbinds `slot` from its room. */
+void clearSlotRoom(RoomSlot &slot) {
+  slot.roomId.remove(0);
+  slot.keys.clear();
+}
+
+/** Drops `rid` from the schedule-only slots (it became the primary room). */
+void removeExtraRoom(const String &rid) {
+  for (uint8_t i = 1; i < roomSlotCount; ++i) {
+    if (roomSlots[i].roomId != rid) {
+      continue;
+    }
+    for (uint8_t j = i; j + 1 < roomSlotCount; ++j) {
+      roomSlots[j] = roomSlots[j + 1];
+    }
+    --roomSlotCount;
+    clearSlotRoom(roomSlots[roomSlotCount]);
+    outbound.removeSlot(i);
+    publishCursor = 0;
+    scheduleCursor = 0;
+    return;
+  }
+}
+
+/** Logs the room table (`ROOMS?`). */
+void logRoomSlots() {
+#if LOG_ENABLED(INFO)
+  String ids;
+  for (uint8_t i = 0; i < roomSlotCount; ++i) {
+    ids += ' ';
+    ids += roomSlots[i].roomId.length() ? roomSlots[i].roomId.c_str() : "-";
+  }
+  LOG_INFO("[sender] rooms (%u/%u):%s", static_cast<unsigned>(roomSlotCount), static_cast<unsigned>(kMaxRooms),
+           ids.c_str());
+#endif
+}
+
+/**
+ * Replaces the schedule-only rooms with the comma-separated ids in `list`. Ids that
+ * repeat (or match the primary room) are skipped; ids beyond `SENDER_MAX_ROOMS` are
+ * dropped with a warning.
+ */
+void assignExtraRooms(const char *list) {
+  for (uint8_t i = 1; i < roomSlotCount; ++i) {
+    clearSlotRoom(roomSlots[i]);
+    roomSlots[i].lastDesired = contracts::Desired();
+    resetRoomSlot(roomSlots[i]);
+  }
+  for (uint8_t i = roomSlotCount; i > 1; --i) {
+    outbound.removeSlot(i - 1);
+  }
+  roomSlotCount = 1;
+  publishCursor = 0;
+  scheduleCursor = 0;
+  const char *p = list;
+  while (p && *p) {
+    const char *end = strchr(p, ',');
+    size_t len = end ? static_cast<size_t>(end - p) : strlen(p);
+    char idBuf[contracts::kRoomIdMaxLen + 1];
+    if (len < sizeof(idBuf)) {
+      memcpy(idBuf, p, len);
+      idBuf[len] = '\0';
+      String rid = idBuf;
+      rid.trim();
+      bool duplicate = !rid.length() || rid == primaryRoom.roomId;
+      for (uint8_t i = 1; i < roomSlotCount && !duplicate; ++i) {
+        duplicate = roomSlots[i].roomId == rid;
+      }
+      if (!duplicate) {
+        if (roomSlotCount >= kMaxRooms) {
+          LOG_WARN("[sender] room table full, ignoring %s", rid.c_str());
+        } else if (setSlotRoom(roomSlots[roomSlotCount], rid)) {
+          ++roomSlotCount;
+        }
+      }
+    }
+    p = end ? end + 1 : nullptr;
+  }
+  eventsResubscribe = true;
+  logRoomSlots();
+}
+
 /**
  * Accepts `ROOM:<id>` console input and resets local state when the id changes.
  */
@@ -777,27 +1402,17 @@ void handleRoomAnnouncement(const char *payload) {
   if (!rid.length()) {
     return;
   }
-  if (rid != roomId) {
-    logSerial.print(F("[sender] room -> "));
-    logSerial.println(rid);
-    roomId = rid;
+  if (rid != primaryRoom.roomId) {
+    if (!setSlotRoom(primaryRoom, rid)) {
+      return;
+    }
+    LOG_INFO("[sender] room -> %s", rid.c_str());
     resetState();
+    removeExtraRoom(rid);
+    eventsResubscribe = true;
   }
 }
 
-/**
- * Constrains integer percentages to the 0-100 range.
- */
-uint8_t clampPercent(int value) {
-  if (value < 0) {
-    return 0;
-  }
-  if (value > 100) {
-    return 100;
-  }
-  return static_cast<uint8_t>(value);
-}
-
 /**
  * Converts hour/minute pairs into minutes since midnight (clamped).
  */
@@ -840,11 +1455,8 @@ bool overrideButtonPressedLevel(int level) {
 
 /** Prints the override enable state + brightness for debugging. */
 void logOverrideState() {
-  logSerial.print(F("[override] "));
-  logSerial.print(overrideState.enabled ? F("enabled ") : F("disabled "));
-  logSerial.print(F("brightness="));
-  logSerial.print(overrideState.brightness);
-  logSerial.println('%');
+  LOG_DEBUG("[override] %s brightness=%u%%", overrideState.enabled ? "enabled" : "disabled",
+            static_cast<unsigned>(overrideState.brightness));
 }
 
 /**
@@ -871,7 +1483,7 @@ void setOverrideEnabled(bool enabled, bool syncToRedis = true) {
     return;
   }
   overrideState.enabled = enabled;
-  desiredForcePublish = true;
+  primaryRoom.forcePublish = true;
   if (syncToRedis) {
     overrideDirty = true;
   }
@@ -932,6 +1544,9 @@ void initOverrideHardware() {
   overrideState.buttonLastChangeMs = millis();
   overrideState.lastAnalogRaw = analogRead(OVERRIDE_POT_PIN);
   overrideState.brightness = analogToPercent(overrideState.lastAnalogRaw);
+  if (kSleepMode) {
+    attachInterrupt(digitalPinToInterrupt(OVERRIDE_BUTTON_PIN), onOverrideButtonEdge, CHANGE);
+  }
   logOverrideState();
 }
 
@@ -984,50 +1599,52 @@ uint32_t overrideTimestamp() {
 }
 
 /**
- * Periodically refreshes the override snapshot from Redis and applies remote toggles.
+ * Override task: refreshes the override snapshot from Redis on `override` events (or
+ * when `overridePollIntervalMs()` lapses) and applies remote toggles.
  */
-void maybeFetchOverrideState(unsigned long now) {
-  if (!roomId.length() || !redis.connected()) {
-    return;
-  }
-  if ((now - lastOverrideFetchMs) < kOverrideRefreshIntervalMs) {
-    return;
+bool pollOverrideState(unsigned long) {
+  if (!primaryRoom.roomId.length() || !redis.connected()) {
+    return true;
   }
   bool isNull = false;
   String payload;
-  if (!redis.get(contracts::key_override(roomId), payload, &isNull)) {
+  if (!redis.get(primaryRoom.keys.override_, payload, &isNull)) {
     dropRedis(F("override get"));
-    return;
+    return false;
   }
-  lastOverrideFetchMs = now;
+  overrideChanged = false;
   if (isNull || !payload.length()) {
-    return;
+    return true;
   }
   bool enabled = false;
   uint32_t version = 0;
   if (!decodeOverrideJson(payload, enabled, version)) {
-    logSerial.println(F("[override] ignored invalid payload"));
-    return;
+    LOG_WARN("[override] ignored invalid payload");
+    return true;
   }
   if (!overrideMirror.known || version > overrideMirror.version) {
     overrideMirror.known = true;
     overrideMirror.version = version;
     overrideMirror.enabled = enabled;
     setOverrideEnabled(enabled, false);
-    logSerial.print(F("[override] remote -> "));
-    logSerial.print(enabled ? F("enabled") : F("disabled"));
-    logSerial.print(F(" v="));
-    logSerial.println(version);
+    LOG_INFO("[override] remote -> %s v=%lu", enabled ? "enabled" : "disabled", static_cast<unsigned long>(version));
   }
+  return true;
 }
 
-/**
- * Writes the latest override snapshot to Redis whenever we have local changes.
- */
-void maybePublishOverrideState() {
-  if (!overrideDirty || !roomId.length() || !redis.connected()) {
+/** Queues the override snapshot for the next flush whenever we have local changes. */
+void maybeQueueOverrideState(unsigned long now) {
+  if (!overrideDirty || !primaryRoom.roomId.length()) {
     return;
   }
+  outbound.queueOverride(now);
+}
+
+/**
+ * Encodes the live override state as the next `room:{id}:override` snapshot into
+ * `overrideJsonScratch`; returns its version, or 0 when encoding failed.
+ */
+uint32_t encodeOverrideSnapshot() {
   StaticJsonDocument<192> doc;
   doc["enabled"] = overrideState.enabled;
   uint32_t newVer = overrideMirror.known ? (overrideMirror.version + 1) : 1;
@@ -1038,21 +1655,19 @@ void maybePublishOverrideState() {
   size_t docSize = measureJson(doc);
   overrideJsonScratch.reserve(docSize + 8);
   if (serializeJson(doc, overrideJsonScratch) == 0) {
-    logSerial.println(F("[override] failed to encode json"));
-    return;
-  }
-  if (!redis.set(contracts::key_override(roomId), overrideJsonScratch)) {
-    dropRedis(F("set override"));
-    return;
+    LOG_ERROR("[override] failed to encode json");
+    return 0;
   }
+  return newVer;
+}
+
+/** Records a stored override snapshot so the next local change bumps past it. */
+void noteOverrideStored(uint32_t ver, bool enabled) {
   overrideMirror.known = true;
-  overrideMirror.version = newVer;
-  overrideMirror.enabled = overrideState.enabled;
+  overrideMirror.version = ver;
+  overrideMirror.enabled = enabled;
   overrideDirty = false;
-  logSerial.print(F("[override] stored "));
-  logSerial.print(overrideState.enabled ? F("enabled") : F("disabled"));
-  logSerial.print(F(" v="));
-  logSerial.println(newVer);
+  LOG_INFO("[override] stored %s v=%lu", enabled ? "enabled" : "disabled", static_cast<unsigned long>(ver));
 }
 
 /**
@@ -1102,69 +1717,54 @@ bool decodeScheduleJson(const String &json, RoomSchedule &out) {
 /**
  * Emits the current schedule configuration to the console for debugging.
  */
-void logScheduleSummary() {
-  logSerial.print(F("[schedule] baseline="));
-  logSerial.print(scheduleCfg.baselineBrightness);
-  logSerial.print(F("% wake["));
-  logSerial.print(scheduleCfg.wakeEnabled ? F("on") : F("off"));
-  logSerial.print(F("] "));
-  auto printClock = [&](uint16_t minutes) {
-    uint8_t hour = minutes / 60;
-    uint8_t minute = minutes % 60;
-    if (hour < 10) {
-      logSerial.print('0');
-    }
-    logSerial.print(hour);
-    logSerial.print(':');
-    if (minute < 10) {
-      logSerial.print('0');
-    }
-    logSerial.print(minute);
-  };
-  printClock(scheduleCfg.wakeStartMin);
-  logSerial.print(F(" +"));
-  logSerial.print(scheduleCfg.wakeDurationMin);
-  logSerial.print(F("m -> "));
-  logSerial.print(scheduleCfg.wakePeakBrightness);
-  logSerial.print(F("% night["));
-  logSerial.print(scheduleCfg.nightEnabled ? F("on") : F("off"));
-  logSerial.print(F("] "));
-  printClock(scheduleCfg.nightStartMin);
-  logSerial.print(F(" -> "));
-  logSerial.print(scheduleCfg.nightBrightness);
-  logSerial.print(F("% v="));
-  logSerial.println(scheduleCfg.version);
-}
-
-/**
- * Loads the latest quiet-hours/sunrise config for the current room.
- */
-bool fetchScheduleConfig() {
-  if (!roomId.length()) {
+void logScheduleSummary(const RoomSlot &slot) {
+  const RoomSchedule &cfg = slot.schedule;
+  LOG_INFO("[schedule] room=%s baseline=%u%% wake[%s] %02u:%02u +%um -> %u%% night[%s] %02u:%02u -> %u%% v=%lu "
+           "segments=%u",
+           slot.roomId.c_str(), cfg.baselineBrightness, cfg.wakeEnabled ? "on" : "off", cfg.wakeStartMin / 60,
+           cfg.wakeStartMin % 60, cfg.wakeDurationMin, cfg.wakePeakBrightness, cfg.nightEnabled ? "on" : "off",
+           cfg.nightStartMin / 60, cfg.nightStartMin % 60, cfg.nightBrightness,
+           static_cast<unsigned long>(cfg.version), slot.compiled.count);
+  (void)cfg;
+}
+
+/**
+ * Installs a freshly loaded schedule and rebuilds its breakpoint table.
+ */
+void applySchedule(RoomSlot &slot, const RoomSchedule &scheduleCfg) {
+  slot.schedule = scheduleCfg;
+  scheduling::compileSchedule(slot.schedule, slot.compiled);
+  slot.scheduleLoaded = true;
+  slot.nextChangeEpoch = 0;
+}
+
+/**
+ * Loads the latest quiet-hours/sunrise config for one room.
+ */
+bool fetchScheduleConfig(RoomSlot &slot) {
+  if (!slot.roomId.length()) {
     return false;
   }
   bool isNull = false;
   String payload;
-  if (!redis.get(contracts::key_cfg(roomId), payload, &isNull)) {
+  if (!redis.get(slot.keys.cfg, payload, &isNull)) {
     dropRedis(F("cfg get"));
     return false;
   }
   if (isNull || !payload.length()) {
-    scheduleCfg = RoomSchedule();
-    scheduleLoaded = true;
-    logSerial.println(F("[schedule] using defaults"));
-    logScheduleSummary();
+    applySchedule(slot, RoomSchedule());
+    LOG_INFO("[schedule] using defaults");
+    logScheduleSummary(slot);
     return true;
   }
   RoomSchedule parsed;
   if (!decodeScheduleJson(payload, parsed)) {
-    logSerial.println(F("[schedule] invalid cfg json, ignoring"));
+    LOG_WARN("[schedule] invalid cfg json, ignoring");
     return false;
   }
-  scheduleCfg = parsed;
-  scheduleLoaded = true;
-  logSerial.println(F("[schedule] config updated"));
-  logScheduleSummary();
+  applySchedule(slot, parsed);
+  LOG_INFO("[schedule] config updated");
+  logScheduleSummary(slot);
   return true;
 }
 
@@ -1182,22 +1782,33 @@ void handleConsoleLine(const char *line) {
     handleRoomAnnouncement(line + 5);
     return;
   }
+  if (strncmp(line, "ROOMS:", 6) == 0) {
+    assignExtraRooms(line + 6);
+    return;
+  }
+  if (strcmp(line, "ROOMS?") == 0) {
+    logRoomSlots();
+    return;
+  }
   if (strcmp(line, "CFG?") == 0) {
-    if (scheduleLoaded) {
-      logScheduleSummary();
-    } else {
-      logSerial.println(F("[schedule] not loaded"));
+    for (uint8_t i = 0; i < roomSlotCount; ++i) {
+      if (roomSlots[i].scheduleLoaded) {
+        logScheduleSummary(roomSlots[i]);
+      } else {
+        LOG_INFO("[schedule] not loaded for room %s", roomSlots[i].roomId.c_str());
+      }
     }
     return;
   }
   if (strcmp(line, "REFRESH") == 0) {
-    scheduleLoaded = false;
-    lastScheduleFetchMs = 0;
-    logSerial.println(F("[schedule] refresh requested"));
+    for (uint8_t i = 0; i < roomSlotCount; ++i) {
+      roomSlots[i].scheduleLoaded = false;
+      roomSlots[i].lastScheduleFetchMs = 0;
+    }
+    LOG_INFO("[schedule] refresh requested");
     return;
   }
-  logSerial.print(F("[sender] unknown console cmd: "));
-  logSerial.println(line);
+  LOG_WARN("[sender] unknown console cmd: %s", line);
 }
 
 /**
@@ -1232,132 +1843,262 @@ void pumpConsole() {
  * Periodically prompts the operator for a ROOM id when provisioning new boards.
  */
 void maybeRequestRoom(unsigned long now) {
-  if (roomId.length()) {
+  if (primaryRoom.roomId.length()) {
     return;
   }
   if ((now - lastRoomPromptMs) < kRoomRequestIntervalMs) {
     return;
   }
-  consoleSerial.println(F("ROOM?"));
+  // Console protocol, not a log line: always sent, in order with the buffered logs.
+  logging::sink().println(F("ROOM?"));
   lastRoomPromptMs = now;
 }
 
 /**
- * Pulls the latest desired/reported snapshot to keep version counters monotonic.
+ * Pulls the latest desired/reported snapshot of one room to keep its version counter
+ * monotonic.
  */
-bool seedVersionFromRedis() {
-  if (!roomId.length()) {
+bool seedVersionFromRedis(RoomSlot &slot) {
+  if (!slot.roomId.length()) {
     return false;
   }
-  auto decodeSnapshot = [](const String &payload, contracts::Desired &out) {
-    if (!payload.length()) {
+  auto loadSnapshot = [](const char *key, const String &payload, bool isNull, contracts::Desired &out) {
+    if (isNull || !payload.length()) {
       return false;
     }
-    StaticJsonDocument<contracts::kDesiredJsonCapacity> doc;
-    DeserializationError err = deserializeJson(doc, payload);
-    if (err) {
+    if (!contracts::decodeDesired(payload, out)) {
+      LOG_WARN("[sender] ignored invalid desired snapshot from %s", key);
       return false;
     }
-    const char *mode = doc["mode"] | nullptr;
-    if (mode && (strcmp(mode, "on") == 0 || strcmp(mode, "off") == 0)) {
-      contracts::copyMode(mode, out);
-    }
-    out.brightness = doc["brightness"] | out.brightness;
-    contracts::clampBrightness(out);
-    out.ver = doc["ver"] | out.ver;
     return true;
   };
-  auto loadSnapshot = [&](const String &key, const __FlashStringHelper *ctx, contracts::Desired &out) {
-    bool isNull = false;
-    String payload;
-    if (!redis.get(key, payload, &isNull)) {
-      dropRedis(ctx);
-      return -1;
-    }
-    if (isNull || !payload.length()) {
-      return 0;
-    }
-    if (!decodeSnapshot(payload, out)) {
-      logSerial.print(F("[sender] ignored invalid desired snapshot from "));
-      logSerial.println(key);
-      return 0;
-    }
-    return 1;
-  };
-  contracts::Desired snapshotDesired;
-  String desiredKey = contracts::key_desired(roomId);
-  int desiredResult = loadSnapshot(desiredKey, F("seed desired get"), snapshotDesired);
-  bool seededFromReported = false;
-  if (desiredResult < 0) {
+  // Fetch both snapshots and the receiver's wire format in one round-trip; reported is
+  // only used when desired is missing.
+  String desiredPayload;
+  String reportedPayload;
+  String wirePayload;
+  bool desiredNull = false;
+  bool reportedNull = false;
+  bool wireNull = false;
+  redis.beginPipeline();
+  redis.queueGet(slot.keys.desired, desiredPayload, &desiredNull);
+  redis.queueGet(slot.keys.reported, reportedPayload, &reportedNull);
+  redis.queueGet(slot.keys.wire, wirePayload, &wireNull);
+  if (!redis.execPipeline()) {
+    dropRedis(F("seed snapshot get"));
     return false;
   }
-  if (desiredResult == 0) {
-    String reportedKey = contracts::key_reported(roomId);
-    int reportedResult = loadSnapshot(reportedKey, F("seed reported get"), snapshotDesired);
-    if (reportedResult < 0) {
-      return false;
-    }
-    seededFromReported = reportedResult == 1;
-    if (reportedResult == 0) {
+  // Receivers that predate the compact format never write the key, so default to JSON.
+  long advertised = wireNull ? contracts::kWireJson : wirePayload.toInt();
+  if (advertised < contracts::kWireJson) {
+    advertised = contracts::kWireJson;
+  }
+  slot.wireFormat = static_cast<uint8_t>(advertised < kMaxWireFormat ? advertised : kMaxWireFormat);
+  contracts::Desired snapshotDesired;
+  bool seededFromReported = false;
+  if (!loadSnapshot(slot.keys.desired.c_str(), desiredPayload, desiredNull, snapshotDesired)) {
+    snapshotDesired = contracts::Desired();
+    seededFromReported = loadSnapshot(slot.keys.reported.c_str(), reportedPayload, reportedNull, snapshotDesired);
+    if (!seededFromReported) {
       snapshotDesired = contracts::Desired();
     }
   }
-  localVer = snapshotDesired.ver;
-  lastDesired = snapshotDesired;
-  needsVersionSeed = false;
-  if (localVer == 0) {
-    logSerial.println(F("[sender] desired seed missing, starting at ver 0"));
+  slot.localVer = snapshotDesired.ver;
+  slot.lastDesired = snapshotDesired;
+  slot.needsVersionSeed = false;
+  if (slot.localVer == 0) {
+    LOG_INFO("[sender] room %s desired seed missing, starting at ver 0", slot.roomId.c_str());
   } else {
-    logSerial.print(F("[sender] desired seed v="));
-    logSerial.print(localVer);
-    if (seededFromReported) {
-      logSerial.println(F(" (reported)"));
-    } else {
-      logSerial.println(F(" (desired)"));
-    }
+    LOG_INFO("[sender] room %s desired seed v=%lu (%s)", slot.roomId.c_str(),
+             static_cast<unsigned long>(slot.localVer), seededFromReported ? "reported" : "desired");
   }
   return true;
 }
 
 /**
- * Writes the Desired snapshot to Redis and appends a stream entry.
+ * Writes `outbound` once its latency budget lapsed (or it filled up) as one pipeline:
+ * the override snapshot `SET`, then one publish-script call per room (snapshot + stream
+ * entry, atomic per room). Each stream entry uses the compact fields when that room's
+ * receiver advertised support for them. Rooms whose write was rejected as stale move past
+ * the server's version and retry on the next loop.
  */
-bool publishDesired(contracts::Desired &desired) {
-  if (desired.ver <= localVer) {
-    desired.ver = localVer + 1;
+void flushOutbound(unsigned long now) {
+  if (!outbound.due(now) || !redis.connected()) {
+    return;
   }
-  if (!contracts::encodeDesired(desired, &roomId, jsonScratch)) {
-    return false;
+  const uint8_t *slots = outbound.slots;
+  contracts::Desired *desired = outbound.desired;
+  const uint8_t count = outbound.count;
+  if (count && !redis.loadPublishScript(FPSTR(contracts::kPublishScript))) {
+    dropRedis(F("publish script"));
+    return;
   }
-  if (!redis.set(contracts::key_desired(roomId), jsonScratch)) {
-    dropRedis(F("set desired"));
-    return false;
+  long storedVer[kPublishBatchMax] = {};
+  bool queued[kPublishBatchMax] = {};
+  redis.beginPipeline();
+  uint32_t overrideVer = 0;
+  const bool overrideEnabled = overrideState.enabled;
+  if (outbound.overridePending && overrideDirty) {
+    overrideVer = encodeOverrideSnapshot();
+    if (overrideVer) {
+      redis.queueSet(primaryRoom.keys.override_, overrideJsonScratch);
+    }
   }
-  if (!redis.xaddJson(contracts::stream_cmd(roomId), jsonScratch)) {
-    dropRedis(F("xadd cmd"));
-    return false;
+  for (uint8_t i = 0; i < count; ++i) {
+    RoomSlot &slot = roomSlots[slots[i]];
+    if (desired[i].ver <= slot.localVer) {
+      desired[i].ver = slot.localVer + 1;
+    }
+    if (!contracts::encodeDesired(desired[i], &slot.roomId, jsonScratch)) {
+      continue;
+    }
+    const char *const *fields = nullptr;
+    uint8_t fieldCount = 0;
+    if (slot.wireFormat >= contracts::kWireCompact) {
+      contracts::encodeDesiredCompact(desired[i], compactScratch);
+      fields = compactScratch.args;
+      fieldCount = compactScratch.count;
+    }
+    // Arguments are copied into the link's frame buffer, so the scratch buffers are reused.
+    queued[i] = redis.queueEvalPublish(slot.keys.desired, slot.keys.cmd,
+                                       jsonScratch, desired[i].ver, kStreamTrimLen, storedVer[i], fields,
+                                       fieldCount);
   }
-  redis.xtrimApprox(contracts::stream_cmd(roomId), kStreamTrimLen);
-  localVer = desired.ver;
-  lastDesired = desired;
-  return true;
+  if (!redis.execPipeline()) {
+    dropRedis(F("publish batch"));
+    return;
+  }
+  if (overrideVer) {
+    noteOverrideStored(overrideVer, overrideEnabled);
+  }
+  cadence.touch(now);
+  if (senderMetrics.wakePending) {
+    senderMetrics.wakePublishMs.record(millis() - senderMetrics.wakeMs);
+    senderMetrics.wakePending = false;
+  }
+  for (uint8_t i = 0; i < count; ++i) {
+    if (!queued[i]) {
+      continue;
+    }
+    RoomSlot &slot = roomSlots[slots[i]];
+    uint32_t serverVer = static_cast<uint32_t>(storedVer[i]);
+    if (serverVer == desired[i].ver) {
+      slot.localVer = desired[i].ver;
+      slot.lastDesired = desired[i];
+      slot.forcePublish = false;
+      continue;
+    }
+    // `serverVer` is the stored version + 1: the retry publishes exactly that.
+    LOG_WARN("[sender] room %s desired v=%lu stale, server holds v=%lu", slot.roomId.c_str(),
+             static_cast<unsigned long>(desired[i].ver), static_cast<unsigned long>(serverVer - 1));
+    slot.localVer = serverVer - 1;
+    slot.forcePublish = true;
+    publishRetryHint = true;
+  }
+  outbound.clear();
 }
 
-
 /**
  * Applies `ROOM_ID_OVERRIDE` so bring-up works without serial input.
  */
 void ensureRoomFromOverride() {
 #if defined(ROOM_ID_OVERRIDE)
-  if (!roomId.length() && ROOM_ID_OVERRIDE[0] != '\0') {
-    roomId = F(ROOM_ID_OVERRIDE);
-    logSerial.print(F("[sender] room override -> "));
-    logSerial.println(roomId);
+  static_assert(sizeof(ROOM_ID_OVERRIDE) - 1 <= contracts::kRoomIdMaxLen, "ROOM_ID_OVERRIDE is too long");
+  if (!primaryRoom.roomId.length() && ROOM_ID_OVERRIDE[0] != '\0') {
+    setSlotRoom(primaryRoom, F(ROOM_ID_OVERRIDE));
+    LOG_INFO("[sender] room override -> %s", primaryRoom.roomId.c_str());
     resetState();
+    removeExtraRoom(primaryRoom.roomId);
+    eventsResubscribe = true;
   }
 #endif
 }
 
+/**
+ * Writes the current metrics window as JSON to the primary room's `room:{id}:metrics`
+ * field `sender` (with a TTL on the hash) and starts a new window.
+ */
+void publishMetrics(unsigned long now) {
+  if (!kMetricsEnabled || !primaryRoom.roomId.length() || !redis.connected()) {
+    return;
+  }
+  SenderMetrics &m = senderMetrics;
+  if (now - m.windowStartMs < kMetricsIntervalMs) {
+    return;
+  }
+  metrics::SnapshotWriter out(metricsScratch, sizeof(metricsScratch));
+  out.appendf(PSTR("{\"ts\":%lu,\"window_ms\":%lu,\"uptime_s\":%lu,\"rooms\":%u,\"coalesced\":%lu,"),
+              static_cast<unsigned long>(timeIsValid() ? time(nullptr) : 0),
+              static_cast<unsigned long>(now - m.windowStartMs), static_cast<unsigned long>(now / 1000),
+              static_cast<unsigned>(roomSlotCount), static_cast<unsigned long>(outbound.superseded));
+  out.appendf(PSTR("\"heap\":{\"free\":%lu,\"min_free\":%lu,\"max_block\":%u,\"frag\":%u},"),
+              static_cast<unsigned long>(ESP.getFreeHeap()), static_cast<unsigned long>(m.minFreeHeap),
+              static_cast<unsigned>(ESP.getMaxFreeBlockSize()), static_cast<unsigned>(ESP.getHeapFragmentation()));
+  out.histogram("loop_us", m.loopUs);
+  out.appendf(PSTR(",\"power\":{\"mode\":\"%s\",\"idle_ms\":%lu,\"wakes\":{\"timer\":%u,\"button\":%u,"
+                   "\"socket\":%u,\"console\":%u},"),
+              kSleepMode == 2 ? "light" : (kSleepMode == 1 ? "modem" : "off"), static_cast<unsigned long>(m.idleMs),
+              static_cast<unsigned>(m.wakes[kWakeTimer]), static_cast<unsigned>(m.wakes[kWakeButton]),
+              static_cast<unsigned>(m.wakes[kWakeSocket]), static_cast<unsigned>(m.wakes[kWakeConsole]));
+  out.histogram("wake_publish_ms", m.wakePublishMs);
+  out.appendf(PSTR("},"));
+#if SENDER_DISPLAY_ENABLED
+  out.histogram("display_us", m.displayUs);
+  out.appendf(PSTR(","));
+#endif
+  out.rtt(m.links);
+  out.appendf(PSTR(",\"links\":{\"wifi\":{\"connects\":%u,\"blocked_ms\":%lu}"),
+              static_cast<unsigned>(m.wifiConnects), static_cast<unsigned long>(m.wifiBlockedMs));
+  const struct {
+    const char *name;
+    Backoff &backoff;
+  } links[] = {{"redis", redisBackoff}, {"events", eventBackoff}};
+  for (const auto &link : links) {
+    out.appendf(PSTR(",\"%s\":{\"connects\":%u,\"failures\":%u,\"down_ms\":%lu}"), link.name,
+                static_cast<unsigned>(link.backoff.connects), static_cast<unsigned>(link.backoff.failures),
+                static_cast<unsigned long>(link.backoff.downMs));
+  }
+  out.appendf(PSTR("}}"));
+  if (!out.ok()) {
+    LOG_WARN("[metrics] snapshot exceeds %u bytes, skipped", static_cast<unsigned>(kMetricsJsonCapacity));
+  } else {
+    redis.beginPipeline();
+    redis.queueHset(primaryRoom.keys.metrics, "sender", out.c_str());
+    redis.queueExpire(primaryRoom.keys.metrics, kMetricsTtlSec);
+    if (!redis.execPipeline()) {
+      dropRedis(F("metrics"));
+      return;
+    }
+    LOG_DEBUG("[metrics] %s", out.c_str());
+  }
+  m.links.reset();
+  m.loopUs.reset();
+  m.wakePublishMs.reset();
+  m.displayUs.reset();
+  m.idleMs = 0;
+  memset(m.wakes, 0, sizeof(m.wakes));
+  outbound.superseded = 0;
+  m.minFreeHeap = UINT32_MAX;
+  m.wifiConnects = 0;
+  m.wifiBlockedMs = 0;
+  for (const auto &link : links) {
+    link.backoff.clearStats();
+  }
+  m.windowStartMs = now;
+}
+
+/** Samples loop timing and free heap for the metrics window. */
+void sampleMetrics() {
+  if (!kMetricsEnabled) {
+    return;
+  }
+  senderMetrics.loopTimer.tick(senderMetrics.loopUs);
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < senderMetrics.minFreeHeap) {
+    senderMetrics.minFreeHeap = freeHeap;
+  }
+}
+
 /** Reports whether SNTP has delivered a sane epoch time. */
 bool timeIsValid() { return time(nullptr) >= kMinValidEpoch; }
 
@@ -1385,201 +2126,318 @@ void ensureClockSync(unsigned long now) {
                NTP_SERVER_TERTIARY);
     timeConfigured = true;
     lastTimeSyncAttemptMs = now;
-    logSerial.println(F("[time] requested SNTP sync"));
+    LOG_INFO("[time] requested SNTP sync");
   }
   if (timeIsValid() && !timeAnnounced) {
-    logSerial.println(F("[time] clock synchronized"));
+    LOG_INFO("[time] clock synchronized");
     timeAnnounced = true;
   }
 }
 
 /**
- * Refreshes the cached schedule at a fixed interval while online.
+ * Refreshes cached schedules when a `cfg` event arrived or the poll interval lapsed
+ * (stretched to the fallback interval while events are live). At most one room is
+ * fetched per call, round-robin, so a large room table never stalls the loop.
  */
 void maybeRefreshSchedule(unsigned long now) {
-  if (!roomId.length() || !redis.connected()) {
+  if (!redis.connected()) {
     return;
   }
-  if (scheduleLoaded && (now - lastScheduleFetchMs) < kConfigRefreshIntervalMs) {
+  for (uint8_t visited = 0; visited < roomSlotCount; ++visited) {
+    uint8_t index = (scheduleCursor + visited) % roomSlotCount;
+    RoomSlot &slot = roomSlots[index];
+    if (!slot.roomId.length()) {
+      continue;
+    }
+    if (slot.scheduleLoaded && !slot.cfgChanged &&
+        (now - slot.lastScheduleFetchMs) < refreshInterval(kConfigRefreshIntervalMs)) {
+      continue;
+    }
+    scheduleCursor = (index + 1) % roomSlotCount;
+    if (fetchScheduleConfig(slot)) {
+      slot.lastScheduleFetchMs = now;
+      slot.cfgChanged = false;
+    }
     return;
   }
-  if (fetchScheduleConfig()) {
-    lastScheduleFetchMs = now;
-  }
 }
 
 /**
- * Safely subtracts seconds while wrapping within a 24-hour window.
+ * Queues scheduled or override-derived Desired states when something changed. Every
+ * room is evaluated each tick (scheduled rooms only once their compiled table says the
+ * output can have moved); the changed ones join `outbound`, which `flushOutbound()`
+ * writes as one pipelined batch. The scan resumes after the last room it reached, so
+ * when more rooms change than fit in one batch the rest follow on the next ticks.
+ * Override changes rescan from the primary room and replace its queued state.
  */
-uint32_t wrapSubtract(uint32_t value, uint32_t delta) {
-  if (kSecondsPerDay == 0) {
-    return value;
+void maybePublishScheduledState(unsigned long now) {
+  bool urgent = overridePublishHint || publishRetryHint;
+  if (!urgent && (now - lastSchedulePublishMs) < kSchedulePublishIntervalMs) {
+    return;
   }
-  delta %= kSecondsPerDay;
-  if (delta > value) {
-    return kSecondsPerDay - (delta - value);
+  if (!redis.connected()) {
+    return;
   }
-  return value - delta;
-}
-
-/**
- * Returns true when the provided timestamp sits inside the circular window.
- */
-bool inWindow(uint32_t start, uint32_t end, uint32_t value) {
-  if (start == end) {
-    return false;
+  tm localNow = {};
+  bool haveTime = acquireLocalTime(localNow);
+  time_t epochNow = haveTime ? time(nullptr) : 0;
+  uint32_t secondsOfDay = static_cast<uint32_t>(localNow.tm_hour) * 3600UL +
+                          static_cast<uint32_t>(localNow.tm_min) * 60UL +
+                          static_cast<uint32_t>(localNow.tm_sec);
+  uint8_t start = overridePublishHint ? 0 : publishCursor % roomSlotCount;
+  uint8_t visited = 0;
+  for (; visited < roomSlotCount; ++visited) {
+    uint8_t index = (start + visited) % roomSlotCount;
+    RoomSlot &slot = roomSlots[index];
+    bool overrideActive = index == 0 && overrideState.enabled;
+    if (!slot.roomId.length() || (!slot.scheduleLoaded && !overrideActive)) {
+      continue;
+    }
+    if (!overrideActive && !haveTime) {
+      continue;
+    }
+    if (!overrideActive && !slot.forcePublish && !slot.needsVersionSeed && slot.nextChangeEpoch) {
+      // A clock step backwards (NTP correction) would otherwise freeze the room until the
+      // old deadline; anything further out than a day cannot be a real deadline.
+      bool clockSane = slot.nextChangeEpoch - epochNow <= static_cast<time_t>(kSecondsPerDay);
+      if (epochNow < slot.nextChangeEpoch && clockSane) {
+        continue;
+      }
+    }
+    if (slot.needsVersionSeed && !seedVersionFromRedis(slot)) {
+      return;
+    }
+    contracts::Desired next = slot.lastDesired;
+    next.fadeMs = 0;
+    if (overrideActive) {
+      next.brightness = overrideState.brightness;
+      slot.nextChangeEpoch = 0;
+    } else {
+      next.brightness = scheduling::lookupScheduleBrightness(slot.compiled, secondsOfDay);
+      uint32_t untilChange = scheduling::secondsUntilScheduleChange(slot.compiled, secondsOfDay);
+      if (slot.wireFormat >= contracts::kWireFade) {
+        // One command covers the rest of a ramp segment: the receiver fades locally and
+        // the next publish falls due when the segment ends.
+        scheduling::ScheduleRamp ramp = scheduling::scheduleRampAt(slot.compiled, secondsOfDay);
+        if (ramp.durationSec > 0) {
+          next.brightness = ramp.target;
+          next.fadeMs = ramp.durationSec * 1000UL;
+          untilChange = ramp.durationSec + 1;
+        }
+      }
+      slot.nextChangeEpoch = epochNow + static_cast<time_t>(untilChange);
+    }
+    if (!contracts::copyMode(next.brightness > 0 ? "on" : "off", next)) {
+      continue;
+    }
+    // A scheduled step onto the value a finished fade already rests on changes nothing.
+    contracts::Desired previous = slot.lastDesired;
+    if (!overrideActive && next.fadeMs == 0) {
+      previous.fadeMs = 0;
+    }
+    if (contracts::sameDesired(next, previous) && !slot.forcePublish) {
+      outbound.dropDesired(index);
+      continue;
+    }
+    if (!outbound.queueDesired(index, next, now)) {
+      break;  // batch full: this room opens the next scan
+    }
   }
-  if (start < end) {
-    return value >= start && value < end;
+  publishRetryHint = false;
+  publishCursor = (start + visited) % roomSlotCount;
+  if (start == 0 || visited == roomSlotCount) {
+    overridePublishHint = false;
   }
-  return value >= start || value < end;
+  lastSchedulePublishMs = now;
 }
 
-/**
- * Calculates the elapsed seconds between `start` and `value` with day wrapping.
- */
-uint32_t elapsedSince(uint32_t start, uint32_t value) {
-  if (value >= start) {
-    return value - start;
+/** Shrinks `budget` to what is left of `interval` since `since` (0 once it lapsed). */
+void clampToDeadline(unsigned long &budget, unsigned long now, unsigned long since, unsigned long interval) {
+  unsigned long elapsed = now - since;
+  unsigned long left = elapsed >= interval ? 0 : interval - elapsed;
+  if (left < budget) {
+    budget = left;
   }
-  return kSecondsPerDay - start + value;
 }
 
 /**
- * Performs an integer linear interpolation across the configured duration.
+ * Re-evaluates `cadence` for this pass. A live or unsaved override, queued publishes and
+ * a showing sound warning hold it active; written batches keep it there for a while
+ * (see `flushOutbound()`), and a slow Redis link backs it off.
  */
-uint8_t lerpBrightness(uint8_t from, uint8_t to, uint32_t elapsed, uint32_t duration) {
-  if (duration == 0) {
-    return to;
-  }
-  if (elapsed > duration) {
-    elapsed = duration;
-  }
-  int16_t delta = static_cast<int16_t>(to) - static_cast<int16_t>(from);
-  int32_t scaled = static_cast<int32_t>(delta) * static_cast<int32_t>(elapsed) +
-                   static_cast<int32_t>(duration / 2);
-  int32_t result = static_cast<int32_t>(from) + scaled / static_cast<int32_t>(duration);
-  if (result < 0) {
-    result = 0;
-  } else if (result > 100) {
-    result = 100;
+void updatePace(unsigned long now) {
+  bool busy = overrideState.enabled || overrideDirty || !outbound.empty();
+#if SENDER_DISPLAY_ENABLED
+  busy = busy || (warningOverlayUntilMs && static_cast<long>(warningOverlayUntilMs - now) > 0);
+#endif
+  if (cadence.update(now, busy, redis.smoothedRttUs())) {
+    LOG_DEBUG("[sched] pace %s", sched::paceName(cadence.pace()));
   }
-  return static_cast<uint8_t>(result);
 }
 
 /**
- * Evaluates the sunrise/quiet-hour rules to pick the scheduled brightness.
+ * Polls `loop()` runs once Redis is up, each due on its change event or when its
+ * interval (following `cadence`, see `refreshInterval()`) lapses. Schedule configs keep
+ * per-room timers in `maybeRefreshSchedule()` on the same interval rules.
  */
-uint8_t evaluateScheduleBrightness(const tm &now) {
-  uint32_t seconds =
-      static_cast<uint32_t>(now.tm_hour) * 3600UL + static_cast<uint32_t>(now.tm_min) * 60UL +
-      static_cast<uint32_t>(now.tm_sec);
-  uint8_t brightness = scheduleCfg.baselineBrightness;
-  uint8_t dayBrightness = brightness;
-  uint32_t sunriseTarget = 0;
-  uint32_t sunriseStart = 0;
-  uint32_t sunriseDuration = 0;
-  bool sunriseHasRamp = false;
+sched::Task senderTasks[] = {
+#if SENDER_DISPLAY_ENABLED
+    {pollLatestWarning, warningPollIntervalMs, &warningChanged, 0},
+#endif
+    {pollOverrideState, overridePollIntervalMs, &overrideChanged, 0},
+};
+sched::TaskTable tasks(senderTasks);
 
-  if (scheduleCfg.wakeEnabled) {
-    sunriseTarget = static_cast<uint32_t>(scheduleCfg.wakeStartMin) * 60UL;
-    uint16_t leadMinutes =
-        scheduleCfg.wakeDurationMin > 0 ? scheduleCfg.wakeDurationMin : kWakeLeadMinutes;
-    if (leadMinutes < kWakeLeadMinutes) {
-      leadMinutes = kWakeLeadMinutes;
+/**
+ * Milliseconds `loop()` can stay idle before some task falls due: the earliest compiled
+ * schedule change of any room, the outbound flush, polls, the events ping, the metrics
+ * window, the display and the status LED blink, capped at `SENDER_SLEEP_MAX_MS`. Returns 0
+ * while anything is in flight (live override, debounce, retries, console input, reconnects).
+ */
+unsigned long idleBudgetMs(unsigned long now) {
+  if (!redis.connected() || overrideState.enabled || overrideDirty || overridePublishHint ||
+      publishRetryHint || eventsResubscribe || overrideState.buttonReading != overrideState.buttonStable ||
+      consoleSerial.available()) {
+    return 0;
+  }
+  unsigned long budget = kSleepMaxMs;
+  if (!outbound.empty()) {
+    clampToDeadline(budget, now, outbound.openedMs, kPublishCoalesceMs);
+  }
+  budget = tasks.nextDueMs(now, budget);
+  if (eventsSubscribed) {
+    clampToDeadline(budget, now, lastEventPingMs, kEventPingIntervalMs);
+  }
+  if (kMetricsEnabled) {
+    clampToDeadline(budget, now, senderMetrics.windowStartMs, kMetricsIntervalMs);
+  }
+#if SENDER_DISPLAY_ENABLED
+  clampToDeadline(budget, now, lastDisplayRefreshMs, kDisplayRefreshIntervalMs);
+#endif
+  if (kStatusLedControllable && statusLedMode == StatusLedMode::Blink) {
+    clampToDeadline(budget, now, statusLedLastToggleMs, kStatusLedBlinkIntervalMs);
+  }
+  timeval tv = {};
+  const bool haveTime = timeIsValid();
+  if (haveTime) {
+    gettimeofday(&tv, nullptr);
+  }
+  for (uint8_t i = 0; i < roomSlotCount; ++i) {
+    const RoomSlot &slot = roomSlots[i];
+    if (!slot.roomId.length()) {
+      continue;
     }
-    sunriseDuration = static_cast<uint32_t>(leadMinutes) * 60UL;
-    sunriseStart = wrapSubtract(sunriseTarget, sunriseDuration);
-    sunriseHasRamp = sunriseDuration > 0;
-    if (sunriseDuration == 0) {
-      if (seconds >= sunriseTarget) {
-        brightness = scheduleCfg.wakePeakBrightness;
-      }
-    } else {
-      bool rampActive = inWindow(sunriseStart, sunriseTarget, seconds);
-      if (rampActive) {
-        uint32_t elapsed = elapsedSince(sunriseStart, seconds);
-        uint32_t scaled = static_cast<uint32_t>(scheduleCfg.wakePeakBrightness) * elapsed +
-                          (sunriseDuration / 2);
-        uint8_t ramp = static_cast<uint8_t>(scaled / sunriseDuration);
-        if (ramp < scheduleCfg.baselineBrightness) {
-          ramp = scheduleCfg.baselineBrightness;
-        }
-        brightness = ramp;
-      } else if (inWindow(sunriseTarget, sunriseStart, seconds)) {
-        brightness = scheduleCfg.wakePeakBrightness;
-      }
+    if (!slot.scheduleLoaded || slot.cfgChanged || slot.forcePublish || slot.needsVersionSeed) {
+      return 0;
     }
-  }
-  dayBrightness = brightness;
-
-  if (scheduleCfg.nightEnabled) {
-    uint32_t nightStart = static_cast<uint32_t>(scheduleCfg.nightStartMin) * 60UL;
-    uint32_t nightEnd = nightStart;
-    if (scheduleCfg.wakeEnabled) {
-      nightEnd = sunriseHasRamp ? sunriseStart : sunriseTarget;
+    clampToDeadline(budget, now, slot.lastScheduleFetchMs, refreshInterval(kConfigRefreshIntervalMs));
+    if (!haveTime) {
+      continue;  // nothing scheduled can fire before the clock is set
     }
-    uint32_t quietRampDuration = static_cast<uint32_t>(kQuietLeadMinutes) * 60UL;
-    uint32_t quietRampStart = wrapSubtract(nightStart, quietRampDuration);
-    bool inQuiet = false;
-    if (nightStart == nightEnd) {
-      inQuiet = seconds >= nightStart;
-    } else {
-      inQuiet = inWindow(nightStart, nightEnd, seconds);
+    if (!slot.nextChangeEpoch || slot.nextChangeEpoch <= tv.tv_sec) {
+      clampToDeadline(budget, now, lastSchedulePublishMs, kSchedulePublishIntervalMs);
+      continue;
     }
-    if (inQuiet) {
-      brightness = scheduleCfg.nightBrightness;
-    } else if (quietRampDuration > 0 && inWindow(quietRampStart, nightStart, seconds)) {
-      uint32_t elapsed = elapsedSince(quietRampStart, seconds);
-      brightness =
-          lerpBrightness(dayBrightness, scheduleCfg.nightBrightness, elapsed, quietRampDuration);
+    uint64_t leftMs = static_cast<uint64_t>(slot.nextChangeEpoch - tv.tv_sec) * 1000ULL - tv.tv_usec / 1000;
+    if (leftMs < budget) {
+      budget = static_cast<unsigned long>(leftMs);
     }
   }
-  return clampPercent(brightness);
+  return budget;
 }
 
 /**
- * Publishes scheduled or override-derived Desired states when something changed.
+ * Light sleep only wakes on a GPIO level, so in `SENDER_SLEEP_MODE` 2 the button's wake
+ * is armed just for an idle stretch. It reprograms the pin to a level interrupt, which
+ * `onOverrideButtonEdge()` masks on its first run; `disarmButtonWake()` restores the
+ * CHANGE interrupt the debounce relies on. A button already held is not armed.
  */
-void maybePublishScheduledState(unsigned long now) {
-  bool urgent = overridePublishHint;
-  if (!urgent && (now - lastSchedulePublishMs) < kSchedulePublishIntervalMs) {
+void armButtonWake() {
+  if (kSleepMode != 2 || overrideButtonPressedLevel(digitalRead(OVERRIDE_BUTTON_PIN))) {
     return;
   }
-  if (!roomId.length() || !redis.connected()) {
+  buttonWakeArmed = true;
+  wifi_enable_gpio_wakeup(GPIO_ID_PIN(OVERRIDE_BUTTON_PIN),
+                          OVERRIDE_BUTTON_ACTIVE_LEVEL == LOW ? GPIO_PIN_INTR_LOLEVEL : GPIO_PIN_INTR_HILEVEL);
+}
+
+void disarmButtonWake() {
+  if (kSleepMode != 2) {
     return;
   }
-  if (!scheduleLoaded && !overrideState.enabled) {
+  buttonWakeArmed = false;
+  wifi_disable_gpio_wakeup();
+  attachInterrupt(digitalPinToInterrupt(OVERRIDE_BUTTON_PIN), onOverrideButtonEdge, CHANGE);
+}
+
+/**
+ * Ends a `loop()` pass. With `SENDER_SLEEP_MODE` set it idles in `delay()` until the next
+ * deadline from `idleBudgetMs()`, which lets the SDK modem-sleep (radio off between DTIM
+ * beacons) or light-sleep (CPU halted too, woken by its timer, the override button's
+ * GPIO or network traffic). A button edge, data on the events link or console input cuts
+ * the stretch short. The metrics window counts idle time and wakes, and times each wake
+ * that queued something until its batch was written.
+ */
+void idleUntilWork() {
+  if (!kSleepMode) {
+    yield();
     return;
   }
-  tm localNow;
-  bool haveTime = acquireLocalTime(localNow);
-  if (!overrideState.enabled && !haveTime) {
-    return;
+  SenderMetrics &m = senderMetrics;
+  if (outbound.empty()) {
+    m.wakePending = false;  // the last wake published nothing (or was already timed)
   }
-  if (needsVersionSeed && !seedVersionFromRedis()) {
+  if (overrideButtonEdge) {
+    overrideButtonEdge = false;
+    yield();
     return;
   }
-  contracts::Desired desired = lastDesired;
-  if (overrideState.enabled) {
-    desired.brightness = overrideState.brightness;
-  } else {
-    desired.brightness = evaluateScheduleBrightness(localNow);
-  }
-  const char *mode = desired.brightness > 0 ? "on" : "off";
-  if (!contracts::copyMode(mode, desired)) {
+  unsigned long budget = idleBudgetMs(millis());
+  if (budget < kSleepMinMs) {
+    yield();
     return;
   }
-  bool same = contracts::sameDesired(desired, lastDesired);
-  if (same && !desiredForcePublish) {
-    overridePublishHint = false;
-    lastSchedulePublishMs = now;
-    return;
+  WakeReason reason = kWakeTimer;
+  const unsigned long start = millis();
+  armButtonWake();
+  for (unsigned long elapsed = 0; elapsed < budget; elapsed = millis() - start) {
+    unsigned long left = budget - elapsed;
+    delay(left < kSleepSliceMs ? left : kSleepSliceMs);
+    if (overrideButtonEdge) {
+      reason = kWakeButton;
+      break;
+    }
+    if (eventClient.available() > 0) {
+      reason = kWakeSocket;
+      break;
+    }
+    if (consoleSerial.available()) {
+      reason = kWakeConsole;
+      break;
+    }
   }
-  if (publishDesired(desired)) {
-    desiredForcePublish = false;
-    overridePublishHint = false;
-    lastSchedulePublishMs = now;
+  disarmButtonWake();
+  overrideButtonEdge = false;
+  const unsigned long woke = millis();
+  m.idleMs += woke - start;
+  ++m.wakes[reason];
+  if (!m.wakePending) {
+    m.wakeMs = woke;
+    m.wakePending = true;
+  }
+}
+
+/**
+ * Maps `SENDER_SLEEP_MODE` onto the SDK sleep type (the button's GPIO wake is armed per
+ * idle stretch, see `armButtonWake()`).
+ */
+void configureSleep() {
+  if (kSleepMode == 2) {
+    WiFi.setSleepMode(WIFI_LIGHT_SLEEP);
+  } else if (kSleepMode == 1) {
+    WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+  } else {
+    WiFi.setSleepMode(WIFI_NONE_SLEEP);
   }
 }
 
@@ -1588,7 +2446,7 @@ void maybePublishScheduledState(unsigned long now) {
 /** Arduino setup entry point: initializes hardware and shared buffers. */
 void setup() {
   consoleSerial.begin(SENDER_CONSOLE_BAUD);
-  log(F("boot"));
+  LOG_INFO("[sender] boot");
   initOverrideHardware();
 #if SENDER_DISPLAY_ENABLED
   initDisplayHardware();
@@ -1598,7 +2456,7 @@ void setup() {
     setStatusLed(false);
   }
   WiFi.mode(WIFI_STA);
-  WiFi.setSleepMode(WIFI_NONE_SLEEP);
+  configureSleep();
 #ifdef WIFI_HOSTNAME
   {
     String host = String(WIFI_HOSTNAME) + "-sender";
@@ -1612,10 +2470,16 @@ void setup() {
   warningFetchJson.reserve(160);
 #endif
   ensureRoomFromOverride();
+  assignExtraRooms(SENDER_EXTRA_ROOM_IDS);
+  if (kMetricsEnabled) {
+    redis.attachMetrics(&senderMetrics.links);
+  }
 }
 
 /** Main firmware loop that orchestrates connectivity, IO, and scheduling. */
 void loop() {
+  logging::pump();
+  sampleMetrics();
   unsigned long now = millis();
   updateStatusLed(now);
   pumpConsole();
@@ -1637,13 +2501,15 @@ void loop() {
   }
   ensureRoomFromOverride();
   ensureClockSync(now);
+  ensureEvents(now);
+  pumpEvents(now);
   maybeRefreshSchedule(now);
-#if SENDER_DISPLAY_ENABLED
-  maybeFetchLatestWarning(now);
-#endif
-  maybeFetchOverrideState(now);
-  maybePublishOverrideState();
+  updatePace(now);
+  tasks.runDue(now);
+  maybeQueueOverrideState(now);
   maybePublishScheduledState(now);
+  flushOutbound(now);
+  publishMetrics(now);
   maybeRequestRoom(now);
-  yield();
+  idleUntilWork();
 }
@@ -0,0 +1,450 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifndef SCHEDULE_DEFAULT_WAKE_HOUR
+#define SCHEDULE_DEFAULT_WAKE_HOUR 7
+#endif
+
+#ifndef SCHEDULE_DEFAULT_WAKE_MINUTE
+#define SCHEDULE_DEFAULT_WAKE_MINUTE 0
+#endif
+
+#ifndef SCHEDULE_DEFAULT_WAKE_DURATION_MIN
+#define SCHEDULE_DEFAULT_WAKE_DURATION_MIN 20
+#endif
+
+#ifndef SCHEDULE_DEFAULT_WAKE_BRIGHTNESS
+#define SCHEDULE_DEFAULT_WAKE_BRIGHTNESS 100
+#endif
+
+#ifndef SCHEDULE_DEFAULT_NIGHT_HOUR
+#define SCHEDULE_DEFAULT_NIGHT_HOUR 22
+#endif
+
+#ifndef SCHEDULE_DEFAULT_NIGHT_MINUTE
+#define SCHEDULE_DEFAULT_NIGHT_MINUTE 0
+#endif
+
+#ifndef SCHEDULE_DEFAULT_NIGHT_BRIGHTNESS
+#define SCHEDULE_DEFAULT_NIGHT_BRIGHTNESS 5
+#endif
+
+#ifndef SCHEDULE_DEFAULT_BASELINE_BRIGHTNESS
+#define SCHEDULE_DEFAULT_BASELINE_BRIGHTNESS 0
+#endif
+
+#ifndef QUIET_HOURS_DIM_MINUTES
+#define QUIET_HOURS_DIM_MINUTES 90
+#endif
+
+#ifndef WAKE_BRIGHTEN_MINUTES
+#define WAKE_BRIGHTEN_MINUTES 30
+#endif
+
+/**
+ * Sunrise/quiet-hour schedule math for the sender. Kept free of Arduino dependencies so
+ * the compiled lookup can be checked against the reference evaluator on the host.
+ */
+namespace scheduling {
+
+constexpr uint16_t kMinutesPerDay = 24 * 60;
+constexpr uint32_t kSecondsPerDay = static_cast<uint32_t>(kMinutesPerDay) * 60UL;
+constexpr uint16_t kQuietLeadMinutes = QUIET_HOURS_DIM_MINUTES;
+constexpr uint16_t kWakeLeadMinutes = WAKE_BRIGHTEN_MINUTES;
+
+/**
+ * Cached quiet-hours schedule pulled from Redis.
+ */
+struct RoomSchedule {
+  bool wakeEnabled = true;
+  uint16_t wakeStartMin = static_cast<uint16_t>(SCHEDULE_DEFAULT_WAKE_HOUR * 60 +
+                                                SCHEDULE_DEFAULT_WAKE_MINUTE);
+  uint16_t wakeDurationMin = SCHEDULE_DEFAULT_WAKE_DURATION_MIN;
+  uint8_t wakePeakBrightness = SCHEDULE_DEFAULT_WAKE_BRIGHTNESS;
+  bool nightEnabled = true;
+  uint16_t nightStartMin = static_cast<uint16_t>(SCHEDULE_DEFAULT_NIGHT_HOUR * 60 +
+                                                 SCHEDULE_DEFAULT_NIGHT_MINUTE);
+  uint8_t nightBrightness = SCHEDULE_DEFAULT_NIGHT_BRIGHTNESS;
+  uint8_t baselineBrightness = SCHEDULE_DEFAULT_BASELINE_BRIGHTNESS;
+  uint32_t version = 0;
+};
+
+/**
+ * Constrains integer percentages to the 0-100 range.
+ */
+inline uint8_t clampPercent(int value) {
+  if (value < 0) {
+    return 0;
+  }
+  if (value > 100) {
+    return 100;
+  }
+  return static_cast<uint8_t>(value);
+}
+
+/**
+ * Safely subtracts seconds while wrapping within a 24-hour window.
+ */
+inline uint32_t wrapSubtract(uint32_t value, uint32_t delta) {
+  if (kSecondsPerDay == 0) {
+    return value;
+  }
+  delta %= kSecondsPerDay;
+  if (delta > value) {
+    return kSecondsPerDay - (delta - value);
+  }
+  return value - delta;
+}
+
+/**
+ * Returns true when the provided timestamp sits inside the circular window.
+ */
+inline bool inWindow(uint32_t start, uint32_t end, uint32_t value) {
+  if (start == end) {
+    return false;
+  }
+  if (start < end) {
+    return value >= start && value < end;
+  }
+  return value >= start || value < end;
+}
+
+/**
+ * Calculates the elapsed seconds between `start` and `value` with day wrapping.
+ */
+inline uint32_t elapsedSince(uint32_t start, uint32_t value) {
+  if (value >= start) {
+    return value - start;
+  }
+  return kSecondsPerDay - start + value;
+}
+
+/**
+ * Performs an integer linear interpolation across the configured duration.
+ */
+inline uint8_t lerpBrightness(uint8_t from, uint8_t to, uint32_t elapsed, uint32_t duration) {
+  if (duration == 0) {
+    return to;
+  }
+  if (elapsed > duration) {
+    elapsed = duration;
+  }
+  int16_t delta = static_cast<int16_t>(to) - static_cast<int16_t>(from);
+  int32_t scaled = static_cast<int32_t>(delta) * static_cast<int32_t>(elapsed) +
+                   static_cast<int32_t>(duration / 2);
+  int32_t result = static_cast<int32_t>(from) + scaled / static_cast<int32_t>(duration);
+  if (result < 0) {
+    result = 0;
+  } else if (result > 100) {
+    result = 100;
+  }
+  return static_cast<uint8_t>(result);
+}
+
+/**
+ * Window boundaries derived from a schedule (seconds of day). Shared by the reference
+ * evaluator and the segment compiler so both use the same edges.
+ */
+struct ScheduleWindows {
+  uint32_t sunriseTarget = 0;
+  uint32_t sunriseStart = 0;
+  uint32_t sunriseDuration = 0;
+  bool sunriseHasRamp = false;
+  uint32_t nightStart = 0;
+  uint32_t nightEnd = 0;
+  uint32_t quietRampStart = 0;
+  uint32_t quietRampDuration = 0;
+};
+
+/** Computes the sunrise and quiet-ramp windows for `cfg`. */
+inline ScheduleWindows scheduleWindows(const RoomSchedule &cfg) {
+  ScheduleWindows w;
+  if (cfg.wakeEnabled) {
+    w.sunriseTarget = static_cast<uint32_t>(cfg.wakeStartMin) * 60UL;
+    uint16_t leadMinutes = cfg.wakeDurationMin > 0 ? cfg.wakeDurationMin : kWakeLeadMinutes;
+    if (leadMinutes < kWakeLeadMinutes) {
+      leadMinutes = kWakeLeadMinutes;
+    }
+    w.sunriseDuration = static_cast<uint32_t>(leadMinutes) * 60UL;
+    w.sunriseStart = wrapSubtract(w.sunriseTarget, w.sunriseDuration);
+    w.sunriseHasRamp = w.sunriseDuration > 0;
+  }
+  if (cfg.nightEnabled) {
+    w.nightStart = static_cast<uint32_t>(cfg.nightStartMin) * 60UL;
+    w.nightEnd = w.nightStart;
+    if (cfg.wakeEnabled) {
+      w.nightEnd = w.sunriseHasRamp ? w.sunriseStart : w.sunriseTarget;
+    }
+    w.quietRampDuration = static_cast<uint32_t>(kQuietLeadMinutes) * 60UL;
+    w.quietRampStart = wrapSubtract(w.nightStart, w.quietRampDuration);
+  }
+  return w;
+}
+
+/** Brightness of the sunrise ramp at `seconds` (inside the ramp window). */
+inline uint8_t sunriseRamp(const RoomSchedule &cfg, const ScheduleWindows &w, uint32_t seconds) {
+  uint32_t elapsed = elapsedSince(w.sunriseStart, seconds);
+  uint32_t scaled = static_cast<uint32_t>(cfg.wakePeakBrightness) * elapsed + (w.sunriseDuration / 2);
+  uint8_t ramp = static_cast<uint8_t>(scaled / w.sunriseDuration);
+  if (ramp < cfg.baselineBrightness) {
+    ramp = cfg.baselineBrightness;
+  }
+  return ramp;
+}
+
+/**
+ * Evaluates the sunrise/quiet-hour rules to pick the scheduled brightness at `seconds`
+ * since local midnight. This is the reference the compiled table must reproduce.
+ */
+inline uint8_t evaluateScheduleBrightness(const RoomSchedule &cfg, uint32_t seconds) {
+  const ScheduleWindows w = scheduleWindows(cfg);
+  uint8_t brightness = cfg.baselineBrightness;
+  if (cfg.wakeEnabled) {
+    if (w.sunriseDuration == 0) {
+      if (seconds >= w.sunriseTarget) {
+        brightness = cfg.wakePeakBrightness;
+      }
+    } else if (inWindow(w.sunriseStart, w.sunriseTarget, seconds)) {
+      brightness = sunriseRamp(cfg, w, seconds);
+    } else if (inWindow(w.sunriseTarget, w.sunriseStart, seconds)) {
+      brightness = cfg.wakePeakBrightness;
+    }
+  }
+  uint8_t dayBrightness = brightness;
+
+  if (cfg.nightEnabled) {
+    bool inQuiet = false;
+    if (w.nightStart == w.nightEnd) {
+      inQuiet = seconds >= w.nightStart;
+    } else {
+      inQuiet = inWindow(w.nightStart, w.nightEnd, seconds);
+    }
+    if (inQuiet) {
+      brightness = cfg.nightBrightness;
+    } else if (w.quietRampDuration > 0 && inWindow(w.quietRampStart, w.nightStart, seconds)) {
+      uint32_t elapsed = elapsedSince(w.quietRampStart, seconds);
+      brightness = lerpBrightness(dayBrightness, cfg.nightBrightness, elapsed, w.quietRampDuration);
+    }
+  }
+  return clampPercent(brightness);
+}
+
+/** Output formula of one compiled segment. */
+enum class SegmentKind : uint8_t {
+  Constant,        // `value`
+  Sunrise,         // sunrise ramp
+  Dim,             // quiet-hour dim from the constant `value` towards night brightness
+  DimFromSunrise,  // quiet-hour dim starting from the (overlapping) sunrise ramp
+};
+
+/** One breakpoint of the daily table: the formula in effect from `start` onwards. */
+struct ScheduleSegment {
+  uint32_t start = 0;
+  SegmentKind kind = SegmentKind::Constant;
+  uint8_t value = 0;
+};
+
+/**
+ * Upper bound on segments per day: edges at midnight, sunrise start/target, night start,
+ * night end and quiet-ramp start.
+ */
+constexpr uint8_t kMaxScheduleSegments = 6;
+
+/**
+ * A schedule compiled into a sorted breakpoint table. Lookups binary-search the table
+ * and evaluate at most one ramp formula instead of re-deriving every window.
+ */
+struct CompiledSchedule {
+  RoomSchedule cfg;
+  ScheduleWindows windows;
+  ScheduleSegment segments[kMaxScheduleSegments];
+  uint8_t count = 0;
+};
+
+/** Evaluates segment `seg` of `compiled` at `seconds`. */
+inline uint8_t segmentBrightness(const CompiledSchedule &compiled, const ScheduleSegment &seg, uint32_t seconds) {
+  const RoomSchedule &cfg = compiled.cfg;
+  const ScheduleWindows &w = compiled.windows;
+  switch (seg.kind) {
+    case SegmentKind::Constant:
+      return seg.value;
+    case SegmentKind::Sunrise:
+      return clampPercent(sunriseRamp(cfg, w, seconds));
+    case SegmentKind::Dim:
+      return clampPercent(lerpBrightness(seg.value, cfg.nightBrightness, elapsedSince(w.quietRampStart, seconds),
+                                         w.quietRampDuration));
+    case SegmentKind::DimFromSunrise:
+      return clampPercent(lerpBrightness(sunriseRamp(cfg, w, seconds), cfg.nightBrightness,
+                                         elapsedSince(w.quietRampStart, seconds), w.quietRampDuration));
+  }
+  return 0;
+}
+
+/** Determines which formula the reference evaluator applies at `seconds`. */
+inline ScheduleSegment classifySecond(const RoomSchedule &cfg, const ScheduleWindows &w, uint32_t seconds) {
+  ScheduleSegment seg;
+  seg.start = seconds;
+  seg.value = cfg.baselineBrightness;
+  if (cfg.wakeEnabled) {
+    if (w.sunriseDuration == 0) {
+      if (seconds >= w.sunriseTarget) {
+        seg.value = cfg.wakePeakBrightness;
+      }
+    } else if (inWindow(w.sunriseStart, w.sunriseTarget, seconds)) {
+      seg.kind = SegmentKind::Sunrise;
+    } else if (inWindow(w.sunriseTarget, w.sunriseStart, seconds)) {
+      seg.value = cfg.wakePeakBrightness;
+    }
+  }
+  if (cfg.nightEnabled) {
+    bool inQuiet = w.nightStart == w.nightEnd ? seconds >= w.nightStart
+                                              : inWindow(w.nightStart, w.nightEnd, seconds);
+    if (inQuiet) {
+      seg.kind = SegmentKind::Constant;
+      seg.value = cfg.nightBrightness;
+    } else if (w.quietRampDuration > 0 && inWindow(w.quietRampStart, w.nightStart, seconds)) {
+      seg.kind = seg.kind == SegmentKind::Sunrise ? SegmentKind::DimFromSunrise : SegmentKind::Dim;
+    }
+  }
+  if (seg.kind == SegmentKind::Constant) {
+    seg.value = clampPercent(seg.value);
+  }
+  return seg;
+}
+
+/**
+ * Compiles `cfg` into its daily breakpoint table. Every branch of the reference evaluator
+ * only changes at a window edge, so classifying the start of each edge-to-edge interval
+ * describes the whole interval; adjacent equal constants are merged.
+ */
+inline void compileSchedule(const RoomSchedule &cfg, CompiledSchedule &out) {
+  out.cfg = cfg;
+  out.windows = scheduleWindows(cfg);
+  const ScheduleWindows &w = out.windows;
+  uint32_t edges[kMaxScheduleSegments] = {0,
+                                          w.sunriseStart,
+                                          w.sunriseTarget,
+                                          w.nightStart,
+                                          w.nightEnd,
+                                          w.quietRampStart};
+  // Insertion sort of six values; drop duplicates and anything outside the day.
+  uint8_t edgeCount = 0;
+  for (uint32_t edge : edges) {
+    if (edge >= kSecondsPerDay) {
+      continue;
+    }
+    uint8_t pos = edgeCount;
+    bool duplicate = false;
+    for (uint8_t i = 0; i < edgeCount; ++i) {
+      if (edges[i] == edge) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (duplicate) {
+      continue;
+    }
+    while (pos > 0 && edges[pos - 1] > edge) {
+      edges[pos] = edges[pos - 1];
+      --pos;
+    }
+    edges[pos] = edge;
+    ++edgeCount;
+  }
+  out.count = 0;
+  for (uint8_t i = 0; i < edgeCount; ++i) {
+    ScheduleSegment seg = classifySecond(cfg, w, edges[i]);
+    if (out.count > 0) {
+      const ScheduleSegment &prev = out.segments[out.count - 1];
+      if (prev.kind == SegmentKind::Constant && seg.kind == SegmentKind::Constant && prev.value == seg.value) {
+        continue;
+      }
+    }
+    out.segments[out.count++] = seg;
+  }
+}
+
+/** Index of the segment in effect at `seconds` (binary search over the breakpoints). */
+inline uint8_t segmentIndexAt(const CompiledSchedule &compiled, uint32_t seconds) {
+  uint8_t lo = 0;
+  uint8_t hi = compiled.count;
+  while (hi - lo > 1) {
+    uint8_t mid = static_cast<uint8_t>((lo + hi) / 2);
+    if (compiled.segments[mid].start <= seconds) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/** Scheduled brightness at `seconds` since local midnight, via the compiled table. */
+inline uint8_t lookupScheduleBrightness(const CompiledSchedule &compiled, uint32_t seconds) {
+  seconds %= kSecondsPerDay;
+  return segmentBrightness(compiled, compiled.segments[segmentIndexAt(compiled, seconds)], seconds);
+}
+
+/**
+ * Seconds from `seconds` until the scheduled output next differs from its current value
+ * (`kSecondsPerDay` when it never changes). Constant segments are skipped whole; ramps are
+ * stepped second by second, which only happens while a ramp is actually running.
+ */
+inline uint32_t secondsUntilScheduleChange(const CompiledSchedule &compiled, uint32_t seconds) {
+  seconds %= kSecondsPerDay;
+  const uint8_t current = lookupScheduleBrightness(compiled, seconds);
+  uint8_t index = segmentIndexAt(compiled, seconds);
+  uint32_t pos = seconds;
+  uint32_t elapsed = 0;
+  while (elapsed < kSecondsPerDay) {
+    const ScheduleSegment &seg = compiled.segments[index];
+    uint32_t end = (index + 1 < compiled.count) ? compiled.segments[index + 1].start : kSecondsPerDay;
+    if (seg.kind == SegmentKind::Constant) {
+      if (seg.value != current) {
+        return elapsed;
+      }
+      elapsed += end - pos;
+      pos = end;
+    } else {
+      for (; pos < end && elapsed < kSecondsPerDay; ++pos, ++elapsed) {
+        if (segmentBrightness(compiled, seg, pos) != current) {
+          return elapsed;
+        }
+      }
+    }
+    if (++index >= compiled.count) {
+      index = 0;
+      pos = 0;
+    }
+  }
+  return kSecondsPerDay;
+}
+
+/** The part of a ramp segment still ahead of some second: where it ends and how soon. */
+struct ScheduleRamp {
+  uint8_t target = 0;
+  uint32_t durationSec = 0;
+};
+
+/**
+ * Describes the segment in effect at `seconds` as a single fade: `target` is the value on
+ * its last second and `durationSec` the time until then. Constant segments (and the last
+ * second of a ramp) report a zero duration, i.e. a plain step to `target`.
+ */
+inline ScheduleRamp scheduleRampAt(const CompiledSchedule &compiled, uint32_t seconds) {
+  seconds %= kSecondsPerDay;
+  uint8_t index = segmentIndexAt(compiled, seconds);
+  const ScheduleSegment &seg = compiled.segments[index];
+  ScheduleRamp ramp;
+  if (seg.kind == SegmentKind::Constant) {
+    ramp.target = seg.value;
+    return ramp;
+  }
+  uint32_t last = ((index + 1 < compiled.count) ? compiled.segments[index + 1].start : kSecondsPerDay) - 1;
+  ramp.target = segmentBrightness(compiled, seg, last);
+  ramp.durationSec = last - seconds;
+  return ramp;
+}
+
+}  // namespace scheduling
@@ -15,6 +15,12 @@
 #define REDIS_PORT 6379
 #define REDIS_PASSWORD ""
 
+// Change events on the evt:room:{id} pub/sub channel (second connection per device).
+// While subscribed, cfg/override/warning polling stretches to REDIS_EVENTS_FALLBACK_MS.
+#define REDIS_EVENTS_ENABLED 1
+#define REDIS_EVENTS_FALLBACK_MS 300000
+#define REDIS_EVENTS_PING_MS 30000
+
 // Optional overrides for early bring-up. Leave empty to rely on provisioning.
 #define ROOM_ID_OVERRIDE "100"
 #define PROVISIONING_BASE_ID 100
@@ -25,6 +31,35 @@
 // Heartbeat interval for the receiver (must be < kHeartbeatTtlSec from contracts.hpp).
 #define RECEIVER_HEARTBEAT_MS 3000
 
+// Stream wire format for Desired entries (1 = JSON `p` field, 2 = compact `m`/`b`/`v`
+// fields, 3 = compact plus `fade_ms` ramps run on the receiver). The receiver advertises
+// it in room:{id}:wire; senders never write a newer format than SENDER_WIRE_FORMAT.
+#define RECEIVER_WIRE_FORMAT 3
+#define SENDER_WIRE_FORMAT 3
+
+// Receiver fade engine update period (10 ms = 100 Hz).
+#define RECEIVER_FADE_TICK_MS 10
+
+// Stream entries the receiver reads per XREAD (only the newest ver of a batch is applied).
+#define RECEIVER_XREAD_COUNT 16
+
+// Resume the room session (stream cursors, applied versions) after Redis reconnects and
+// warm resets (via RTC memory) instead of re-provisioning and re-reading the snapshot.
+#define RECEIVER_SESSION_RESUME 1
+
+// Fast boot: keep the access point (BSSID/channel), DHCP lease, room id and shown level in
+// flash, relight from it at power-on and rejoin without a scan. STATIC_IP reuses the stored
+// lease instead of asking DHCP (only safe when the router reserves it for this device).
+// The record is rewritten once it has been unchanged for BOOT_SAVE_DELAY_MS.
+#define RECEIVER_FAST_BOOT 1
+#define RECEIVER_FAST_BOOT_STATIC_IP 0
+#define RECEIVER_FAST_CONNECT_TIMEOUT_MS 4000
+#define RECEIVER_BOOT_SAVE_DELAY_MS 60000
+
+// Let the radio modem-sleep between DTIM beacons (saves power, adds up to a beacon
+// interval of command latency). Light sleep is unsupported on the receiver.
+#define RECEIVER_MODEM_SLEEP 0
+
 // Receiver LED pin/polarity (set ACTIVE_LOW when the LED turns on if the pin is driven low).
 #define RECEIVER_LED_PIN D5
 #define RECEIVER_LED_ACTIVE_LOW 0
@@ -47,17 +82,51 @@
 // Quiet-hours + sound monitoring (receiver).
 #define RECEIVER_CFG_REFRESH_MS 30000
 #define RECEIVER_SOUND_SENSOR_PIN A0
+// The sensor is read by a timer every SAMPLE_PERIOD_MS; each SAMPLE_INTERVAL_MS window of
+// readings is reduced to Leq/RMS/peak and the Leq is checked against the threshold.
 #define RECEIVER_SOUND_SAMPLE_INTERVAL_MS 200
-#define RECEIVER_SOUND_AVERAGE_SAMPLES 8
+#define RECEIVER_SOUND_SAMPLE_PERIOD_MS 5
 #define RECEIVER_SOUND_SENSOR_MIN_DB 30.0f
 #define RECEIVER_SOUND_SENSOR_MAX_DB 110.0f
 #define RECEIVER_SOUND_WARNING_THRESHOLD_DB 70.0f
 #define RECEIVER_SOUND_WARNING_COOLDOWN_MS 15000
 
+// Per-minute sound summaries (min/max/mean/p95 of the window Leq) appended to
+// telemetry:room:{id}, flushed BATCH minutes at a time (1-8) and trimmed to ~MAXLEN entries.
+#define RECEIVER_TELEMETRY_ENABLED 1
+#define RECEIVER_TELEMETRY_BATCH 5
+#define RECEIVER_TELEMETRY_MAXLEN 1440
+
+// Serial log level for both boards (see include/log.hpp): LOG_LEVEL_NONE, _ERROR, _WARN,
+// _INFO or _DEBUG. Statements above the level are compiled out. DEBUG adds every PWM
+// write, stream batch and sound analysis window.
+#define LOG_LEVEL LOG_LEVEL_INFO
+// #define LOG_BUFFER_CAPACITY 1024
+
+// Timing/health snapshots (see include/metrics.hpp) written by each device to
+// room:{id}:metrics every interval; 0 disables the instrumentation.
+#define METRICS_ENABLED 1
+#define METRICS_PUBLISH_INTERVAL_MS 60000
+
+// Adaptive polling (see include/scheduler.hpp): cfg/override/warning polls and the
+// receiver's XREAD window shrink 4x right after activity (commands, overrides, warnings,
+// ramps) and grow 4x after IDLE_AFTER_MS without any, one step slower while the smoothed
+// Redis RTT exceeds SLOW_RTT_MS. 0 keeps the base intervals.
+#define SCHED_ADAPTIVE 1
+#define SCHED_IDLE_AFTER_MS 30000
+#define SCHED_SLOW_RTT_MS 150
+
 // ESP sender console + scheduling defaults.
 #define SENDER_CONSOLE_BAUD 115200
 #define SCHEDULE_REFRESH_MS 30000
 #define SCHEDULE_PUBLISH_MIN_INTERVAL_MS 1000
+// Latency budget for coalescing desired/override writes into one pipelined flush.
+#define SENDER_PUBLISH_COALESCE_MS 200
+// Sender power mode for battery backup: 0 = always on, 1 = modem sleep, 2 = light sleep.
+// Modes 1/2 idle between the next scheduled change and other deadlines (at most
+// SLEEP_MAX_MS at a time) and wake on the override button, event traffic or the console.
+#define SENDER_SLEEP_MODE 0
+#define SENDER_SLEEP_MAX_MS 1000
 #define SCHEDULE_DEFAULT_WAKE_HOUR 7
 #define SCHEDULE_DEFAULT_WAKE_MINUTE 0
 #define SCHEDULE_DEFAULT_WAKE_DURATION_MIN 20
@@ -69,6 +138,12 @@
 #define QUIET_HOURS_DIM_MINUTES 90
 #define WAKE_BRIGHTEN_MINUTES 30
 
+// Multi-room mode: schedule-only rooms this sender drives next to ROOM_ID_OVERRIDE/ROOM:
+// (comma-separated, also settable with ROOMS:<id>,<id> on the console). SENDER_MAX_ROOMS
+// bounds the table, including the override room.
+#define SENDER_MAX_ROOMS 8
+#define SENDER_EXTRA_ROOM_IDS ""
+
 // Warning banner duration for the sender display (milliseconds).
 #define SOUND_WARNING_DISPLAY_MS 15000
 
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Compile-time log levels shared by both firmware targets and `redis_link.hpp`. Set
+ * `LOG_LEVEL` in config.h; statements above it expand to nothing, so neither their
+ * format strings nor their arguments cost flash or CPU. Enabled statements print
+ * through `logging::sink()`, which never waits on the UART.
+ *
+ *   LOG_INFO("[redis] connected to %s:%u", host, port);
+ *
+ * Formats live in flash (`PSTR`), use `%S` for `F()`/`PSTR` arguments, and get a newline
+ * appended.
+ */
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#ifndef LOG_BUFFER_CAPACITY
+/** Bytes of log output held while the UART catches up; overflow is dropped and counted. */
+#define LOG_BUFFER_CAPACITY 1024
+#endif
+
+namespace logging {
+
+/**
+ * `Print` that queues output in a fixed ring and hands the UART only as many bytes as
+ * its FIFO has room for, so a burst of logging costs a memcpy instead of blocking
+ * `loop()` at 115200 baud. `pump()` (called from `loop()`) drains the rest.
+ */
+class BufferedSink : public Print {
+ public:
+  explicit BufferedSink(HardwareSerial &out) : out_(out) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t *data, size_t size) override {
+    for (size_t i = 0; i < size; ++i) {
+      if (count_ == kCapacity) {
+        dropped_ += static_cast<uint32_t>(size - i);
+        break;
+      }
+      buffer_[(head_ + count_) % kCapacity] = data[i];
+      ++count_;
+    }
+    pump();
+    return size;
+  }
+
+  /** Moves whatever fits into the UART FIFO; never blocks. */
+  void pump() {
+    while (count_) {
+      int room = out_.availableForWrite();
+      if (room <= 0) {
+        return;
+      }
+      size_t chunk = count_;
+      if (chunk > kCapacity - head_) {
+        chunk = kCapacity - head_;
+      }
+      if (chunk > static_cast<size_t>(room)) {
+        chunk = static_cast<size_t>(room);
+      }
+      out_.write(buffer_ + head_, chunk);
+      head_ = (head_ + chunk) % kCapacity;
+      count_ -= chunk;
+    }
+    if (dropped_ && kCapacity - count_ >= 40) {
+      uint32_t dropped = dropped_;
+      dropped_ = 0;
+      printf_P(PSTR("[log] dropped %lu bytes\n"), static_cast<unsigned long>(dropped));
+    }
+  }
+
+  /** Blocks until everything queued has been written (before a restart or deep sleep). */
+  void flush() override {
+    while (count_) {
+      pump();
+      yield();
+    }
+    out_.flush();
+  }
+
+ private:
+  static constexpr size_t kCapacity = LOG_BUFFER_CAPACITY;
+
+  HardwareSerial &out_;
+  uint8_t buffer_[kCapacity];
+  size_t head_ = 0;
+  size_t count_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+/** The process-wide sink, bound to `Serial`. */
+inline BufferedSink &sink() {
+  static BufferedSink instance(Serial);
+  return instance;
+}
+
+/** Drains queued log output; call once per `loop()`. */
+inline void pump() { sink().pump(); }
+
+}  // namespace logging
+
+/** True when statements at `level` (ERROR, WARN, INFO, DEBUG) are compiled in. */
+#define LOG_ENABLED(level) (LOG_LEVEL >= LOG_LEVEL_##level)
+
+#define LOG_EMIT_(fmt, ...) ::logging::sink().printf_P(PSTR(fmt "\n"), ##__VA_ARGS__)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) LOG_EMIT_(fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) \
+  do {                      \
+  } while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...) LOG_EMIT_(fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...) \
+  do {                     \
+  } while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...) LOG_EMIT_(fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) \
+  do {                     \
+  } while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) LOG_EMIT_(fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...) \
+  do {                      \
+  } while (0)
+#endif
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <pgmspace.h>
+
+#ifndef METRICS_ENABLED
+/** Set to 0 to drop the instrumentation and the periodic `room:{id}:metrics` write. */
+#define METRICS_ENABLED 1
+#endif
+#ifndef METRICS_PUBLISH_INTERVAL_MS
+/** How often each device writes (and then resets) its metrics window. */
+#define METRICS_PUBLISH_INTERVAL_MS 60000
+#endif
+
+/**
+ * Fixed-size timing instrumentation shared by both firmware targets. Everything here is
+ * plain counters in static storage, so recording a sample is a `micros()` read and a
+ * bucket increment; devices summarise each window into a small JSON snapshot (see
+ * `SnapshotWriter`) and start over.
+ */
+namespace metrics {
+
+/**
+ * Log-linear histogram: four buckets per power of two, so a reported percentile (the
+ * bucket's upper edge) overstates the true value by under 25% while the whole table
+ * stays at 76 counters. Values from
+ * 2^20 upwards share the last bucket; the exact maximum is tracked separately.
+ */
+class Histogram {
+ public:
+  static constexpr uint8_t kSubBits = 2;
+  static constexpr uint8_t kSubBuckets = 1 << kSubBits;
+  static constexpr uint8_t kMaxExponent = 20;
+  static constexpr uint8_t kBuckets = kSubBuckets + (kMaxExponent - kSubBits) * kSubBuckets;
+
+  void record(uint32_t value) {
+    ++counts_[bucketOf(value)];
+    ++count_;
+    if (value > max_) {
+      max_ = value;
+    }
+  }
+
+  uint32_t count() const { return count_; }
+  uint32_t max() const { return max_; }
+
+  /** Upper edge of the bucket holding the `pct`-th percentile sample (0 when empty). */
+  uint32_t percentile(uint8_t pct) const {
+    if (!count_) {
+      return 0;
+    }
+    uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(count_) * pct + 99) / 100);
+    if (!rank) {
+      rank = 1;
+    }
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < kBuckets; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        uint32_t edge = i + 1 < kBuckets ? upperEdge(i) : max_;
+        return edge < max_ ? edge : max_;
+      }
+    }
+    return max_;
+  }
+
+  void reset() {
+    memset(counts_, 0, sizeof(counts_));
+    count_ = 0;
+    max_ = 0;
+  }
+
+  /** Bucket index for `value`: exact below 4, then `kSubBuckets` slices per octave. */
+  static uint8_t bucketOf(uint32_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<uint8_t>(value);
+    }
+    uint8_t exponent = static_cast<uint8_t>(31 - __builtin_clz(value));
+    if (exponent >= kMaxExponent) {
+      return kBuckets - 1;
+    }
+    uint8_t slice = static_cast<uint8_t>((value >> (exponent - kSubBits)) & (kSubBuckets - 1));
+    return static_cast<uint8_t>(kSubBuckets + (exponent - kSubBits) * kSubBuckets + slice);
+  }
+
+  /** Largest value that lands in bucket `index`. */
+  static uint32_t upperEdge(uint8_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    uint8_t exponent = static_cast<uint8_t>(kSubBits + (index - kSubBuckets) / kSubBuckets);
+    uint32_t width = 1UL << (exponent - kSubBits);
+    uint32_t lower = (kSubBuckets + (index - kSubBuckets) % kSubBuckets) * width;
+    return lower + width - 1;
+  }
+
+ private:
+  uint32_t counts_[kBuckets] = {};
+  uint32_t count_ = 0;
+  uint32_t max_ = 0;
+};
+
+/** Command classes `RedisLink` times separately; `None` marks commands it ignores. */
+enum class RttKind : uint8_t { Read, Write, Script, Pipeline, Count, None = Count };
+
+constexpr uint8_t kRttKinds = static_cast<uint8_t>(RttKind::Count);
+
+/**
+ * Round-trip times (request written → first reply byte, in microseconds) collected by
+ * every `RedisLink` the device attaches it to. Blocking reads and pub/sub traffic are
+ * not timed, since their latency is the server's wait rather than the network's.
+ */
+struct LinkMetrics {
+  Histogram rttUs[kRttKinds];
+
+  Histogram &rtt(RttKind kind) { return rttUs[static_cast<uint8_t>(kind)]; }
+
+  void reset() {
+    for (Histogram &h : rttUs) {
+      h.reset();
+    }
+  }
+};
+
+/** Short snapshot name for each `RttKind`. */
+inline const char *rttKindName(uint8_t index) {
+  static const char *const kNames[kRttKinds] = {"read", "write", "script", "pipeline"};
+  return index < kRttKinds ? kNames[index] : "";
+}
+
+/**
+ * Records the gap between consecutive `tick()` calls, i.e. how long one pass of
+ * `loop()` kept everything else waiting.
+ */
+class LoopTimer {
+ public:
+  void tick(Histogram &into) {
+    uint32_t now = micros();
+    if (started_) {
+      into.record(now - lastUs_);
+    }
+    lastUs_ = now;
+    started_ = true;
+  }
+
+ private:
+  uint32_t lastUs_ = 0;
+  bool started_ = false;
+};
+
+/**
+ * Builds a compact JSON object in a fixed buffer. Formats are flash strings (`PSTR`);
+ * `ok()` turns false once anything was cut off, and the caller then skips the write.
+ */
+class SnapshotWriter {
+ public:
+  SnapshotWriter(char *buffer, size_t capacity) : buffer_(buffer), capacity_(capacity) {
+    if (capacity_) {
+      buffer_[0] = '\0';
+    }
+  }
+
+  void appendf(const char *fmt, ...) {
+    if (len_ >= capacity_) {
+      overflow_ = true;
+      return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int written = vsnprintf_P(buffer_ + len_, capacity_ - len_, fmt, args);
+    va_end(args);
+    if (written < 0 || static_cast<size_t>(written) >= capacity_ - len_) {
+      overflow_ = true;
+      len_ = capacity_;
+      return;
+    }
+    len_ += static_cast<size_t>(written);
+  }
+
+  /** Appends `"name":{"n":..,"p50":..,"p95":..,"p99":..,"max":..}` (no leading comma). */
+  void histogram(const char *name, const Histogram &h) {
+    appendf(PSTR("\"%s\":{\"n\":%lu,\"p50\":%lu,\"p95\":%lu,\"p99\":%lu,\"max\":%lu}"), name,
+            static_cast<unsigned long>(h.count()), static_cast<unsigned long>(h.percentile(50)),
+            static_cast<unsigned long>(h.percentile(95)), static_cast<unsigned long>(h.percentile(99)),
+            static_cast<unsigned long>(h.max()));
+  }
+
+  /** Appends `"rtt_us":{"read":{..},...}` for the kinds that saw traffic. */
+  void rtt(const LinkMetrics &link) {
+    appendf(PSTR("\"rtt_us\":{"));
+    bool first = true;
+    for (uint8_t i = 0; i < kRttKinds; ++i) {
+      if (!link.rttUs[i].count()) {
+        continue;
+      }
+      if (!first) {
+        appendf(PSTR(","));
+      }
+      histogram(rttKindName(i), link.rttUs[i]);
+      first = false;
+    }
+    appendf(PSTR("}"));
+  }
+
+  bool ok() const { return !overflow_; }
+  const char *c_str() const { return buffer_; }
+
+ private:
+  char *buffer_;
+  size_t capacity_;
+  size_t len_ = 0;
+  bool overflow_ = false;
+};
+
+}  // namespace metrics
@@ -6,24 +6,79 @@
 #include <initializer_list>
 #include <pgmspace.h>
 
+#include "log.hpp"
+#include "metrics.hpp"
+
+#ifndef REDIS_LINK_FRAME_CAPACITY
+/** Bytes reserved per link for encoding outgoing RESP frames before a single write(). */
+#define REDIS_LINK_FRAME_CAPACITY 256
+#endif
+
 /**
  * Minimal RESP (Redis Serialization Protocol) helper tailored for this demo.
  * It intentionally avoids heap allocations inside tight loops and only
- * implements the commands we rely upon in the firmware.
+ * implements the commands we rely upon in the firmware. Outgoing commands are
+ * encoded into a fixed frame buffer so each one leaves in a single write().
  */
 class RedisLink {
  public:
   /**
    * Constructs a RedisLink that will operate over the provided Client implementation.
    */
-  explicit RedisLink(Client &client) : client_(client) {
-    lineBuffer_.reserve(64);
-  }
+  explicit RedisLink(Client &client) : client_(client) {}
+
+  /** Upper bound on the number of commands in flight inside one pipeline. */
+  static constexpr uint8_t kMaxPipelineDepth = 8;
+
+  /** Buffer size that fits any stream entry id (`<ms>-<seq>`, two 64-bit numbers). */
+  static constexpr size_t kStreamIdCapacity = 42;
+
+  /**
+   * Non-owning key, stream or channel name. Converts from a C string, a `String`, or any
+   * buffer with `c_str()`/`length()` such as the prebuilt `contracts::RoomKeys`, so
+   * callers holding fixed names pay no allocation per command. The name must outlive
+   * the call (or, for `beginXreadStreams()`, just the send).
+   */
+  struct KeyView {
+    const char *data;
+    size_t len;
+    KeyView() : data(""), len(0) {}
+    KeyView(const char *c) : data(c), len(strlen(c)) {}
+    KeyView(const char *c, size_t n) : data(c), len(n) {}
+    template <typename Text, typename = decltype(static_cast<const Text *>(nullptr)->length())>
+    KeyView(const Text &text) : data(text.c_str()), len(text.length()) {}
+  };
+
+  /**
+   * No-op base for the visitors handed to the streaming stream-reply parsers. Derived
+   * visitors override (hide) the hooks they need: `stream()` names the stream whose
+   * entries follow (truncated to 47 bytes) and `streamAt()` gives
+   * its position in the `XREAD` request (`kUnknownStream` if it matches none),
+   * `entry()` returns false to skip an entry's fields, `field()` returns the buffer (and
+   * its capacity) that should receive a value or nullptr to skip it, and `entryDone()`
+   * reports whether every kept value fit its buffer.
+   */
+  struct StreamVisitor {
+    void stream(const char *) {}
+    void streamAt(uint8_t) {}
+    bool entry(const char *) { return true; }
+    char *field(const char *, size_t &) { return nullptr; }
+    void entryDone(bool) {}
+  };
 
   /** Returns true when the underlying TCP client is still connected. */
   bool connected() const { return client_.connected(); }
-  /** Immediately closes the underlying connection. */
-  void stop() { client_.stop(); }
+  /** Immediately closes the underlying connection (abandoning any async request). */
+  void stop() {
+    asyncPending_ = false;
+    client_.stop();
+  }
+
+  /**
+   * Starts timing this link's round trips into `metrics` (nullptr stops). Several links
+   * may share one `LinkMetrics`.
+   */
+  void attachMetrics(metrics::LinkMetrics *metrics) { metrics_ = metrics; }
 
   /**
    * Updates the read timeout (milliseconds) used by blocking RESP operations.
@@ -48,17 +103,49 @@ class RedisLink {
   /** Sends a `PING` round-trip to verify liveness. */
   bool ping() { return sendSimpleStatus({"PING"}); }
 
+  /**
+   * Fetches `INFO <section>` (e.g. `memory`, `persistence`, `stats`) as the raw
+   * `field:value` text. Host tools only; the firmware never needs it.
+   */
+  bool info(const char *section, String &out) {
+    return sendCommand({RedisArg("INFO"), RedisArg(section)}) && readBulkString(out);
+  }
+
+  /** `MEMORY USAGE key SAMPLES 0` (exact, every element counted); 0 for a missing key. */
+  bool memoryUsage(const KeyView &key, long &bytes) {
+    if (!sendCommand({RedisArg("MEMORY"), RedisArg("USAGE"), RedisArg(key), RedisArg("SAMPLES"), RedisArg("0")})) {
+      return false;
+    }
+    char type;
+    if (!readType(type)) {
+      return false;
+    }
+    if (type == ':') {
+      bytes = strtol(line_, nullptr, 10);
+      return true;
+    }
+    if (type == '$' && strtol(line_, nullptr, 10) < 0) {
+      bytes = 0;  // nil: no such key
+      return true;
+    }
+    noteUnexpectedReply(type);
+    return false;
+  }
+
+  /** Starts `BGREWRITEAOF`; `INFO persistence` reports when it finished. */
+  bool bgRewriteAof() { return sendSimpleStatus({"BGREWRITEAOF"}); }
+
   /**
    * Executes `SET key value` to overwrite a Redis string.
    */
-  bool set(const String &key, const String &value) {
+  bool set(const KeyView &key, const String &value) {
     return sendSimpleStatus({RedisArg("SET"), RedisArg(key), RedisArg(value)});
   }
 
   /**
    * Executes `GET key` and stores the response. When `isNull` is supplied it reports nil replies.
    */
-  bool get(const String &key, String &out, bool *isNull = nullptr) {
+  bool get(const KeyView &key, String &out, bool *isNull = nullptr) {
     if (!sendCommand({RedisArg("GET"), RedisArg(key)})) {
       return false;
     }
@@ -66,7 +153,7 @@ class RedisLink {
   }
 
   /** Sets an expire TTL (seconds) for the given key. */
-  bool expire(const String &key, uint16_t ttlSec) {
+  bool expire(const KeyView &key, uint16_t ttlSec) {
     char ttl[6];
     snprintf(ttl, sizeof(ttl), "%u", ttlSec);
     return sendIntegerEqualsOne({RedisArg("EXPIRE"), RedisArg(key), RedisArg(ttl)});
@@ -87,51 +174,203 @@ class RedisLink {
     return readBulkString(roomId);
   }
 
+  /**
+   * Runs the shared snapshot + stream publish script (see `contracts::kPublishScript`) with
+   * `EVALSHA`. The script is loaded once via `SCRIPT LOAD` and reloaded transparently when
+   * the server reports `NOSCRIPT` (e.g. after a Redis restart). `storedVer` receives the
+   * script's result: `ver` when it wrote, otherwise the lowest version `key` would accept
+   * (the write was stale). When `streamFields` is set, its `fieldCount` name/value strings
+   * are appended to the stream instead of the JSON `p` field (the compact wire format).
+   * `acceptSameVer` also lets a `ver` equal to the stored one through.
+   */
+  bool evalPublishScript(const __FlashStringHelper *script,
+                         const KeyView &key,
+                         const KeyView &stream,
+                         const String &payload,
+                         uint32_t ver,
+                         uint16_t maxLen,
+                         uint32_t &storedVer,
+                         const char *const *streamFields = nullptr,
+                         uint8_t fieldCount = 0,
+                         bool acceptSameVer = false) {
+    PublishArgs publish;
+    if (!buildPublishArgs(publish, key, stream, payload, ver, maxLen, streamFields, fieldCount, acceptSameVer)) {
+      return false;
+    }
+    for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+      if (!loadPublishScript(script)) {
+        return false;
+      }
+      long value = 0;
+      if (sendCommand(publish.args, publish.count) && readInteger(value)) {
+        storedVer = static_cast<uint32_t>(value);
+        return true;
+      }
+      if (!lastReplyWasError_ || !lastError_.startsWith("NOSCRIPT")) {
+        return false;
+      }
+      publishShaValid_ = false;
+    }
+    return false;
+  }
+
+  /**
+   * Makes sure the publish script is registered (`SCRIPT LOAD` on first use or after a
+   * `NOSCRIPT`). Pipelines call this before queueing `queueEvalPublish()`.
+   */
+  bool loadPublishScript(const __FlashStringHelper *script) {
+    if (publishShaValid_) {
+      return true;
+    }
+    publishShaValid_ = scriptLoad(script, publishSha_);
+    return publishShaValid_;
+  }
+
   /**
    * Appends a JSON payload to the provided stream with the field name `p`.
    */
-  bool xaddJson(const String &stream, const String &payload) {
+  bool xaddJson(const KeyView &stream, const String &payload) {
     return sendBulkOnly({RedisArg("XADD"), RedisArg(stream), RedisArg("*"), RedisArg("p"), RedisArg(payload)});
   }
 
   /**
    * Soft-trims a stream (`XTRIM MAXLEN ~`) to bound Redis memory usage.
    */
-  bool xtrimApprox(const String &stream, uint16_t maxLen) {
+  bool xtrimApprox(const KeyView &stream, uint16_t maxLen) {
     char lenStr[8];
     snprintf(lenStr, sizeof(lenStr), "%u", maxLen);
     return sendIntegerConsume({RedisArg("XTRIM"), RedisArg(stream), RedisArg("MAXLEN"), RedisArg("~"), RedisArg(lenStr)});
   }
 
+  /** Most streams a single `xreadStreams()` call can multiplex. */
+  static constexpr uint8_t kMaxXreadStreams = 4;
+  /** `streamAt()` index for a reply stream that matches no requested key. */
+  static constexpr uint8_t kUnknownStream = 0xff;
+
+  /**
+   * Performs `XREAD [BLOCK blockMs] COUNT count STREAMS ...` across `streamCount` streams,
+   * each read after its own `sinceIds[i]`, and streams every returned entry into
+   * `visitor` (see `StreamVisitor`; `stream()` and `streamAt()` announce which stream
+   * the following entries belong to). `blockMs == 0` polls without blocking. Returns false on transport
+   * or server errors only; a timeout is a successful read that visited nothing.
+   */
+  template <typename Visitor>
+  bool xreadStreams(const KeyView *streams,
+                    const char *const *sinceIds,
+                    uint8_t streamCount,
+                    uint16_t blockMs,
+                    uint8_t count,
+                    Visitor &visitor) {
+    if (!sendXread(streams, sinceIds, streamCount, blockMs, count)) {
+      return false;
+    }
+    return readXreadReply(visitor);
+  }
+
+  /** Single-stream form of `xreadStreams()`. */
+  template <typename Visitor>
+  bool xread(const KeyView &stream, uint16_t blockMs, const char *sinceId, uint8_t count, Visitor &visitor) {
+    return xreadStreams(&stream, &sinceId, 1, blockMs, count, visitor);
+  }
+
+  /** Progress of the asynchronous request started with `beginXreadStreams()`. */
+  enum class AsyncResult : uint8_t { Pending, Done, Failed };
+
+  /**
+   * Sends the same `XREAD` as `xreadStreams()` but returns without waiting for the reply,
+   * so the caller's loop keeps running while the server blocks. Until `pollXread()`
+   * reports `Done` or `Failed` no other command may be issued on this link (they fail
+   * with "async request pending"); `asyncPending()` tells callers when to hold off.
+   */
+  bool beginXreadStreams(const KeyView *streams,
+                         const char *const *sinceIds,
+                         uint8_t streamCount,
+                         uint16_t blockMs,
+                         uint8_t count) {
+    if (!sendXread(streams, sinceIds, streamCount, blockMs, count)) {
+      return false;
+    }
+    asyncPending_ = true;
+    asyncStartMs_ = millis();
+    asyncBudgetMs_ = static_cast<unsigned long>(blockMs) + timeoutMs_;
+    return true;
+  }
+
+  /**
+   * Checks on the request started by `beginXreadStreams()` without blocking while no
+   * reply bytes have arrived. Once the reply starts it is parsed into `visitor` in one
+   * go (the remainder follows within the same few TCP segments). The server-side block
+   * plus the link timeout bounds how long a request may stay `Pending`.
+   */
+  template <typename Visitor>
+  AsyncResult pollXread(Visitor &visitor) {
+    if (!asyncPending_) {
+      lastError_ = F("no async request");
+      return AsyncResult::Failed;
+    }
+    if (!client_.available()) {
+      if (!client_.connected()) {
+        asyncPending_ = false;
+        lastError_ = F("redis closed");
+        return AsyncResult::Failed;
+      }
+      if (millis() - asyncStartMs_ > asyncBudgetMs_) {
+        asyncPending_ = false;
+        lastError_ = F("redis timeout");
+        return AsyncResult::Failed;
+      }
+      return AsyncResult::Pending;
+    }
+    asyncPending_ = false;
+    return readXreadReply(visitor) ? AsyncResult::Done : AsyncResult::Failed;
+  }
+
+  /** True while an asynchronous request owns the link. */
+  bool asyncPending() const { return asyncPending_; }
+
+  /**
+   * Smoothed round-trip time (microseconds, 1/8 gain like TCP's SRTT) of the commands
+   * `attachMetrics()` would time, tracked with or without metrics; 0 before any reply.
+   */
+  uint32_t smoothedRttUs() const { return srttUs_; }
+
   /**
    * Performs an `XREAD` from `stream`, blocking for up to `blockMs` until a new entry appears.
-   * Stores the record id and payload when a command is delivered.
+   * Copies the record id and `p` payload into the caller's buffers when a command is
+   * delivered; the reply is parsed in place, so no heap allocations happen per message.
+   * Returns false both on timeout and on error; check `lastError()` to tell them apart.
    */
-  bool xreadLatest(const String &stream,
+  bool xreadLatest(const KeyView &stream,
                    uint16_t blockMs,
-                   const String &sinceId,
-                   String &entryId,
-                   String &payload) {
-    char block[8];
-    snprintf(block, sizeof(block), "%u", blockMs);
-    if (!sendCommand({RedisArg("XREAD"),
-                      RedisArg("BLOCK"),
-                      RedisArg(block),
-                      RedisArg("COUNT"),
-                      RedisArg("1"),
-                      RedisArg("STREAMS"),
-                      RedisArg(stream),
-                      RedisArg(sinceId)})) {
+                   const char *sinceId,
+                   char *entryId,
+                   size_t entryIdCap,
+                   char *payload,
+                   size_t payloadCap) {
+    PayloadVisitor visitor(entryId, entryIdCap, payload, payloadCap);
+    if (!xread(stream, blockMs, sinceId, 1, visitor)) {
       return false;
     }
-    entryId.remove(0);
-    return readXreadPayload(entryId, payload);
+    return visitor.found;
   }
 
   /**
    * Reads the latest stream entry id using `XREVRANGE` so consumers can resume at the tail.
+   * `entryId` is left empty when the stream has no entries.
+   */
+  bool streamTailId(const KeyView &stream, char *entryId, size_t entryIdCap) {
+    entryId[0] = '\0';
+    TailIdVisitor visitor(entryId, entryIdCap);
+    return streamTail(stream, visitor);
+  }
+
+  /**
+   * Streams the newest entry of `stream` (`XREVRANGE + - COUNT 1`) into `visitor`; an
+   * empty stream visits nothing. Unlike `XREAD` the reply names no stream, so
+   * `visitor.stream()` is not called.
    */
-  bool streamTailId(const String &stream, String &entryId) {
+  template <typename Visitor>
+  bool streamTail(const KeyView &stream, Visitor &visitor) {
     if (!sendCommand({RedisArg("XREVRANGE"),
                       RedisArg(stream),
                       RedisArg("+"),
@@ -140,18 +379,268 @@ class RedisLink {
                       RedisArg("1")})) {
       return false;
     }
-    return readXrevrangeTail(entryId);
+    return readStreamEntries(visitor);
+  }
+
+  /** Issues `PUBLISH channel message`; `receivers` gets the subscriber count when supplied. */
+  bool publish(const KeyView &channel, const char *message, long *receivers = nullptr) {
+    return sendIntegerCommand({RedisArg("PUBLISH"), RedisArg(channel), RedisArg(message)}, receivers);
+  }
+
+  /** Most channels a single `subscribe()` call accepts. */
+  static constexpr uint8_t kMaxSubscribeChannels = 8;
+
+  /** Outcome of `pollMessage()`. */
+  enum class PollResult : uint8_t { Idle, Message, Control, Failed };
+
+  /**
+   * Switches the connection into pub/sub mode with `SUBSCRIBE` and waits until every
+   * channel is confirmed. Afterwards only `pollMessage()` and `subscriberPing()` may be
+   * used on this link; `stop()` is the way out of subscriber mode.
+   */
+  bool subscribe(const KeyView *channels, uint8_t count) {
+    if (!count || count > kMaxSubscribeChannels) {
+      lastError_ = F("bad channel count");
+      return false;
+    }
+    RedisArg args[1 + kMaxSubscribeChannels];
+    args[0] = RedisArg("SUBSCRIBE");
+    for (uint8_t i = 0; i < count; ++i) {
+      args[1 + i] = RedisArg(channels[i]);
+    }
+    if (!sendCommand(args, 1 + count)) {
+      return false;
+    }
+    uint8_t confirmed = 0;
+    while (confirmed < count) {
+      char kind[16];
+      char channel[kStreamNameCapacity];
+      char payload[8];
+      if (!readPush(kind, sizeof(kind), channel, sizeof(channel), payload, sizeof(payload))) {
+        return false;
+      }
+      // Messages on already-confirmed channels can interleave; callers resync anyway.
+      if (strcmp(kind, "subscribe") == 0) {
+        ++confirmed;
+      }
+    }
+    return true;
+  }
+
+  /** Sends a pub/sub-mode `PING`; its `pong` push is consumed by `pollMessage()`. */
+  bool subscriberPing() {
+    bool sent = sendCommand({"PING"});
+    // The pong is only read when the caller next polls, so its delay is not an RTT.
+    rttKind_ = metrics::RttKind::None;
+    return sent;
+  }
+
+  /**
+   * Reads one push from a subscribed link without blocking when nothing is buffered.
+   * Returns `Message` with `channel`/`payload` filled (truncated to their buffers) for a
+   * published message, `Control` for a `pong` or (un)subscribe confirmation, `Idle` when
+   * no data was waiting, and `Failed` when the link broke (see `lastError()`).
+   */
+  PollResult pollMessage(char *channel, size_t channelCap, char *payload, size_t payloadCap) {
+    if (!client_.available()) {
+      return connected() ? PollResult::Idle : PollResult::Failed;
+    }
+    char kind[16];
+    if (!readPush(kind, sizeof(kind), channel, channelCap, payload, payloadCap)) {
+      return PollResult::Failed;
+    }
+    return strcmp(kind, "message") == 0 ? PollResult::Message : PollResult::Control;
   }
 
   /**
    * Writes a simple heartbeat key with an `EX` TTL so monitoring can detect offline devices.
    */
-  bool setHeartbeat(const String &key, uint16_t ttlSec) {
+  bool setHeartbeat(const KeyView &key, uint16_t ttlSec) {
     char ttl[6];
     snprintf(ttl, sizeof(ttl), "%u", ttlSec);
     return sendSimpleStatus({RedisArg("SET"), RedisArg(key), RedisArg("1"), RedisArg("EX"), RedisArg(ttl)});
   }
 
+  /**
+   * Starts a pipelined batch. Commands queued with the `queue*()` helpers are written
+   * back-to-back without waiting for replies; `execPipeline()` flushes them and reads
+   * every reply in order, so a batch costs a single round-trip.
+   */
+  void beginPipeline() {
+    lastError_.remove(0);
+    pipelining_ = true;
+    pendingCount_ = 0;
+    pipelineBroken_ = false;
+    frameLen_ = 0;
+    writeFailed_ = false;
+  }
+
+  /** Queues `AUTH password` (skipped when no password is configured). */
+  bool queueAuth(const char *password) {
+    if (!password || !password[0]) {
+      return true;
+    }
+    return queueCommand({"AUTH", password}, ReplyKind::Status);
+  }
+
+  /** Queues a `PING`. */
+  bool queuePing() { return queueCommand({"PING"}, ReplyKind::Status); }
+
+  /** Queues `SET key value`. */
+  bool queueSet(const KeyView &key, const String &value) {
+    return queueCommand({RedisArg("SET"), RedisArg(key), RedisArg(value)}, ReplyKind::Status);
+  }
+
+  /**
+   * Queues `GET key`; `out` (and `isNull` when supplied) are filled by `execPipeline()`.
+   */
+  bool queueGet(const KeyView &key, String &out, bool *isNull = nullptr) {
+    return queueCommand({RedisArg("GET"), RedisArg(key)}, ReplyKind::Bulk, &out, isNull);
+  }
+
+  /** Queues an `XADD stream * p payload`. */
+  bool queueXaddJson(const KeyView &stream, const String &payload) {
+    return queueCommand({RedisArg("XADD"), RedisArg(stream), RedisArg("*"), RedisArg("p"), RedisArg(payload)},
+                        ReplyKind::Bulk);
+  }
+
+  /** Most field/value strings `queueXadd()` accepts per entry. */
+  static constexpr uint8_t kMaxXaddFields = 16;
+
+  /**
+   * Queues `XADD stream MAXLEN ~ maxLen * <fields...>` with `fieldCount` name/value
+   * strings, so each append also keeps the stream trimmed.
+   */
+  bool queueXadd(const KeyView &stream, uint16_t maxLen, const char *const *fields, uint8_t fieldCount) {
+    if (!fieldCount || fieldCount > kMaxXaddFields || (fieldCount % 2) != 0) {
+      lastError_ = F("bad xadd fields");
+      pipelineBroken_ = true;
+      return false;
+    }
+    char lenStr[8];
+    snprintf(lenStr, sizeof(lenStr), "%u", maxLen);
+    RedisArg args[6 + kMaxXaddFields];
+    size_t argc = 0;
+    args[argc++] = RedisArg("XADD");
+    args[argc++] = RedisArg(stream);
+    args[argc++] = RedisArg("MAXLEN");
+    args[argc++] = RedisArg("~");
+    args[argc++] = RedisArg(lenStr);
+    args[argc++] = RedisArg("*");
+    for (uint8_t i = 0; i < fieldCount; ++i) {
+      args[argc++] = RedisArg(fields[i]);
+    }
+    return queueCommand(args, argc, ReplyKind::Bulk, nullptr, nullptr, nullptr);
+  }
+
+  /** Queues an `XTRIM stream MAXLEN ~ maxLen`. */
+  bool queueXtrimApprox(const KeyView &stream, uint16_t maxLen) {
+    char lenStr[8];
+    snprintf(lenStr, sizeof(lenStr), "%u", maxLen);
+    return queueCommand({RedisArg("XTRIM"), RedisArg(stream), RedisArg("MAXLEN"), RedisArg("~"), RedisArg(lenStr)},
+                        ReplyKind::Integer);
+  }
+
+  /** Queues `HSET key field value`. */
+  bool queueHset(const KeyView &key, const char *field, const char *value) {
+    return queueCommand({RedisArg("HSET"), RedisArg(key), RedisArg(field), RedisArg(value)}, ReplyKind::Integer);
+  }
+
+  /** Queues `EXPIRE key ttl`. */
+  bool queueExpire(const KeyView &key, uint16_t ttlSec) {
+    char ttl[6];
+    snprintf(ttl, sizeof(ttl), "%u", ttlSec);
+    return queueCommand({RedisArg("EXPIRE"), RedisArg(key), RedisArg(ttl)}, ReplyKind::Integer);
+  }
+
+  /** Queues `PUBLISH channel message`. */
+  bool queuePublish(const KeyView &channel, const char *message) {
+    return queueCommand({RedisArg("PUBLISH"), RedisArg(channel), RedisArg(message)}, ReplyKind::Integer);
+  }
+
+  /** Queues a heartbeat `SET key 1 EX ttl`. */
+  bool queueSetHeartbeat(const KeyView &key, uint16_t ttlSec) {
+    char ttl[6];
+    snprintf(ttl, sizeof(ttl), "%u", ttlSec);
+    return queueCommand({RedisArg("SET"), RedisArg(key), RedisArg("1"), RedisArg("EX"), RedisArg(ttl)},
+                        ReplyKind::Status);
+  }
+
+  /**
+   * Queues the publish script (see `evalPublishScript()`); `storedVer` receives the
+   * script's result once `execPipeline()` succeeds. `loadPublishScript()` must have
+   * succeeded first; a `NOSCRIPT` reply fails the batch and forces a reload next time.
+   */
+  bool queueEvalPublish(const KeyView &key,
+                        const KeyView &stream,
+                        const String &payload,
+                        uint32_t ver,
+                        uint16_t maxLen,
+                        long &storedVer,
+                        const char *const *streamFields = nullptr,
+                        uint8_t fieldCount = 0,
+                        bool acceptSameVer = false) {
+    PublishArgs publish;
+    if (!publishShaValid_) {
+      lastError_ = F("publish script not loaded");
+      pipelineBroken_ = true;
+      return false;
+    }
+    if (!buildPublishArgs(publish, key, stream, payload, ver, maxLen, streamFields, fieldCount, acceptSameVer)) {
+      pipelineBroken_ = true;
+      return false;
+    }
+    return queueCommand(publish.args, publish.count, ReplyKind::Integer, nullptr, nullptr, &storedVer);
+  }
+
+  /**
+   * Flushes the queued batch and consumes every reply in order. Returns true only when
+   * every command was queued and succeeded; replies of commands already written are
+   * drained even after an error reply so the connection stays in sync, and
+   * `lastError()` keeps the first failure.
+   */
+  bool execPipeline() {
+    pipelining_ = false;
+    uint8_t count = pendingCount_;
+    pendingCount_ = 0;
+    bool ok = !pipelineBroken_;
+    pipelineBroken_ = false;
+    String firstError;
+    if (!ok) {
+      firstError = lastError_;
+    }
+    if (!count) {
+      frameLen_ = 0;
+      return ok;
+    }
+    if (!flushFrame()) {
+      lastError_ = F("redis write failed");
+      return false;
+    }
+    client_.flush();
+    armRtt(metrics::RttKind::Pipeline);
+    for (uint8_t i = 0; i < count; ++i) {
+      if (readPendingReply(pending_[i])) {
+        continue;
+      }
+      if (ok) {
+        firstError = lastError_;
+      }
+      ok = false;
+      if (!lastReplyWasError_) {
+        // Transport failure or unexpected reply type: later replies can't be trusted.
+        break;
+      }
+    }
+    if (!ok) {
+      lastError_ = firstError;
+      if (lastError_.startsWith("NOSCRIPT")) {
+        publishShaValid_ = false;
+      }
+    }
+    return ok;
+  }
+
   /** Holds the last Redis protocol error string for debugging. */
   const String &lastError() const { return lastError_; }
 
@@ -163,6 +652,11 @@ class RedisLink {
     const uint8_t *data;
     size_t len;
     bool progmem;
+    RedisArg() : data(nullptr), len(0), progmem(false) {}
+    RedisArg(const char *c, size_t n)
+        : data(reinterpret_cast<const uint8_t *>(c)),
+          len(n),
+          progmem(false) {}
     RedisArg(const char *c)
         : data(reinterpret_cast<const uint8_t *>(c)),
           len(strlen(c)),
@@ -171,6 +665,10 @@ class RedisLink {
         : data(reinterpret_cast<const uint8_t *>(s.c_str())),
           len(s.length()),
           progmem(false) {}
+    RedisArg(const KeyView &k)
+        : data(reinterpret_cast<const uint8_t *>(k.data)),
+          len(k.len),
+          progmem(false) {}
     RedisArg(const __FlashStringHelper *fs) {
       data = reinterpret_cast<const uint8_t *>(fs);
       len = strlen_P(reinterpret_cast<const char *>(fs));
@@ -178,40 +676,380 @@ class RedisLink {
     }
   };
 
+  /** Reply shape expected for a command queued inside a pipeline. */
+  enum class ReplyKind : uint8_t { Status, Integer, Bulk };
+
+  /** Book-keeping for a queued command whose reply has not been read yet. */
+  struct PendingReply {
+    ReplyKind kind = ReplyKind::Status;
+    String *out = nullptr;
+    bool *isNull = nullptr;
+    long *number = nullptr;
+  };
+
+  /** Most extra stream field/value strings `evalPublishScript` forwards to the script. */
+  static constexpr uint8_t kMaxPublishFields = 8;
+
+  /** Argument vector (and the numeric strings it points at) for one publish-script call. */
+  struct PublishArgs {
+    char ver[12];
+    char maxLen[8];
+    RedisArg args[9 + kMaxPublishFields];
+    uint8_t count = 0;
+  };
+
+  /** Length of a hex SHA1 digest as returned by `SCRIPT LOAD`. */
+  static constexpr size_t kScriptShaLen = 40;
+  /** Size of the outgoing frame buffer; larger frames are streamed in buffer-sized chunks. */
+  static constexpr size_t kFrameCapacity = REDIS_LINK_FRAME_CAPACITY;
+  static_assert(kFrameCapacity >= 32, "REDIS_LINK_FRAME_CAPACITY is too small");
+
+  /** Longest RESP header/status line kept verbatim (longer error text is truncated). */
+  static constexpr size_t kLineCapacity = 96;
+  /** Longest stream key kept while parsing `XREAD` replies. */
+  static constexpr size_t kStreamNameCapacity = 48;
+  /** Longest stream field name kept while parsing entries. */
+  static constexpr size_t kFieldNameCapacity = 16;
+
+  /**
+   * Length and FNV-1a hash of a stream key. `sendXread()` records one per requested
+   * stream so reply streams map back to their request position whatever their length,
+   * and without keeping pointers into the caller's (often stack-local) key array.
+   */
+  struct KeyPrint {
+    size_t len = 0;
+    uint32_t hash = 2166136261UL;
+    void add(const char *bytes, size_t n) {
+      for (size_t i = 0; i < n; ++i) {
+        hash ^= static_cast<uint8_t>(bytes[i]);
+        hash *= 16777619UL;
+      }
+      len += n;
+    }
+    bool operator==(const KeyPrint &other) const { return len == other.len && hash == other.hash; }
+  };
+
   Client &client_;
-  String lineBuffer_;
+  char line_[kLineCapacity] = {};
+  size_t lineLen_ = 0;
   String lastError_;
   uint16_t timeoutMs_ = 1500;
+  char publishSha_[kScriptShaLen + 1] = {};
+  bool publishShaValid_ = false;
+  uint8_t frame_[kFrameCapacity];
+  size_t frameLen_ = 0;
+  bool writeFailed_ = false;
+  PendingReply pending_[kMaxPipelineDepth];
+  uint8_t pendingCount_ = 0;
+  bool pipelining_ = false;
+  bool pipelineBroken_ = false;
+  bool lastReplyWasError_ = false;
+  bool asyncPending_ = false;
+  unsigned long asyncStartMs_ = 0;
+  unsigned long asyncBudgetMs_ = 0;
+  metrics::LinkMetrics *metrics_ = nullptr;
+  metrics::RttKind rttKind_ = metrics::RttKind::None;
+  uint32_t rttStartUs_ = 0;
+  uint32_t srttUs_ = 0;
+  KeyPrint xreadKeys_[kMaxXreadStreams];
+  uint8_t xreadKeyCount_ = 0;
+
+  /** Encodes and sends `XREAD [BLOCK ms] COUNT n STREAMS <streams...> <ids...>`. */
+  bool sendXread(const KeyView *streams,
+                 const char *const *sinceIds,
+                 uint8_t streamCount,
+                 uint16_t blockMs,
+                 uint8_t count) {
+    if (!streamCount || streamCount > kMaxXreadStreams) {
+      lastError_ = F("bad xread stream count");
+      return false;
+    }
+    char block[8];
+    snprintf(block, sizeof(block), "%u", blockMs);
+    char countStr[4];
+    snprintf(countStr, sizeof(countStr), "%u", count);
+    RedisArg args[6 + 2 * kMaxXreadStreams];
+    size_t argc = 0;
+    args[argc++] = RedisArg("XREAD");
+    if (blockMs) {
+      args[argc++] = RedisArg("BLOCK");
+      args[argc++] = RedisArg(block);
+    }
+    args[argc++] = RedisArg("COUNT");
+    args[argc++] = RedisArg(countStr);
+    args[argc++] = RedisArg("STREAMS");
+    for (uint8_t i = 0; i < streamCount; ++i) {
+      args[argc++] = RedisArg(streams[i]);
+      xreadKeys_[i] = KeyPrint();
+      xreadKeys_[i].add(streams[i].data, streams[i].len);
+    }
+    xreadKeyCount_ = streamCount;
+    for (uint8_t i = 0; i < streamCount; ++i) {
+      args[argc++] = RedisArg(sinceIds[i]);
+    }
+    return sendCommand(args, argc);
+  }
+
+  /**
+   * Writes a command as part of the active pipeline and records the reply it expects.
+   */
+  bool queueCommand(std::initializer_list<RedisArg> args,
+                    ReplyKind kind,
+                    String *out = nullptr,
+                    bool *isNull = nullptr) {
+    return queueCommand(args.begin(), args.size(), kind, out, isNull, nullptr);
+  }
+
+  /** Runtime-arity form of `queueCommand()`; `number` receives Integer replies. */
+  bool queueCommand(const RedisArg *args,
+                    size_t count,
+                    ReplyKind kind,
+                    String *out,
+                    bool *isNull,
+                    long *number) {
+    if (pipelineBroken_) {
+      return false;
+    }
+    if (!pipelining_) {
+      lastError_ = F("pipeline not started");
+      pipelineBroken_ = true;
+      return false;
+    }
+    if (pendingCount_ >= kMaxPipelineDepth) {
+      lastError_ = F("pipeline full");
+      pipelineBroken_ = true;
+      return false;
+    }
+    if (!sendCommand(args, count)) {
+      pipelineBroken_ = true;
+      return false;
+    }
+    PendingReply &reply = pending_[pendingCount_++];
+    reply.kind = kind;
+    reply.out = out;
+    reply.isNull = isNull;
+    reply.number = number;
+    return true;
+  }
 
   /**
-   * Serializes and writes a RESP command made up of the provided argument list.
+   * Lays out `EVALSHA <sha> 2 key stream payload ver maxLen sameVer [fields...]` for the
+   * publish script. The SHA slot points at `publishSha_`, so it picks up reloads.
+   */
+  bool buildPublishArgs(PublishArgs &publish,
+                        const KeyView &key,
+                        const KeyView &stream,
+                        const String &payload,
+                        uint32_t ver,
+                        uint16_t maxLen,
+                        const char *const *streamFields,
+                        uint8_t fieldCount,
+                        bool acceptSameVer) {
+    if (fieldCount > kMaxPublishFields || (fieldCount % 2) != 0) {
+      lastError_ = F("bad publish fields");
+      return false;
+    }
+    snprintf(publish.ver, sizeof(publish.ver), "%lu", static_cast<unsigned long>(ver));
+    snprintf(publish.maxLen, sizeof(publish.maxLen), "%u", maxLen);
+    publish.args[0] = RedisArg("EVALSHA");
+    publish.args[1] = RedisArg(publishSha_, kScriptShaLen);
+    publish.args[2] = RedisArg("2");
+    publish.args[3] = RedisArg(key);
+    publish.args[4] = RedisArg(stream);
+    publish.args[5] = RedisArg(payload);
+    publish.args[6] = RedisArg(publish.ver);
+    publish.args[7] = RedisArg(publish.maxLen);
+    publish.args[8] = RedisArg(acceptSameVer ? "1" : "0");
+    for (uint8_t i = 0; i < fieldCount; ++i) {
+      publish.args[9 + i] = RedisArg(streamFields[i]);
+    }
+    publish.count = 9 + fieldCount;
+    return true;
+  }
+
+  /** Reads the reply for one queued pipeline command. */
+  bool readPendingReply(PendingReply &reply) {
+    switch (reply.kind) {
+      case ReplyKind::Status:
+        return readSimpleStatus();
+      case ReplyKind::Integer: {
+        long value = 0;
+        if (!readInteger(value)) {
+          return false;
+        }
+        if (reply.number) {
+          *reply.number = value;
+        }
+        return true;
+      }
+      case ReplyKind::Bulk:
+        if (reply.out) {
+          return readBulkString(*reply.out, reply.isNull);
+        }
+        return skipBulk();
+    }
+    return false;
+  }
+
+  /**
+   * Writes the buffered frame bytes to the client in a single `write()` call.
+   */
+  bool flushFrame() {
+    if (!frameLen_) {
+      return !writeFailed_;
+    }
+    size_t written = client_.write(frame_, frameLen_);
+    if (written != frameLen_) {
+      writeFailed_ = true;
+    }
+    frameLen_ = 0;
+    return !writeFailed_;
+  }
+
+  /**
+   * Copies bytes (from RAM or flash) into the frame buffer, flushing whenever it fills up
+   * so oversized frames degrade to buffer-sized streaming writes.
+   */
+  void appendFrame(const uint8_t *data, size_t len, bool progmem) {
+    while (len > 0) {
+      if (frameLen_ == kFrameCapacity) {
+        flushFrame();
+      }
+      size_t chunk = kFrameCapacity - frameLen_;
+      if (chunk > len) {
+        chunk = len;
+      }
+      if (progmem) {
+        memcpy_P(frame_ + frameLen_, data, chunk);
+      } else {
+        memcpy(frame_ + frameLen_, data, chunk);
+      }
+      frameLen_ += chunk;
+      data += chunk;
+      len -= chunk;
+    }
+  }
+
+  /** Appends a RESP header such as `*3\r\n` or `$5\r\n` to the frame buffer. */
+  void appendHeader(char type, size_t value) {
+    uint8_t header[24];
+    size_t pos = sizeof(header);
+    header[--pos] = '\n';
+    header[--pos] = '\r';
+    do {
+      header[--pos] = static_cast<uint8_t>('0' + (value % 10));
+      value /= 10;
+    } while (value > 0);
+    header[--pos] = static_cast<uint8_t>(type);
+    appendFrame(header + pos, sizeof(header) - pos, false);
+  }
+
+  /**
+   * Encodes a RESP command made up of the provided argument list into the frame buffer
+   * and writes it with one `write()` (deferred until `execPipeline()` inside a batch).
    */
   bool sendCommand(std::initializer_list<RedisArg> args) {
-    lastError_.remove(0);
+    return sendCommand(args.begin(), args.size());
+  }
+
+  /**
+   * Encodes `count` arguments as a RESP array; used when the arity is only known at runtime.
+   */
+  bool sendCommand(const RedisArg *args, size_t count) {
+    if (!pipelining_) {
+      lastError_.remove(0);
+    }
+    if (asyncPending_) {
+      // The next bytes on the socket belong to the outstanding async reply.
+      lastError_ = F("async request pending");
+      return false;
+    }
     if (!connected()) {
       lastError_ = F("redis disconnected");
       return false;
     }
-    client_.print('*');
-    client_.print(args.size());
-    client_.print("\r\n");
-    for (const auto &arg : args) {
-      client_.print('$');
-      client_.print(arg.len);
-      client_.print("\r\n");
-      if (arg.len) {
-        if (arg.progmem) {
-          for (size_t i = 0; i < arg.len; ++i) {
-            uint8_t b = pgm_read_byte(arg.data + i);
-            client_.write(b);
-          }
-        } else {
-          client_.write(arg.data, arg.len);
-        }
+    if (!pipelining_) {
+      frameLen_ = 0;
+      writeFailed_ = false;
+    }
+    static const uint8_t kCrlf[] = {'\r', '\n'};
+    appendHeader('*', count);
+    for (size_t i = 0; i < count; ++i) {
+      const RedisArg &arg = args[i];
+      appendHeader('$', arg.len);
+      appendFrame(arg.data, arg.len, arg.progmem);
+      appendFrame(kCrlf, sizeof(kCrlf), false);
+    }
+    if (writeFailed_) {
+      lastError_ = F("redis write failed");
+      return false;
+    }
+    if (!pipelining_) {
+      if (!flushFrame()) {
+        lastError_ = F("redis write failed");
+        return false;
       }
-      client_.print("\r\n");
+      client_.flush();
+      armRtt(classifyCommand(args, count));
+    }
+    return true;
+  }
+
+  /** Remembers when the request went out so `readType()` can time its reply. */
+  void armRtt(metrics::RttKind kind) {
+    rttKind_ = kind;
+    rttStartUs_ = micros();
+  }
+
+  /**
+   * Maps a command to the RTT class it is timed under. Blocking `XREAD`s and pub/sub
+   * commands (and anything unrecognised) return `None`.
+   */
+  static metrics::RttKind classifyCommand(const RedisArg *args, size_t count) {
+    char name[10];
+    const RedisArg &cmd = args[0];
+    if (!count || cmd.len >= sizeof(name)) {
+      return metrics::RttKind::None;
+    }
+    if (cmd.progmem) {
+      memcpy_P(name, cmd.data, cmd.len);
+    } else {
+      memcpy(name, cmd.data, cmd.len);
+    }
+    name[cmd.len] = '\0';
+    if (strcmp(name, "XREAD") == 0) {
+      bool blocking = count > 1 && args[1].len == 5 && !args[1].progmem && memcmp(args[1].data, "BLOCK", 5) == 0;
+      return blocking ? metrics::RttKind::None : metrics::RttKind::Read;
+    }
+    if (strcmp(name, "GET") == 0 || strcmp(name, "XREVRANGE") == 0 || strcmp(name, "PING") == 0) {
+      return metrics::RttKind::Read;
+    }
+    if (strcmp(name, "SET") == 0 || strcmp(name, "XADD") == 0 || strcmp(name, "XTRIM") == 0 ||
+        strcmp(name, "EXPIRE") == 0 || strcmp(name, "HSET") == 0 || strcmp(name, "PUBLISH") == 0) {
+      return metrics::RttKind::Write;
+    }
+    if (strcmp(name, "EVALSHA") == 0 || strcmp(name, "EVAL") == 0) {
+      return metrics::RttKind::Script;
+    }
+    return metrics::RttKind::None;
+  }
+
+  /**
+   * Registers a Lua script with `SCRIPT LOAD` and copies the returned SHA1 into `sha`.
+   */
+  bool scriptLoad(const __FlashStringHelper *script, char (&sha)[kScriptShaLen + 1]) {
+    if (!sendCommand({RedisArg("SCRIPT"), RedisArg("LOAD"), RedisArg(script)})) {
+      return false;
+    }
+    size_t len = 0;
+    bool overflow = false;
+    if (!readBulkInto(sha, sizeof(sha), len, overflow)) {
+      return false;
+    }
+    if (overflow || len != kScriptShaLen) {
+      lastError_ = F("bad script sha");
+      return false;
     }
-    client_.flush();
     return true;
   }
 
@@ -264,8 +1102,7 @@ class RedisLink {
     if (!sendCommand(args)) {
       return false;
     }
-    String tmp;
-    return readBulkString(tmp);
+    return skipBulk();
   }
 
   /**
@@ -273,15 +1110,13 @@ class RedisLink {
    */
   bool readSimpleStatus() {
     char type;
-    if (!readType(type, lineBuffer_)) {
+    if (!readType(type)) {
       return false;
     }
     if (type == '+') {
       return true;
     }
-    if (type == '-') {
-      lastError_ = lineBuffer_;
-    }
+    noteUnexpectedReply(type);
     return false;
   }
 
@@ -290,16 +1125,30 @@ class RedisLink {
    */
   bool readInteger(long &value) {
     char type;
-    if (!readType(type, lineBuffer_)) {
+    if (!readType(type)) {
       return false;
     }
     if (type == ':') {
-      value = lineBuffer_.toInt();
+      value = strtol(line_, nullptr, 10);
       return true;
     }
-    if (type == '-') {
-      lastError_ = lineBuffer_;
+    noteUnexpectedReply(type);
+    return false;
+  }
+
+  /**
+   * Reads a bulk-string header (`$N`), leaving `len` at -1 for nil replies.
+   */
+  bool readBulkHeader(long &len) {
+    char type;
+    if (!readType(type)) {
+      return false;
     }
+    if (type == '$') {
+      len = strtol(line_, nullptr, 10);
+      return true;
+    }
+    noteUnexpectedReply(type);
     return false;
   }
 
@@ -307,45 +1156,192 @@ class RedisLink {
    * Reads a bulk-string reply into `out`, optionally reporting when the server returned nil.
    */
   bool readBulkString(String &out, bool *isNull = nullptr) {
+    long len = 0;
+    if (!readBulkHeader(len)) {
+      return false;
+    }
+    out.remove(0);
+    if (len < 0) {
+      if (isNull) {
+        *isNull = true;
+      }
+      return true;
+    }
+    out.reserve(len);
+    while (len > 0) {
+      char chunk[32];
+      size_t chunkLen = len > 32 ? 32 : len;
+      if (!readExact(chunk, chunkLen)) {
+        return false;
+      }
+      out.concat(chunk, chunkLen);
+      len -= chunkLen;
+    }
+    if (!consumeCrlf()) {
+      return false;
+    }
+    if (isNull) {
+      *isNull = false;
+    }
+    return true;
+  }
+
+  /**
+   * Reads a bulk-string reply into a caller-provided buffer and NUL-terminates it.
+   * Values that do not fit are drained from the socket and reported through `overflow`
+   * (the buffer is left empty) so the connection stays in sync.
+   */
+  bool readBulkInto(char *dst, size_t cap, size_t &len, bool &overflow, bool *isNull = nullptr) {
+    long bulkLen = 0;
+    overflow = false;
+    len = 0;
+    if (cap) {
+      dst[0] = '\0';
+    }
+    if (!readBulkHeader(bulkLen)) {
+      return false;
+    }
+    if (isNull) {
+      *isNull = bulkLen < 0;
+    }
+    if (bulkLen < 0) {
+      return true;
+    }
+    if (static_cast<size_t>(bulkLen) >= cap) {
+      overflow = true;
+      return discardBytes(static_cast<size_t>(bulkLen)) && consumeCrlf();
+    }
+    if (!readExact(dst, static_cast<size_t>(bulkLen)) || !consumeCrlf()) {
+      return false;
+    }
+    len = static_cast<size_t>(bulkLen);
+    dst[len] = '\0';
+    return true;
+  }
+
+  /**
+   * Reads a bulk string keeping at most `cap - 1` leading bytes; used for names where a
+   * truncated copy is good enough to compare against the short names we care about.
+   */
+  bool readBulkTruncated(char *dst, size_t cap) {
+    long bulkLen = 0;
+    dst[0] = '\0';
+    if (!readBulkHeader(bulkLen)) {
+      return false;
+    }
+    if (bulkLen < 0) {
+      return true;
+    }
+    size_t keep = static_cast<size_t>(bulkLen) < cap ? static_cast<size_t>(bulkLen) : cap - 1;
+    if (!readExact(dst, keep) || !discardBytes(static_cast<size_t>(bulkLen) - keep) || !consumeCrlf()) {
+      return false;
+    }
+    dst[keep] = '\0';
+    return true;
+  }
+
+  /** `readBulkTruncated()` that also fingerprints the whole bulk into `print`. */
+  bool readBulkPrinted(char *dst, size_t cap, KeyPrint &print) {
+    long bulkLen = 0;
+    dst[0] = '\0';
+    print = KeyPrint();
+    if (!readBulkHeader(bulkLen)) {
+      return false;
+    }
+    if (bulkLen < 0) {
+      return true;
+    }
+    size_t keep = 0;
+    char chunk[32];
+    for (size_t left = static_cast<size_t>(bulkLen); left > 0;) {
+      size_t n = left > sizeof(chunk) ? sizeof(chunk) : left;
+      if (!readExact(chunk, n)) {
+        return false;
+      }
+      print.add(chunk, n);
+      size_t room = cap - 1 - keep;
+      size_t copy = n < room ? n : room;
+      memcpy(dst + keep, chunk, copy);
+      keep += copy;
+      left -= n;
+    }
+    dst[keep] = '\0';
+    return consumeCrlf();
+  }
+
+  /** Consumes a bulk-string reply without materializing it. */
+  bool skipBulk() {
+    long len = 0;
+    if (!readBulkHeader(len)) {
+      return false;
+    }
+    if (len < 0) {
+      return true;
+    }
+    return discardBytes(static_cast<size_t>(len)) && consumeCrlf();
+  }
+
+  /**
+   * Consumes one reply of any type (arrays recursively) without keeping it. Error
+   * replies are consumed too but reported as a failure.
+   */
+  bool skipReply() {
     char type;
-    if (!readType(type, lineBuffer_)) {
+    if (!readType(type)) {
       return false;
     }
-    if (type == '$') {
-      long len = lineBuffer_.toInt();
-      if (len < 0) {
-        if (isNull) {
-          *isNull = true;
-        }
-        out = "";
+    switch (type) {
+      case '+':
+      case ':':
         return true;
+      case '$': {
+        long len = strtol(line_, nullptr, 10);
+        return len < 0 || (discardBytes(static_cast<size_t>(len)) && consumeCrlf());
       }
-      out = "";
-      out.reserve(len);
-      while (len > 0) {
-        char chunk[32];
-        size_t chunkLen = len > 32 ? 32 : len;
-        size_t read = client_.readBytes(chunk, chunkLen);
-        if (read != chunkLen) {
-          lastError_ = F("bulk read timeout");
-          return false;
+      case '*': {
+        long count = strtol(line_, nullptr, 10);
+        for (long i = 0; i < count; ++i) {
+          if (!skipReply()) {
+            return false;
+          }
         }
-        out.concat(chunk, read);
-        len -= read;
+        return true;
       }
-      if (!consumeCrlf()) {
-        lastError_ = F("bulk missing CRLF");
+      default:
+        noteUnexpectedReply(type);
+        return false;
+    }
+  }
+
+  /**
+   * Reads one pub/sub push (`[kind, channel, payload]`, `[kind, channel, count]` or
+   * `[pong, data]`). `kind` always receives the push type; `channel` and `payload` are
+   * only filled for `message` pushes.
+   */
+  bool readPush(char *kind, size_t kindCap, char *channel, size_t channelCap, char *payload, size_t payloadCap) {
+    int len = 0;
+    if (!readArrayLen(len)) {
+      return false;
+    }
+    if (len < 1 || !readBulkTruncated(kind, kindCap)) {
+      lastError_ = F("bad pubsub push");
+      return false;
+    }
+    channel[0] = '\0';
+    payload[0] = '\0';
+    int consumed = 1;
+    if (len == 3 && strcmp(kind, "message") == 0) {
+      if (!readBulkTruncated(channel, channelCap) || !readBulkTruncated(payload, payloadCap)) {
         return false;
       }
-      if (isNull) {
-        *isNull = false;
-      }
-      return true;
+      consumed = 3;
     }
-    if (type == '-') {
-      lastError_ = lineBuffer_;
+    for (; consumed < len; ++consumed) {
+      if (!skipReply()) {
+        return false;
+      }
     }
-    return false;
+    return true;
   }
 
   /**
@@ -353,48 +1349,119 @@ class RedisLink {
    */
   bool readArrayLen(int &len) {
     char type;
-    if (!readType(type, lineBuffer_)) {
+    if (!readType(type)) {
       return false;
     }
     if (type == '*') {
-      len = lineBuffer_.toInt();
+      len = static_cast<int>(strtol(line_, nullptr, 10));
       return true;
     }
-    if (type == '-') {
-      lastError_ = lineBuffer_;
-    }
+    noteUnexpectedReply(type);
     return false;
   }
 
   /**
-   * Reads the RESP type byte and line payload, handling connection errors/timeouts.
+   * Records the error line for `-ERR` replies and flags any other unexpected type.
    */
-  bool readType(char &type, String &line) {
-    if (!connected()) {
-      lastError_ = F("redis disconnected");
-      return false;
+  void noteUnexpectedReply(char type) {
+    if (type == '-') {
+      lastError_ = line_;
+    } else {
+      lastError_ = F("unexpected reply type");
     }
+    LOG_DEBUG("[redis] reply '%c': %s", type, lastError_.c_str());
+  }
+
+  /**
+   * Waits (up to the link timeout) for the next byte, returning -1 on timeout/close.
+   */
+  int readByteTimed() {
     unsigned long start = millis();
     while (!client_.available()) {
+      if (!client_.connected()) {
+        lastError_ = F("redis closed");
+        return -1;
+      }
       if (millis() - start > timeoutMs_) {
         lastError_ = F("redis timeout");
-        return false;
+        return -1;
       }
       delay(1);
     }
     int c = client_.read();
     if (c < 0) {
       lastError_ = F("redis read err");
+    }
+    return c;
+  }
+
+  /**
+   * Reads the RESP type byte and the rest of its line into the fixed `line_` buffer.
+   * Overlong lines (verbose error messages) are truncated but fully consumed.
+   */
+  bool readType(char &type) {
+    lastReplyWasError_ = false;
+    lineLen_ = 0;
+    line_[0] = '\0';
+    if (!connected() && !client_.available()) {
+      lastError_ = F("redis disconnected");
+      return false;
+    }
+    int c = readByteTimed();
+    if (c < 0) {
       return false;
     }
+    if (rttKind_ != metrics::RttKind::None) {
+      uint32_t rttUs = micros() - rttStartUs_;
+      if (metrics_) {
+        metrics_->rtt(rttKind_).record(rttUs);
+      }
+      srttUs_ = srttUs_ ? srttUs_ - srttUs_ / 8 + rttUs / 8 : rttUs;
+      rttKind_ = metrics::RttKind::None;
+    }
     type = static_cast<char>(c);
-    line = client_.readStringUntil('\n');
-    if (!line.length() && !client_.connected()) {
-      lastError_ = F("redis closed");
+    lastReplyWasError_ = (type == '-');
+    while (true) {
+      c = readByteTimed();
+      if (c < 0) {
+        return false;
+      }
+      if (c == '\n') {
+        break;
+      }
+      if (lineLen_ < kLineCapacity - 1) {
+        line_[lineLen_++] = static_cast<char>(c);
+      }
+    }
+    if (lineLen_ && line_[lineLen_ - 1] == '\r') {
+      --lineLen_;
+    }
+    line_[lineLen_] = '\0';
+    return true;
+  }
+
+  /** Reads exactly `len` payload bytes into `dst`. */
+  bool readExact(char *dst, size_t len) {
+    if (!len) {
+      return true;
+    }
+    size_t got = client_.readBytes(dst, len);
+    if (got != len) {
+      lastError_ = F("bulk read timeout");
       return false;
     }
-    if (line.endsWith("\r")) {
-      line.remove(line.length() - 1);
+    return true;
+  }
+
+  /** Drops `len` payload bytes from the socket through a small stack buffer. */
+  bool discardBytes(size_t len) {
+    char sink[32];
+    while (len > 0) {
+      size_t chunk = len > sizeof(sink) ? sizeof(sink) : len;
+      if (!readExact(sink, chunk)) {
+        return false;
+      }
+      len -= chunk;
     }
     return true;
   }
@@ -403,99 +1470,164 @@ class RedisLink {
   bool consumeCrlf() {
     char buf[2];
     size_t got = client_.readBytes(buf, sizeof(buf));
-    return got == sizeof(buf) && buf[0] == '\r' && buf[1] == '\n';
+    if (got == sizeof(buf) && buf[0] == '\r' && buf[1] == '\n') {
+      return true;
+    }
+    lastError_ = F("bulk missing CRLF");
+    return false;
   }
 
   /**
-   * Parses the nested array reply returned by `XREAD` to extract the `p` field payload.
+   * Streams an array of stream entries (`[[id, [field, value, ...]], ...]`, as found in
+   * `XREAD`/`XREVRANGE` replies) into `visitor`. The whole array is always consumed.
    */
-  bool readXreadPayload(String &entryIdOut, String &payload) {
-    int topCount = 0;
-    if (!readArrayLen(topCount)) {
-      // Null reply => timeout, nothing to do.
-      return false;
-    }
-    if (topCount <= 0) {
+  template <typename Visitor>
+  bool readStreamEntries(Visitor &visitor) {
+    int entryCount = 0;
+    if (!readArrayLen(entryCount)) {
       return false;
     }
-    for (int i = 0; i < topCount; ++i) {
-      int pairLen = 0;
-      if (!readArrayLen(pairLen) || pairLen < 2) {
+    for (int entry = 0; entry < entryCount; ++entry) {
+      int entryLen = 0;
+      if (!readArrayLen(entryLen) || entryLen < 2) {
+        lastError_ = F("bad stream entry");
         return false;
       }
-      String streamName;
-      if (!readBulkString(streamName)) {
+      char entryId[kStreamIdCapacity];
+      size_t idLen = 0;
+      bool idOverflow = false;
+      if (!readBulkInto(entryId, sizeof(entryId), idLen, idOverflow)) {
         return false;
       }
-      int entryCount = 0;
-      if (!readArrayLen(entryCount) || entryCount <= 0) {
-        continue;
+      bool wanted = !idOverflow && visitor.entry(entryId);
+      int fieldCount = 0;
+      if (!readArrayLen(fieldCount)) {
+        return false;
       }
-      for (int entry = 0; entry < entryCount; ++entry) {
-        int entryLen = 0;
-        if (!readArrayLen(entryLen) || entryLen < 2) {
+      bool complete = true;
+      for (int field = 0; field + 1 < fieldCount; field += 2) {
+        char name[kFieldNameCapacity];
+        if (!readBulkTruncated(name, sizeof(name))) {
           return false;
         }
-        String entryId;
-        if (!readBulkString(entryId)) {
+        size_t cap = 0;
+        char *dst = wanted ? visitor.field(name, cap) : nullptr;
+        if (!dst || !cap) {
+          if (!skipBulk()) {
+            return false;
+          }
+          continue;
+        }
+        size_t valueLen = 0;
+        bool overflow = false;
+        if (!readBulkInto(dst, cap, valueLen, overflow)) {
           return false;
         }
-        int fieldCount = 0;
-        if (!readArrayLen(fieldCount) || fieldCount <= 0) {
-          continue;
+        if (overflow) {
+          complete = false;
         }
-        for (int field = 0; field < fieldCount; field += 2) {
-          String fieldName;
-          if (!readBulkString(fieldName)) {
-            return false;
-          }
-          String fieldValue;
-          if (!readBulkString(fieldValue)) {
-            return false;
-          }
-          if (fieldName == "p") {
-            payload = fieldValue;
-            entryIdOut = entryId;
-            return true;
-          }
+      }
+      if (fieldCount > 0 && (fieldCount % 2) != 0 && !skipBulk()) {
+        return false;
+      }
+      if (wanted) {
+        visitor.entryDone(complete);
+      }
+      for (int extra = 2; extra < entryLen; ++extra) {
+        if (!skipBulk()) {
+          return false;
         }
       }
     }
-    return false;
+    return true;
   }
 
   /**
-   * Parses the latest entry id returned by `XREVRANGE stream + - COUNT 1`.
+   * Streams an `XREAD` reply (`[[stream, entries], ...]` or nil on timeout) into `visitor`.
    */
-  bool readXrevrangeTail(String &entryId) {
-    int entryCount = 0;
-    if (!readArrayLen(entryCount)) {
+  template <typename Visitor>
+  bool readXreadReply(Visitor &visitor) {
+    int streamCount = 0;
+    if (!readArrayLen(streamCount)) {
       return false;
     }
-    if (entryCount <= 0) {
-      entryId.remove(0);
-      return true;
-    }
-    for (int i = 0; i < entryCount; ++i) {
-      int entryLen = 0;
-      if (!readArrayLen(entryLen) || entryLen < 2) {
+    // Streams come back in request order (those without new entries are left out), so
+    // each name is matched from just past the previous one.
+    uint8_t next = 0;
+    for (int i = 0; i < streamCount; ++i) {
+      int pairLen = 0;
+      if (!readArrayLen(pairLen) || pairLen != 2) {
+        lastError_ = F("bad xread reply");
         return false;
       }
-      if (!readBulkString(entryId)) {
+      char streamName[kStreamNameCapacity];
+      KeyPrint print;
+      if (!readBulkPrinted(streamName, sizeof(streamName), print)) {
         return false;
       }
-      int fieldCount = 0;
-      if (!readArrayLen(fieldCount)) {
-        return false;
+      uint8_t at = next;
+      while (at < xreadKeyCount_ && !(xreadKeys_[at] == print)) {
+        ++at;
       }
-      String tmp;
-      for (int field = 0; field < fieldCount; ++field) {
-        if (!readBulkString(tmp)) {
-          return false;
-        }
+      if (at < xreadKeyCount_) {
+        next = at + 1;
+      } else {
+        at = kUnknownStream;
+      }
+      visitor.stream(streamName);
+      visitor.streamAt(at);
+      if (!readStreamEntries(visitor)) {
+        return false;
       }
-      break;
     }
     return true;
   }
+
+  /** Visitor that keeps the first complete entry carrying a `p` payload field. */
+  struct PayloadVisitor : StreamVisitor {
+    char *entryId;
+    size_t entryIdCap;
+    char *payload;
+    size_t payloadCap;
+    bool found = false;
+    bool pending = false;
+    bool sawPayload = false;
+    PayloadVisitor(char *id, size_t idCap, char *out, size_t outCap)
+        : entryId(id), entryIdCap(idCap), payload(out), payloadCap(outCap) {}
+    bool entry(const char *id) {
+      if (found) {
+        return false;
+      }
+      pending = strlen(id) < entryIdCap;
+      if (pending) {
+        strcpy(entryId, id);
+      }
+      sawPayload = false;
+      return pending;
+    }
+    char *field(const char *name, size_t &cap) {
+      if (sawPayload || strcmp(name, "p") != 0) {
+        return nullptr;
+      }
+      sawPayload = true;
+      cap = payloadCap;
+      return payload;
+    }
+    void entryDone(bool complete) { found = pending && sawPayload && complete; }
+  };
+
+  /** Visitor that records the id of the first entry in an `XREVRANGE` reply. */
+  struct TailIdVisitor : StreamVisitor {
+    char *entryId;
+    size_t entryIdCap;
+    bool found = false;
+    TailIdVisitor(char *id, size_t idCap) : entryId(id), entryIdCap(idCap) {}
+    bool entry(const char *id) {
+      if (!found && strlen(id) < entryIdCap) {
+        strcpy(entryId, id);
+        found = true;
+      }
+      return false;
+    }
+  };
 };
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef SCHED_ADAPTIVE
+/** Set to 0 to keep every adaptive poll interval and XREAD window at its base value. */
+#define SCHED_ADAPTIVE 1
+#endif
+#ifndef SCHED_IDLE_AFTER_MS
+/** Time without activity (commands, overrides, warnings, ramps) before intervals stretch. */
+#define SCHED_IDLE_AFTER_MS 30000
+#endif
+#ifndef SCHED_SLOW_RTT_MS
+/** Smoothed Redis round trip above which every interval backs off one pace step. */
+#define SCHED_SLOW_RTT_MS 150
+#endif
+
+/**
+ * Timed background work for both firmware loops: a `Cadence` that turns recent activity
+ * and link latency into a pace, and a `TaskTable` that runs periodic tasks whose
+ * intervals may follow it. Everything is static storage and function pointers.
+ */
+namespace sched {
+
+/** How busy the device is; a task's interval shrinks when active and grows when idle. */
+enum class Pace : uint8_t { Active, Normal, Idle };
+
+inline const char *paceName(Pace pace) {
+  switch (pace) {
+    case Pace::Active:
+      return "active";
+    case Pace::Normal:
+      return "normal";
+    case Pace::Idle:
+      return "idle";
+  }
+  return "";
+}
+
+/**
+ * Tracks activity and Redis latency. The pace is Active for `kActiveHoldMs` after the
+ * last activity, Normal until `SCHED_IDLE_AFTER_MS`, then Idle; a smoothed RTT above
+ * `SCHED_SLOW_RTT_MS` moves it one step slower, so a struggling server sees fewer polls.
+ */
+class Cadence {
+ public:
+  static constexpr unsigned long kActiveHoldMs = 5000;
+  static constexpr unsigned long kMinIntervalMs = 250;
+  static constexpr uint8_t kActiveDivisor = 4;
+  static constexpr uint8_t kIdleFactor = 4;
+
+  /** Notes activity now (a command applied, a warning raised, a publish written). */
+  void touch(unsigned long now) { lastActiveMs_ = now; }
+
+  /**
+   * Re-evaluates the pace once per `loop()` pass; `busy` holds it active (a live override,
+   * a running fade). Returns true when the pace changed.
+   */
+  bool update(unsigned long now, bool busy, uint32_t rttUs) {
+    if (busy) {
+      touch(now);
+    }
+    Pace next = Pace::Normal;
+    if (SCHED_ADAPTIVE) {
+      unsigned long quietMs = now - lastActiveMs_;
+      if (quietMs >= SCHED_IDLE_AFTER_MS) {
+        // Pin the mark so millis() wrap-around never reads as fresh activity.
+        lastActiveMs_ = now - SCHED_IDLE_AFTER_MS;
+        next = Pace::Idle;
+      } else if (quietMs < kActiveHoldMs) {
+        next = Pace::Active;
+      }
+      if (rttUs > static_cast<uint32_t>(SCHED_SLOW_RTT_MS) * 1000UL && next != Pace::Idle) {
+        next = static_cast<Pace>(static_cast<uint8_t>(next) + 1);
+      }
+    }
+    bool changed = next != pace_;
+    pace_ = next;
+    return changed;
+  }
+
+  Pace pace() const { return pace_; }
+
+  /**
+   * `baseMs` at the current pace: divided by `kActiveDivisor` (not below
+   * `kMinIntervalMs`) when active, multiplied by `kIdleFactor` when idle.
+   */
+  unsigned long scale(unsigned long baseMs) const {
+    switch (pace_) {
+      case Pace::Active: {
+        unsigned long ms = baseMs / kActiveDivisor;
+        if (ms >= kMinIntervalMs) {
+          return ms;
+        }
+        return baseMs < kMinIntervalMs ? baseMs : kMinIntervalMs;
+      }
+      case Pace::Idle:
+        return baseMs * kIdleFactor;
+      case Pace::Normal:
+        break;
+    }
+    return baseMs;
+  }
+
+ private:
+  unsigned long lastActiveMs_ = 0;
+  Pace pace_ = Pace::Normal;
+};
+
+/**
+ * One periodic task. It is due once `intervalMs()` elapsed since it last succeeded, or
+ * at once while `*changed` is set (the change flag an event handler raises; `run` clears
+ * it). `run` returns false to stay due, so the next pass retries.
+ */
+struct Task {
+  bool (*run)(unsigned long now);
+  unsigned long (*intervalMs)();
+  const bool *changed;
+  unsigned long lastMs;
+};
+
+/** Runs a fixed array of `Task`s in order; see `runDue()` and `nextDueMs()`. */
+class TaskTable {
+ public:
+  template <size_t N>
+  explicit TaskTable(Task (&tasks)[N]) : tasks_(tasks), count_(static_cast<uint8_t>(N)) {}
+
+  /** Runs every task that is due, once each, in table order. */
+  void runDue(unsigned long now) {
+    for (uint8_t i = 0; i < count_; ++i) {
+      Task &task = tasks_[i];
+      if (!dueInMs(task, now) && task.run(now)) {
+        task.lastMs = now;
+      }
+    }
+  }
+
+  /** Milliseconds until the next task falls due (0 when one already is), at most `capMs`. */
+  unsigned long nextDueMs(unsigned long now, unsigned long capMs) const {
+    for (uint8_t i = 0; i < count_ && capMs; ++i) {
+      unsigned long left = dueInMs(tasks_[i], now);
+      if (left < capMs) {
+        capMs = left;
+      }
+    }
+    return capMs;
+  }
+
+ private:
+  static unsigned long dueInMs(const Task &task, unsigned long now) {
+    if (task.changed && *task.changed) {
+      return 0;
+    }
+    unsigned long interval = task.intervalMs();
+    unsigned long elapsed = now - task.lastMs;
+    return elapsed >= interval ? 0 : interval - elapsed;
+  }
+
+  Task *tasks_;
+  uint8_t count_;
+};
+
+}  // namespace sched
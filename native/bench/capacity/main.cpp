@@ -0,0 +1,761 @@
+// Host capacity benchmark: replays a fleet's steady-state Redis traffic against a target
+// Redis and reports memory per room, throughput, tail latency and what happens during an
+// AOF rewrite, then recommends stream trim lengths and the heartbeat TTL.
+//
+//   docker compose up -d redis
+//   pio run -d native -e bench_capacity -t exec
+//
+// Every room first gets its keys and streams filled to their trim lengths, so memory is
+// measured at steady state (MEMORY USAGE over a sample of rooms, plus INFO used_memory).
+// Then worker threads, each on one RedisLink over PosixClient, play the per-room traffic
+// the firmware and website generate, at the intervals from config.h:
+//   receiver  heartbeat SET EX, cfg poll GET, reported publish + state XADD (script) and
+//             a non-blocking XREAD per command, metrics HSET/EXPIRE, telemetry XADD
+//             batches, warning SET + PUBLISH
+//   sender    desired publish + command XADD (script), cfg/override/warning poll GETs,
+//             metrics HSET/EXPIRE
+//   website   commands (counted with the sender's publishes) and a fleet dashboard
+//             refresh, replayed as pipelined GETs of the five keys `loadRoomStates()`
+//             MGETs
+// Polls use REDIS_EVENTS_FALLBACK_MS when REDIS_EVENTS_ENABLED, as devices do with live
+// events. Receivers' blocking XREADs are replaced by one non-blocking read per command.
+// Halfway through, BGREWRITEAOF is started (when AOF is on) and latencies observed while
+// it runs are reported separately.
+//
+// Environment overrides: BENCH_REDIS_HOST, BENCH_REDIS_PORT, BENCH_REDIS_PASSWORD,
+// BENCH_ROOMS (default "100,500,1000"), BENCH_SECONDS (traffic per scenario, default 60),
+// BENCH_THREADS (default 4), BENCH_SPEEDUP (divides every interval, default 1),
+// BENCH_COMMANDS_PER_MIN (per room, default 2), BENCH_WARNINGS_PER_HOUR (per room,
+// default 2), BENCH_TRIM_LEN (command/state streams, default 200), BENCH_DASHBOARD_MS
+// (default 5000), BENCH_AOF_REWRITE (default 1), BENCH_MEMORY_MB (budget for the
+// recommendations, default maxmemory or 1024) and BENCH_OUTAGE_MIN (longest receiver
+// outage the command stream should cover, default 30). Rooms are named `cap-<n>`; remove
+// them afterwards with
+//   redis-cli --scan --pattern '*:cap-*' | xargs redis-cli del
+//   redis-cli --scan --pattern 'room:cap-*' | xargs redis-cli del
+
+#include <Arduino.h>
+#include <PosixClient.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../common.hpp"
+#include "config.h"
+#include "contracts.hpp"
+#include "redis_link.hpp"
+
+namespace {
+
+constexpr uint8_t kXreadCount = 8;
+/** The sender's override and warning poll interval without events. */
+constexpr unsigned long kSenderPollMs = 2000;
+/** Rooms whose keys are measured with MEMORY USAGE. */
+constexpr unsigned kMemorySampleRooms = 20;
+
+struct Settings : bench::RedisTarget {
+  std::vector<unsigned> rooms = {100, 500, 1000};
+  unsigned seconds = 60;
+  unsigned threads = 4;
+  double speedup = 1;
+  double commandsPerMin = 2;
+  double warningsPerHour = 2;
+  uint16_t trimLen = 200;
+  unsigned long dashboardMs = 5000;
+  bool aofRewrite = true;
+  unsigned memoryMb = 0;
+  unsigned outageMin = 30;
+};
+
+Settings loadSettings() {
+  Settings settings;
+  bench::loadRedisTarget(settings);
+  bench::loadRoomCounts(settings.rooms);
+  if (const char *v = getenv("BENCH_SECONDS")) {
+    settings.seconds = std::max(1, atoi(v));
+  }
+  if (const char *v = getenv("BENCH_THREADS")) {
+    settings.threads = std::max(1, atoi(v));
+  }
+  if (const char *v = getenv("BENCH_SPEEDUP")) {
+    settings.speedup = std::max(0.01, atof(v));
+  }
+  if (const char *v = getenv("BENCH_COMMANDS_PER_MIN")) {
+    settings.commandsPerMin = std::max(0.0, atof(v));
+  }
+  if (const char *v = getenv("BENCH_WARNINGS_PER_HOUR")) {
+    settings.warningsPerHour = std::max(0.0, atof(v));
+  }
+  if (const char *v = getenv("BENCH_TRIM_LEN")) {
+    settings.trimLen = static_cast<uint16_t>(std::max(1, std::min(atoi(v), 65535)));
+  }
+  if (const char *v = getenv("BENCH_DASHBOARD_MS")) {
+    settings.dashboardMs = static_cast<unsigned long>(std::max(0, atoi(v)));
+  }
+  if (const char *v = getenv("BENCH_AOF_REWRITE")) {
+    settings.aofRewrite = atoi(v) != 0;
+  }
+  if (const char *v = getenv("BENCH_MEMORY_MB")) {
+    settings.memoryMb = static_cast<unsigned>(std::max(0, atoi(v)));
+  }
+  if (const char *v = getenv("BENCH_OUTAGE_MIN")) {
+    settings.outageMin = static_cast<unsigned>(std::max(0, atoi(v)));
+  }
+  return settings;
+}
+
+/** Reads `field:<number>` from an INFO reply (0 when missing). */
+double infoField(const String &info, const char *field) {
+  const size_t len = strlen(field);
+  for (const char *p = info.c_str(); (p = strstr(p, field)) != nullptr; p += len) {
+    if ((p == info.c_str() || p[-1] == '\n') && p[len] == ':') {
+      return atof(p + len + 1);
+    }
+  }
+  return 0;
+}
+
+/** Traffic kinds, each timed separately. */
+enum Kind : uint8_t {
+  kHeartbeat,
+  kDesired,
+  kCommandRead,
+  kReported,
+  kCfgPoll,
+  kOverridePoll,
+  kWarningPoll,
+  kMetrics,
+  kTelemetry,
+  kWarning,
+  kDashboard,
+  kKinds
+};
+
+const char *const kKindNames[kKinds] = {"heartbeat", "desired",   "xread",   "reported", "cfg_get",  "override_get",
+                                        "warning_get", "metrics", "telemetry", "warning", "dashboard"};
+
+/** Latencies (microseconds) per kind, split by whether an AOF rewrite was running. */
+struct Samples {
+  std::vector<uint32_t> us[kKinds][2];
+  uint64_t ops = 0;
+  uint64_t failures = 0;
+  std::vector<uint32_t> lagMs;
+
+  void merge(const Samples &o) {
+    for (uint8_t k = 0; k < kKinds; ++k) {
+      for (uint8_t p = 0; p < 2; ++p) {
+        us[k][p].insert(us[k][p].end(), o.us[k][p].begin(), o.us[k][p].end());
+      }
+    }
+    ops += o.ops;
+    failures += o.failures;
+    lagMs.insert(lagMs.end(), o.lagMs.begin(), o.lagMs.end());
+  }
+};
+
+/** Per-room timers (`kDesired` also drives `kCommandRead` and `kReported`). */
+struct RoomLoad {
+  String id;
+  contracts::RoomKeys keys;
+  char cursor[RedisLink::kStreamIdCapacity] = "0-0";
+  uint32_t ver = 1;
+  uint64_t due[kKinds] = {};
+};
+
+/** Tracks the newest id an XREAD returned. */
+struct CursorVisitor : RedisLink::StreamVisitor {
+  char lastId[RedisLink::kStreamIdCapacity] = "";
+  bool entry(const char *id) {
+    if (strlen(id) < sizeof(lastId)) {
+      strcpy(lastId, id);
+    }
+    return false;
+  }
+};
+
+/** Static payloads sized like the real ones. */
+struct Payloads {
+  String cfg = R"({"night":{"enabled":true,"hour":22,"minute":0,"brightness":5},"wake":{"enabled":true,"hour":7,"minute":0,"brightness":80},"version":3})";
+  String override = R"({"enabled":false,"ver":12,"updated_at":1760000000,"source":"device"})";
+  String warning = R"({"db":71.5,"threshold":65.0,"captured_at":1760000000,"window_ms":1000})";
+  // Roughly the receiver's snapshot (loop/rtt/heap/links/cmd_ms); the sender's is similar.
+  String metrics = String(R"({"v":1,"window_ms":60000,"loop_us":{"n":60000,"p50":1023,"p95":2047,"p99":4095,"max":9001},)"
+                          R"("rtt_us":{"read":{"n":40,"p50":3071,"p95":6143,"p99":8191,"max":9000},)"
+                          R"("write":{"n":20,"p50":3071,"p95":6143,"p99":8191,"max":9000},)"
+                          R"("script":{"n":2,"p50":4095,"p95":6143,"p99":6143,"max":6000}},)"
+                          R"("heap":{"free":24000,"min_free":21000,"max_block":16000,"frag":12},)"
+                          R"("links":{"redis":{"connects":1,"failures":0,"down_ms":0},)"
+                          R"("stream":{"connects":1,"failures":0,"down_ms":0}},"wifi_blocked_ms":0,)"
+                          R"("cmd_ms":{"applied":{"n":2,"p50":31,"p95":47,"p99":47,"max":45},)"
+                          R"("reported":{"n":2,"p50":63,"p95":95,"p99":95,"max":90}}})");
+  const char *telemetry[12] = {"ts", "1760000000", "n", "60", "min", "312", "max", "655", "mean", "401", "p95", "598"};
+};
+
+const Payloads kPayloads;
+
+/** Interval of each kind in nanoseconds (0 = disabled), already divided by the speedup. */
+struct Intervals {
+  uint64_t ns[kKinds] = {};
+
+  explicit Intervals(const Settings &settings) {
+    const double scale = 1e6 / settings.speedup;  // ms -> ns
+    const double eventsPoll = REDIS_EVENTS_ENABLED ? REDIS_EVENTS_FALLBACK_MS : 0;
+    auto poll = [&](double pollMs) { return eventsPoll > pollMs ? eventsPoll : pollMs; };
+    ns[kHeartbeat] = static_cast<uint64_t>(RECEIVER_HEARTBEAT_MS * scale);
+    if (settings.commandsPerMin > 0) {
+      ns[kDesired] = static_cast<uint64_t>(60000.0 / settings.commandsPerMin * scale);
+    }
+    // Receiver and sender both poll the cfg; modelled as one GET at twice the rate.
+    ns[kCfgPoll] = static_cast<uint64_t>(
+        1.0 / (1.0 / poll(RECEIVER_CFG_REFRESH_MS) + 1.0 / poll(SCHEDULE_REFRESH_MS)) * scale);
+    ns[kOverridePoll] = static_cast<uint64_t>(poll(kSenderPollMs) * scale);
+    ns[kWarningPoll] = ns[kOverridePoll];
+    if (METRICS_ENABLED) {
+      ns[kMetrics] = static_cast<uint64_t>(METRICS_PUBLISH_INTERVAL_MS * scale);
+    }
+    if (RECEIVER_TELEMETRY_ENABLED) {
+      ns[kTelemetry] = static_cast<uint64_t>(60000.0 * RECEIVER_TELEMETRY_BATCH * scale);
+    }
+    if (settings.warningsPerHour > 0) {
+      ns[kWarning] = static_cast<uint64_t>(3600000.0 / settings.warningsPerHour * scale);
+    }
+  }
+};
+
+/** Replays the traffic of a slice of rooms on one link. */
+class Worker {
+ public:
+  Worker(const Settings &settings, const Intervals &intervals, std::vector<RoomLoad *> rooms)
+      : settings_(settings), intervals_(intervals), rooms_(std::move(rooms)) {}
+
+  bool start() {
+    return bench::openLink(settings_, client_, link_) && link_.loadPublishScript(FPSTR(contracts::kPublishScript));
+  }
+
+  /** Fills every stream and key of the slice to steady state. */
+  bool prefill() {
+    contracts::Desired desired;
+    strcpy(desired.mode, "on");
+    contracts::CompactDesired compact;
+    String json;
+    for (RoomLoad *room : rooms_) {
+      // Continue above whatever an earlier run stored, as the sender's seed does.
+      String stored;
+      bool isNull = false;
+      contracts::Desired seed;
+      if (link_.get(room->keys.desired, stored, &isNull) && !isNull && contracts::decodeDesired(stored, seed) &&
+          seed.ver >= room->ver) {
+        room->ver = seed.ver + 1;
+      }
+      desired.brightness = 40;
+      desired.ver = room->ver++;
+      contracts::encodeDesired(desired, &room->id, json);
+      contracts::encodeDesiredCompact(desired, compact);
+      link_.beginPipeline();
+      link_.queueSet(room->keys.desired, json);
+      link_.queueSet(room->keys.reported, json);
+      link_.queueSet(room->keys.cfg, kPayloads.cfg);
+      link_.queueSet(room->keys.override_, kPayloads.override);
+      link_.queueSet(room->keys.latestWarning, kPayloads.warning);
+      link_.queueHset(room->keys.metrics, "receiver", kPayloads.metrics.c_str());
+      link_.queueHset(room->keys.metrics, "sender", kPayloads.metrics.c_str());
+      link_.queueSetHeartbeat(room->keys.online, contracts::kHeartbeatTtlSec);
+      if (!link_.execPipeline()) {
+        return fail("prefill keys");
+      }
+      const char *stateFields[2] = {"p", json.c_str()};
+      if (!fillStream(room->keys.cmd, settings_.trimLen, compact.args, compact.count) ||
+          !fillStream(room->keys.state, settings_.trimLen, stateFields, 2) ||
+          (RECEIVER_TELEMETRY_ENABLED &&
+           !fillStream(room->keys.telemetry, RECEIVER_TELEMETRY_MAXLEN, kPayloads.telemetry, 12))) {
+        return fail("prefill streams");
+      }
+      if (!link_.streamTailId(room->keys.cmd, room->cursor, sizeof(room->cursor))) {
+        return fail("tail");
+      }
+    }
+    return true;
+  }
+
+  /** Spreads every room's first deadline over one interval so the load starts smooth. */
+  void schedule(uint64_t startNs, uint32_t seed) {
+    for (RoomLoad *room : rooms_) {
+      for (uint8_t k = 0; k < kKinds; ++k) {
+        seed = seed * 1664525UL + 1013904223UL;
+        room->due[k] = intervals_.ns[k] ? startNs + (seed >> 8) % intervals_.ns[k] : UINT64_MAX;
+      }
+    }
+  }
+
+  /** Runs until `endNs`, or until a link fails. */
+  void run(uint64_t endNs, const std::atomic<bool> &rewriting, Samples &samples) {
+    samples_ = &samples;
+    while (true) {
+      uint64_t now = bench::nowNs();
+      if (now >= endNs) {
+        return;
+      }
+      uint64_t next = endNs;
+      for (RoomLoad *room : rooms_) {
+        for (uint8_t k = 0; k < kKinds; ++k) {
+          if (room->due[k] > now) {
+            next = std::min(next, room->due[k]);
+            continue;
+          }
+          samples.lagMs.push_back(static_cast<uint32_t>((now - room->due[k]) / 1000000));
+          phase_ = rewriting.load(std::memory_order_relaxed) ? 1 : 0;
+          if (!runOp(*room, static_cast<Kind>(k))) {
+            ++samples.failures;
+            if (!reconnect()) {
+              return;
+            }
+          }
+          // A worker that falls behind skips ahead instead of bursting the backlog.
+          room->due[k] = std::max(room->due[k] + intervals_.ns[k], now);
+          now = bench::nowNs();
+        }
+      }
+      if (next > now) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<uint64_t>(next - now, 2000000)));
+      }
+    }
+  }
+
+  const char *lastError() const { return error_; }
+
+ private:
+  bool fail(const char *what) {
+    snprintf(error_, sizeof(error_), "%s: %s", what, link_.lastError().c_str());
+    return false;
+  }
+
+  bool reconnect() {
+    client_.stop();
+    return start();
+  }
+
+  /** Appends `count` entries, eight per pipeline, each trimmed to `maxLen`. */
+  bool fillStream(const RedisLink::KeyView &stream, uint16_t count, const char *const *fields, uint8_t fieldCount) {
+    for (uint16_t done = 0; done < count;) {
+      link_.beginPipeline();
+      for (uint8_t i = 0; i < RedisLink::kMaxPipelineDepth && done < count; ++i, ++done) {
+        link_.queueXadd(stream, count, fields, fieldCount);
+      }
+      if (!link_.execPipeline()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void record(Kind kind, uint64_t startNs) {
+    samples_->us[kind][phase_].push_back(static_cast<uint32_t>((bench::nowNs() - startNs) / 1000));
+    ++samples_->ops;
+  }
+
+  bool runOp(RoomLoad &room, Kind kind) {
+    const uint64_t start = bench::nowNs();
+    String scratch;
+    bool isNull = false;
+    bool ok = true;
+    switch (kind) {
+      case kHeartbeat:
+        ok = link_.setHeartbeat(room.keys.online, contracts::kHeartbeatTtlSec);
+        break;
+      case kDesired:
+        return command(room);
+      case kCfgPoll:
+        ok = link_.get(room.keys.cfg, scratch, &isNull);
+        break;
+      case kOverridePoll:
+        ok = link_.get(room.keys.override_, scratch, &isNull);
+        break;
+      case kWarningPoll:
+        ok = link_.get(room.keys.latestWarning, scratch, &isNull);
+        break;
+      case kMetrics:
+        link_.beginPipeline();
+        link_.queueHset(room.keys.metrics, "receiver", kPayloads.metrics.c_str());
+        link_.queueHset(room.keys.metrics, "sender", kPayloads.metrics.c_str());
+        link_.queueExpire(room.keys.metrics, 3 * METRICS_PUBLISH_INTERVAL_MS / 1000);
+        ok = link_.execPipeline();
+        break;
+      case kTelemetry:
+        link_.beginPipeline();
+        for (uint8_t i = 0; i < RECEIVER_TELEMETRY_BATCH; ++i) {
+          link_.queueXadd(room.keys.telemetry, RECEIVER_TELEMETRY_MAXLEN, kPayloads.telemetry, 12);
+        }
+        ok = link_.execPipeline();
+        break;
+      case kWarning:
+        link_.beginPipeline();
+        link_.queueSet(room.keys.latestWarning, kPayloads.warning);
+        link_.queuePublish(room.keys.events, contracts::kEventWarning);
+        ok = link_.execPipeline();
+        break;
+      default:
+        return true;
+    }
+    if (!ok) {
+      return fail(kKindNames[kind]);
+    }
+    record(kind, start);
+    return true;
+  }
+
+  /** Sender/website publish, then the receiver's read and reported write. */
+  bool command(RoomLoad &room) {
+    contracts::Desired desired;
+    strcpy(desired.mode, "on");
+    desired.brightness = static_cast<uint8_t>(room.ver % 101);
+    desired.ver = room.ver;
+    contracts::CompactDesired compact;
+    contracts::encodeDesired(desired, &room.id, json_);
+    contracts::encodeDesiredCompact(desired, compact);
+    uint32_t storedVer = 0;
+    uint64_t start = bench::nowNs();
+    if (!link_.evalPublishScript(FPSTR(contracts::kPublishScript), room.keys.desired, room.keys.cmd, json_,
+                                 desired.ver, settings_.trimLen, storedVer, compact.args, compact.count)) {
+      return fail("desired");
+    }
+    record(kDesired, start);
+    if (storedVer != desired.ver) {
+      room.ver = storedVer;  // stale: nothing reached the stream for the receiver to read
+      return true;
+    }
+    room.ver = desired.ver + 1;
+
+    CursorVisitor visitor;
+    start = bench::nowNs();
+    if (!link_.xread(room.keys.cmd, 0, room.cursor, kXreadCount, visitor)) {
+      return fail("xread");
+    }
+    record(kCommandRead, start);
+    if (visitor.lastId[0]) {
+      strcpy(room.cursor, visitor.lastId);
+    }
+
+    start = bench::nowNs();
+    if (!link_.evalPublishScript(FPSTR(contracts::kPublishScript), room.keys.reported, room.keys.state, json_,
+                                 desired.ver, settings_.trimLen, storedVer, nullptr, 0, true)) {
+      return fail("reported");
+    }
+    record(kReported, start);
+    return true;
+  }
+
+  const Settings &settings_;
+  const Intervals &intervals_;
+  std::vector<RoomLoad *> rooms_;
+  PosixClient client_;
+  RedisLink link_{client_};
+  Samples *samples_ = nullptr;
+  uint8_t phase_ = 0;
+  String json_;
+  char error_[96] = "";
+};
+
+/** The website's fleet view: every room's five state keys, eight GETs per pipeline. */
+void runDashboard(const Settings &settings, std::vector<std::unique_ptr<RoomLoad>> &rooms, uint64_t endNs,
+                  const std::atomic<bool> &rewriting, Samples &samples) {
+  if (!settings.dashboardMs) {
+    return;
+  }
+  PosixClient client;
+  RedisLink link(client);
+  if (!bench::openLink(settings, client, link)) {
+    ++samples.failures;
+    return;
+  }
+  const auto interval = std::chrono::nanoseconds(static_cast<uint64_t>(settings.dashboardMs * 1e6 / settings.speedup));
+  String values[RedisLink::kMaxPipelineDepth];
+  while (bench::nowNs() < endNs) {
+    const auto next = std::chrono::steady_clock::now() + interval;
+    const uint8_t phase = rewriting.load(std::memory_order_relaxed) ? 1 : 0;
+    const uint64_t start = bench::nowNs();
+    uint8_t queued = 0;
+    bool ok = true;
+    link.beginPipeline();
+    for (auto &room : rooms) {
+      const RedisLink::KeyView keys[5] = {room->keys.cfg, room->keys.override_, room->keys.latestWarning,
+                                          room->keys.desired, room->keys.ward};
+      for (const RedisLink::KeyView &key : keys) {
+        link.queueGet(key, values[queued++]);
+        if (queued == RedisLink::kMaxPipelineDepth) {
+          ok = link.execPipeline() && ok;
+          link.beginPipeline();
+          queued = 0;
+        }
+      }
+    }
+    ok = (queued ? link.execPipeline() : (link.execPipeline(), true)) && ok;
+    if (!ok) {
+      ++samples.failures;
+      if (!bench::openLink(settings, client, link)) {
+        return;
+      }
+    } else {
+      samples.us[kDashboard][phase].push_back(static_cast<uint32_t>((bench::nowNs() - start) / 1000));
+      samples.ops += rooms.size() * 5;
+    }
+    std::this_thread::sleep_until(next);
+  }
+}
+
+/** Bytes of each per-room key and stream, averaged over the first sampled rooms. */
+struct RoomMemory {
+  double cmd = 0;
+  double state = 0;
+  double telemetry = 0;
+  double keys = 0;
+  double total() const { return cmd + state + telemetry + keys; }
+};
+
+bool measureRoomMemory(RedisLink &link, std::vector<std::unique_ptr<RoomLoad>> &rooms, RoomMemory &out) {
+  const size_t sample = std::min<size_t>(rooms.size(), kMemorySampleRooms);
+  for (size_t i = 0; i < sample; ++i) {
+    const contracts::RoomKeys &k = rooms[i]->keys;
+    long bytes[10] = {};
+    const RedisLink::KeyView names[10] = {k.cmd,    k.state,         k.telemetry, k.desired, k.reported,
+                                          k.online, k.latestWarning, k.override_, k.cfg,     k.metrics};
+    for (uint8_t n = 0; n < 10; ++n) {
+      if (!link.memoryUsage(names[n], bytes[n])) {
+        return false;
+      }
+    }
+    out.cmd += bytes[0];
+    out.state += bytes[1];
+    out.telemetry += bytes[2];
+    for (uint8_t n = 3; n < 10; ++n) {
+      out.keys += bytes[n];
+    }
+  }
+  out.cmd /= sample;
+  out.state /= sample;
+  out.telemetry /= sample;
+  out.keys /= sample;
+  return true;
+}
+
+/** Largest trim length whose streams fit `budget` bytes across the fleet (0 if none). */
+unsigned affordableEntries(double budget, unsigned rooms, double bytesPerEntry) {
+  if (budget <= 0 || bytesPerEntry <= 0) {
+    return 0;
+  }
+  return static_cast<unsigned>(budget / rooms / bytesPerEntry);
+}
+
+/** Runs one scenario and prints its report; returns false when setup failed. */
+bool runScenario(const Settings &settings, unsigned roomCount) {
+  const unsigned threadCount = std::min(settings.threads, roomCount);
+  bench::raiseFileLimit(threadCount + 2);  // workers, the dashboard and the monitor
+  std::vector<std::unique_ptr<RoomLoad>> rooms;
+  for (unsigned i = 0; i < roomCount; ++i) {
+    auto room = std::make_unique<RoomLoad>();
+    room->id = String("cap-");
+    room->id += String(i + 1);
+    room->keys.assign(room->id);
+    rooms.push_back(std::move(room));
+  }
+  PosixClient monitorClient;
+  RedisLink monitor(monitorClient);
+  String info;
+  if (!bench::openLink(settings, monitorClient, monitor) || !monitor.info("memory", info)) {
+    std::fprintf(stderr, "monitor: cannot reach redis at %s:%u (%s)\n", settings.host, settings.port,
+                 monitor.lastError().c_str());
+    return false;
+  }
+  const double usedBefore = infoField(info, "used_memory");
+  const double maxMemory = infoField(info, "maxmemory");
+
+  const Intervals intervals(settings);
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (unsigned t = 0; t < threadCount; ++t) {
+    std::vector<RoomLoad *> slice;
+    for (unsigned i = t; i < roomCount; i += threadCount) {
+      slice.push_back(rooms[i].get());
+    }
+    workers.push_back(std::make_unique<Worker>(settings, intervals, std::move(slice)));
+    if (!workers.back()->start()) {
+      std::fprintf(stderr, "worker %u: setup failed\n", t);
+      return false;
+    }
+  }
+
+  std::printf("\n== %u rooms ==\n", roomCount);
+  uint64_t phaseNs = bench::nowNs();
+  std::atomic<bool> prefillOk{true};
+  {
+    std::vector<std::thread> threads;
+    for (auto &worker : workers) {
+      threads.emplace_back([&, w = worker.get()] {
+        if (!w->prefill()) {
+          std::fprintf(stderr, "prefill: %s\n", w->lastError());
+          prefillOk.store(false);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  if (!prefillOk.load()) {
+    return false;
+  }
+  std::printf("prefill: streams at %u (cmd/state) and %u (telemetry) entries in %.1f s\n", settings.trimLen,
+              RECEIVER_TELEMETRY_ENABLED ? RECEIVER_TELEMETRY_MAXLEN : 0, (bench::nowNs() - phaseNs) / 1e9);
+
+  RoomMemory memory;
+  if (!measureRoomMemory(monitor, rooms, memory) || !monitor.info("memory", info)) {
+    std::fprintf(stderr, "memory: %s\n", monitor.lastError().c_str());
+    return false;
+  }
+  const double usedAfterFill = infoField(info, "used_memory");
+
+  // Traffic phase.
+  String stats;
+  monitor.info("stats", stats);
+  const double commandsBefore = infoField(stats, "total_commands_processed");
+  std::atomic<bool> rewriting{false};
+  const uint64_t startNs = bench::nowNs();
+  const uint64_t endNs = startNs + static_cast<uint64_t>(settings.seconds) * 1000000000ULL;
+  std::vector<Samples> samples(threadCount + 1);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < threadCount; ++t) {
+    workers[t]->schedule(startNs, 0x9e3779b9U * (t + 1));
+    threads.emplace_back([&, t] { workers[t]->run(endNs, rewriting, samples[t]); });
+  }
+  threads.emplace_back([&] { runDashboard(settings, rooms, endNs, rewriting, samples[threadCount]); });
+
+  String persistence;
+  monitor.info("persistence", persistence);
+  const bool aofOn = infoField(persistence, "aof_enabled") > 0;
+  double rewriteSec = -1;
+  if (settings.aofRewrite && aofOn) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds((endNs - startNs) / 2));
+    const uint64_t rewriteStart = bench::nowNs();
+    if (monitor.bgRewriteAof()) {
+      rewriting.store(true);
+      while (bench::nowNs() < endNs + 60000000000ULL) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (!monitor.info("persistence", persistence)) {
+          break;
+        }
+        if (infoField(persistence, "aof_rewrite_in_progress") == 0 &&
+            infoField(persistence, "aof_rewrite_scheduled") == 0) {
+          rewriteSec = (bench::nowNs() - rewriteStart) / 1e9;
+          break;
+        }
+      }
+      rewriting.store(false);
+    } else {
+      std::fprintf(stderr, "bgrewriteaof: %s\n", monitor.lastError().c_str());
+    }
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double elapsedSec = (bench::nowNs() - startNs) / 1e9;
+  monitor.info("stats", stats);
+  const double serverOps = (infoField(stats, "total_commands_processed") - commandsBefore) / elapsedSec;
+  monitor.info("memory", info);
+  const double usedAfterRun = infoField(info, "used_memory");
+  monitor.info("persistence", persistence);
+
+  Samples all;
+  for (auto &s : samples) {
+    all.merge(s);
+  }
+
+  const double kb = 1024.0;
+  std::printf("memory/room: %.1f KB (cmd %.1f, state %.1f, telemetry %.1f, keys %.1f); used_memory %.1f MB "
+              "(+%.1f MB prefill, %+.1f MB traffic)\n",
+              memory.total() / kb, memory.cmd / kb, memory.state / kb, memory.telemetry / kb, memory.keys / kb,
+              usedAfterRun / kb / kb, (usedAfterFill - usedBefore) / kb / kb, (usedAfterRun - usedAfterFill) / kb / kb);
+  std::printf("throughput: %.0f ops/s sent, %.0f commands/s at the server, %" PRIu64 " failures; schedule lag "
+              "p99 %u ms\n",
+              all.ops / elapsedSec, serverOps, all.failures, bench::percentile(all.lagMs, 99));
+  std::printf("%-13s %8s %8s %8s %8s %9s | %8s %8s %9s (us, during AOF rewrite)\n", "latency", "n", "p50", "p99",
+              "p99.9", "max", "p50", "p99", "p99.9");
+  uint32_t heartbeatTail = 0;
+  for (uint8_t k = 0; k < kKinds; ++k) {
+    std::vector<uint32_t> &calm = all.us[k][0];
+    std::vector<uint32_t> &busy = all.us[k][1];
+    if (calm.empty() && busy.empty()) {
+      continue;
+    }
+    std::vector<uint32_t> both(calm);
+    both.insert(both.end(), busy.begin(), busy.end());
+    const uint32_t max = *std::max_element(both.begin(), both.end());
+    const uint32_t p999 = bench::percentile(both, 99.9);
+    if (k == kHeartbeat) {
+      heartbeatTail = std::max(p999, bench::percentile(busy, 99.9));
+    }
+    std::printf("%-13s %8zu %8u %8u %8u %9u |", kKindNames[k], both.size(), bench::percentile(calm, 50),
+                bench::percentile(calm, 99), bench::percentile(calm, 99.9), max);
+    if (busy.empty()) {
+      std::printf(" %8s %8s %9s\n", "-", "-", "-");
+    } else {
+      std::printf(" %8u %8u %9u\n", bench::percentile(busy, 50), bench::percentile(busy, 99), bench::percentile(busy, 99.9));
+    }
+  }
+  if (!aofOn) {
+    std::printf("aof: off on this server\n");
+  } else if (rewriteSec >= 0) {
+    std::printf("aof: rewrite took %.2f s; aof_current_size %.1f MB, aof_base_size %.1f MB\n", rewriteSec,
+                infoField(persistence, "aof_current_size") / kb / kb, infoField(persistence, "aof_base_size") / kb / kb);
+  }
+
+  // Recommendations. Streams may use half the memory budget; keys, client buffers and
+  // the rewrite's copy-on-write pages need the rest.
+  const double budget = (settings.memoryMb ? settings.memoryMb : maxMemory > 0 ? maxMemory / kb / kb : 1024) * kb * kb;
+  const double cmdEntry = (memory.cmd + memory.state) / settings.trimLen;
+  const double telemetryEntry = RECEIVER_TELEMETRY_ENABLED ? memory.telemetry / RECEIVER_TELEMETRY_MAXLEN : 0;
+  const double telemetryBytes = telemetryEntry * RECEIVER_TELEMETRY_MAXLEN * roomCount;
+  const unsigned needed = static_cast<unsigned>(std::ceil(settings.commandsPerMin * settings.outageMin * 1.25));
+  const unsigned affordable = affordableEntries(budget / 2 - telemetryBytes, roomCount, cmdEntry);
+  const unsigned trim = std::max(32u, needed);
+  std::printf("recommend (budget %.0f MB, %.1f cmd/min/room, %u min outage):\n", budget / kb / kb,
+              settings.commandsPerMin, settings.outageMin);
+  if (affordable >= trim) {
+    std::printf("  cmd/state trim ~%u (%.1f KB/room, %.1f MB fleet); fits up to %u\n", trim, trim * cmdEntry / kb,
+                trim * cmdEntry * roomCount / kb / kb, affordable);
+  } else {
+    std::printf("  cmd/state trim ~%u: %u entries are needed for the outage but only %u fit; raise the budget or "
+                "shorten telemetry\n",
+                std::max(affordable, 1u), trim, affordable);
+  }
+  if (RECEIVER_TELEMETRY_ENABLED) {
+    std::printf("  telemetry maxlen %u uses %.1f MB fleet (%.0f B/entry)%s\n", RECEIVER_TELEMETRY_MAXLEN,
+                telemetryBytes / kb / kb, telemetryEntry, telemetryBytes > budget / 2 ? ", over half the budget" : "");
+  }
+  // Survive one lost heartbeat plus a full request timeout at the observed tail latency.
+  const double ttlMs = 2.0 * RECEIVER_HEARTBEAT_MS + bench::kRedisTimeoutMs + heartbeatTail / 1000.0;
+  const unsigned ttlSec = static_cast<unsigned>(std::ceil(ttlMs / 1000.0));
+  std::printf("  heartbeat TTL >= %u s at a %u ms interval (now %u s)%s\n", ttlSec,
+              static_cast<unsigned>(RECEIVER_HEARTBEAT_MS), static_cast<unsigned>(contracts::kHeartbeatTtlSec),
+              ttlSec > contracts::kHeartbeatTtlSec ? ": raise kHeartbeatTtlSec" : "");
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const Settings settings = loadSettings();
+  std::printf("redis %s:%u, %us traffic per scenario, %u threads, speedup %.2gx, %.2g commands/min and %.2g "
+              "warnings/h per room\n",
+              settings.host, settings.port, settings.seconds, settings.threads, settings.speedup,
+              settings.commandsPerMin, settings.warningsPerHour);
+  bool ok = true;
+  for (unsigned rooms : settings.rooms) {
+    ok = runScenario(settings, rooms) && ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// Host microbenchmark: contracts::decodeDesired() fast path vs the ArduinoJson DOM path.
+//
+//   pio run -d native -e bench_codec -t exec
+//
+// Every payload is first decoded both ways and the results compared, so a speedup is only
+// reported for payloads where the two paths agree.
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+
+#include "contracts.hpp"
+
+namespace {
+
+constexpr uint32_t kIterations = 200000;
+
+struct Sample {
+  const char *label;
+  const char *json;
+};
+
+// Shapes actually written by the sender (encodeDesired), the website and older tooling;
+// the last one contains an escape and exercises the DOM fallback.
+const Sample kSamples[] = {
+    {"sender", R"({"mode":"on","brightness":42,"ver":1234,"room":"101"})"},
+    {"website", R"({"room":"101","mode":"on","brightness":100,"ver":57,"source":"website"})"},
+    {"off", R"({"mode":"off","brightness":0,"ver":0})"},
+    {"spaced", "{ \"mode\" : \"on\", \"brightness\" : 7, \"ver\" : 4294967295 }"},
+    {"escaped", R"({"mode":"on","brightness":5,"ver":9,"source":"a\"b"})"},
+};
+
+bool sameResult(bool okA, const contracts::Desired &a, bool okB, const contracts::Desired &b) {
+  return okA == okB && (!okA || contracts::sameDesired(a, b));
+}
+
+template <typename Decode>
+double nsPerDecode(const char *json, Decode decode) {
+  volatile uint32_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    contracts::Desired desired;
+    decode(json, desired);
+    sink = sink + desired.ver + desired.brightness;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / kIterations;
+}
+
+}  // namespace
+
+int main() {
+  bool allMatch = true;
+  std::printf("%-8s %10s %10s %8s  %s\n", "payload", "dom ns", "fast ns", "speedup", "path");
+  for (const auto &sample : kSamples) {
+    contracts::Desired dom;
+    contracts::Desired fast;
+    const bool domOk = contracts::decodeDesiredDom(sample.json, dom);
+    const bool fastOk = contracts::decodeDesired(sample.json, fast);
+    contracts::Desired probe;
+    const bool tookFastPath = contracts::decodeDesiredFast(sample.json, probe);
+    if (!sameResult(domOk, dom, fastOk, fast)) {
+      std::printf("%-8s MISMATCH dom(%d %s %u %" PRIu32 ") fast(%d %s %u %" PRIu32 ")\n", sample.label,
+                  domOk, dom.mode, dom.brightness, dom.ver, fastOk, fast.mode, fast.brightness, fast.ver);
+      allMatch = false;
+      continue;
+    }
+    const double domNs = nsPerDecode(sample.json, contracts::decodeDesiredDom);
+    const double fastNs = nsPerDecode(sample.json, [](const char *json, contracts::Desired &out) {
+      return contracts::decodeDesired(json, out);
+    });
+    std::printf("%-8s %10.1f %10.1f %7.2fx  %s\n", sample.label, domNs, fastNs, domNs / fastNs,
+                tookFastPath ? "fast" : "dom fallback");
+  }
+  return allMatch ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+// Scaffolding shared by the host benchmarks that talk to a real Redis (bench_e2e,
+// bench_capacity): the BENCH_REDIS_* / BENCH_ROOMS overrides, link setup, timing and
+// percentiles. Header-only, since each bench builds from its own directory.
+
+#include <Arduino.h>
+#include <PosixClient.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#include "redis_link.hpp"
+
+namespace bench {
+
+constexpr uint16_t kRedisTimeoutMs = 1500;
+
+/** Where the target Redis is: BENCH_REDIS_HOST, BENCH_REDIS_PORT, BENCH_REDIS_PASSWORD. */
+struct RedisTarget {
+  const char *host = "127.0.0.1";
+  uint16_t port = 6379;
+  const char *password = "";
+};
+
+/** Applies the BENCH_REDIS_* overrides to `target`. */
+inline void loadRedisTarget(RedisTarget &target) {
+  if (const char *v = getenv("BENCH_REDIS_HOST")) {
+    target.host = v;
+  }
+  if (const char *v = getenv("BENCH_REDIS_PORT")) {
+    target.port = static_cast<uint16_t>(atoi(v));
+  }
+  if (const char *v = getenv("BENCH_REDIS_PASSWORD")) {
+    target.password = v;
+  }
+}
+
+/** Replaces `rooms` with the comma-separated BENCH_ROOMS counts when set (zeros skipped). */
+inline void loadRoomCounts(std::vector<unsigned> &rooms) {
+  const char *v = getenv("BENCH_ROOMS");
+  if (!v) {
+    return;
+  }
+  rooms.clear();
+  for (const char *p = v; *p;) {
+    char *end = nullptr;
+    unsigned long n = strtoul(p, &end, 10);
+    if (end == p) {
+      break;
+    }
+    if (n) {
+      rooms.push_back(static_cast<unsigned>(n));
+    }
+    p = *end ? end + 1 : end;
+  }
+}
+
+inline uint64_t nowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+/** Connects and authenticates one link. */
+inline bool openLink(const RedisTarget &target, PosixClient &client, RedisLink &link) {
+  if (!client.connect(target.host, target.port)) {
+    return false;
+  }
+  client.setTimeout(kRedisTimeoutMs);
+  link.setTimeout(kRedisTimeoutMs);
+  return link.auth(target.password);
+}
+
+/** Nearest-rank percentile; reorders `values`. */
+inline uint32_t percentile(std::vector<uint32_t> &values, double pct) {
+  if (values.empty()) {
+    return 0;
+  }
+  size_t rank = static_cast<size_t>(pct / 100.0 * (values.size() - 1) + 0.5);
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+/** Raises the open-file limit so `sockets` connections fit next to the usual descriptors. */
+inline void raiseFileLimit(unsigned sockets) {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return;
+  }
+  rlim_t wanted = static_cast<rlim_t>(sockets) + 64;
+  if (limit.rlim_cur < wanted) {
+    limit.rlim_cur = std::min(wanted, limit.rlim_max);
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+}  // namespace bench
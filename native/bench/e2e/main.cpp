@@ -0,0 +1,363 @@
+// Host end-to-end benchmark for command delivery against a real Redis (docker-compose):
+// publish (what `sendBrightnessCommand()` does) -> receiver XREAD -> apply -> reported.
+//
+//   docker compose up -d redis
+//   pio run -d native -e bench_e2e -t exec
+//
+// Each simulated room runs the receiver's protocol over RedisLink + PosixClient: a reader
+// link with an asynchronous `XREAD BLOCK` on `cmd:room:{id}` and a writer link that
+// records `room:{id}:reported` through the shared publish script. A publisher thread plays
+// the website with one command in flight per room, sending the next as soon as the last
+// one is reported. Environment overrides: BENCH_REDIS_HOST, BENCH_REDIS_PORT,
+// BENCH_REDIS_PASSWORD, BENCH_ROOMS (default "1,20,100,500"), BENCH_SECONDS (per
+// scenario, default 10) and BENCH_RECEIVER_THREADS (default 4). Rooms are named
+// `bench-<n>`, so the run never touches real room keys.
+
+#include <Arduino.h>
+#include <PosixClient.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../common.hpp"
+#include "contracts.hpp"
+#include "redis_link.hpp"
+
+namespace {
+
+constexpr uint16_t kStreamTrimLen = 200;
+constexpr uint16_t kXreadBlockMs = 1000;
+constexpr uint8_t kXreadCount = 8;
+/** A command not reported within this long counts as lost and the room moves on. */
+constexpr uint64_t kCommandTimeoutNs = 2000000000ULL;
+
+struct Settings : bench::RedisTarget {
+  std::vector<unsigned> rooms = {1, 20, 100, 500};
+  unsigned seconds = 10;
+  unsigned receiverThreads = 4;
+};
+
+Settings loadSettings() {
+  Settings settings;
+  bench::loadRedisTarget(settings);
+  bench::loadRoomCounts(settings.rooms);
+  if (const char *v = getenv("BENCH_SECONDS")) {
+    settings.seconds = std::max(1, atoi(v));
+  }
+  if (const char *v = getenv("BENCH_RECEIVER_THREADS")) {
+    settings.receiverThreads = std::max(1, atoi(v));
+  }
+  return settings;
+}
+
+/**
+ * One room's keys plus the publisher -> receiver hand-off for its in-flight command:
+ * the publisher stores `sentNs` before releasing `sentVer`, the receiver releases
+ * `doneVer` once the reported write went through.
+ */
+struct Room {
+  String id;
+  contracts::RoomKeys keys;
+  std::atomic<uint32_t> sentVer{0};
+  std::atomic<uint64_t> sentNs{0};
+  std::atomic<uint32_t> doneVer{0};
+};
+
+/** Per-stage latencies (microseconds from publish) collected by one receiver thread. */
+struct Samples {
+  std::vector<uint32_t> read;
+  std::vector<uint32_t> apply;
+  std::vector<uint32_t> reported;
+};
+
+/** The receiver's `CommandBatchVisitor`: keeps only the newest command of a batch. */
+struct BatchVisitor : RedisLink::StreamVisitor {
+  char id[RedisLink::kStreamIdCapacity] = "";
+  char payload[192] = "";
+  char mode[2] = "";
+  char brightness[4] = "";
+  char ver[11] = "";
+  char fade[11] = "";
+  char lastId[RedisLink::kStreamIdCapacity] = "";
+  contracts::Desired newest;
+  bool found = false;
+
+  void reset() {
+    lastId[0] = '\0';
+    found = false;
+  }
+  bool entry(const char *entryId) {
+    if (strlen(entryId) >= sizeof(id)) {
+      return false;
+    }
+    strcpy(id, entryId);
+    strcpy(lastId, entryId);
+    payload[0] = mode[0] = brightness[0] = ver[0] = fade[0] = '\0';
+    return true;
+  }
+  char *field(const char *name, size_t &cap) {
+    if (!name[0] || name[1]) {
+      return nullptr;
+    }
+    switch (name[0]) {
+      case 'p':
+        cap = sizeof(payload);
+        return payload;
+      case 'm':
+        cap = sizeof(mode);
+        return mode;
+      case 'b':
+        cap = sizeof(brightness);
+        return brightness;
+      case 'v':
+        cap = sizeof(ver);
+        return ver;
+      case 'f':
+        cap = sizeof(fade);
+        return fade;
+      default:
+        return nullptr;
+    }
+  }
+  void entryDone(bool complete) {
+    contracts::Desired desired;
+    bool decoded = payload[0] ? contracts::decodeDesired(payload, desired)
+                              : contracts::decodeDesiredCompact(mode, brightness, ver, fade[0] ? fade : nullptr,
+                                                                desired);
+    if (complete && decoded && (!found || desired.ver >= newest.ver)) {
+      newest = desired;
+      found = true;
+    }
+  }
+};
+
+/** A simulated receiver: `pumpStream()` + `applyCommand()` + `recordState()` for one room. */
+class SimReceiver {
+ public:
+  explicit SimReceiver(Room &room) : room_(room) {}
+
+  bool start(const Settings &settings) {
+    if (!bench::openLink(settings, readerClient_, reader_) || !bench::openLink(settings, writerClient_, writer_)) {
+      return false;
+    }
+    if (!writer_.loadPublishScript(FPSTR(contracts::kPublishScript))) {
+      return false;
+    }
+    if (!reader_.streamTailId(room_.keys.cmd, cursor_, sizeof(cursor_))) {
+      return false;
+    }
+    if (!cursor_[0]) {
+      strcpy(cursor_, "0-0");
+    }
+    return true;
+  }
+
+  /** Advances this room by one non-blocking step; returns false once a link failed. */
+  bool pump(Samples &samples) {
+    if (!reader_.asyncPending()) {
+      const char *cursor = cursor_;
+      const RedisLink::KeyView stream = room_.keys.cmd;
+      batch_.reset();
+      return reader_.beginXreadStreams(&stream, &cursor, 1, kXreadBlockMs, kXreadCount);
+    }
+    RedisLink::AsyncResult result = reader_.pollXread(batch_);
+    if (result == RedisLink::AsyncResult::Pending) {
+      return true;
+    }
+    if (result == RedisLink::AsyncResult::Failed) {
+      return false;
+    }
+    const uint64_t readNs = bench::nowNs();
+    if (batch_.lastId[0]) {
+      strcpy(cursor_, batch_.lastId);
+    }
+    if (!batch_.found || batch_.newest.ver <= lastVer_) {
+      return true;
+    }
+    const contracts::Desired desired = batch_.newest;
+    if (!contracts::encodeDesired(desired, &room_.id, json_)) {
+      return false;
+    }
+    contracts::encodeDesiredCompact(desired, compact_);
+    lastVer_ = desired.ver;
+    const uint64_t appliedNs = bench::nowNs();
+    uint32_t storedVer = 0;
+    if (!writer_.evalPublishScript(FPSTR(contracts::kPublishScript), room_.keys.reported, room_.keys.state, json_,
+                                   desired.ver, kStreamTrimLen, storedVer, compact_.args, compact_.count, true)) {
+      return false;
+    }
+    const uint64_t reportedNs = bench::nowNs();
+    if (room_.sentVer.load(std::memory_order_acquire) == desired.ver) {
+      const uint64_t sentNs = room_.sentNs.load(std::memory_order_relaxed);
+      samples.read.push_back(static_cast<uint32_t>((readNs - sentNs) / 1000));
+      samples.apply.push_back(static_cast<uint32_t>((appliedNs - sentNs) / 1000));
+      samples.reported.push_back(static_cast<uint32_t>((reportedNs - sentNs) / 1000));
+    }
+    room_.doneVer.store(desired.ver, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  Room &room_;
+  PosixClient readerClient_;
+  PosixClient writerClient_;
+  RedisLink reader_{readerClient_};
+  RedisLink writer_{writerClient_};
+  char cursor_[RedisLink::kStreamIdCapacity] = "";
+  uint32_t lastVer_ = 0;
+  BatchVisitor batch_;
+  contracts::CompactDesired compact_;
+  String json_;
+};
+
+/** Runs one scenario and prints its result row; returns false when setup failed. */
+bool runScenario(const Settings &settings, unsigned roomCount) {
+  bench::raiseFileLimit(roomCount * 2);  // a reader and a writer link per room
+  std::vector<std::unique_ptr<Room>> rooms;
+  for (unsigned i = 0; i < roomCount; ++i) {
+    auto room = std::make_unique<Room>();
+    room->id = String("bench-");
+    room->id += String(i + 1);
+    room->keys.assign(room->id);
+    rooms.push_back(std::move(room));
+  }
+
+  // Versions keep rising across runs; seed from the stored snapshots like the sender does.
+  PosixClient publisherClient;
+  RedisLink publisher(publisherClient);
+  if (!bench::openLink(settings, publisherClient, publisher) ||
+      !publisher.loadPublishScript(FPSTR(contracts::kPublishScript))) {
+    std::fprintf(stderr, "publisher: cannot reach redis at %s:%u (%s)\n", settings.host, settings.port,
+                 publisher.lastError().c_str());
+    return false;
+  }
+  std::vector<uint32_t> nextVer(roomCount, 1);
+  for (unsigned i = 0; i < roomCount; ++i) {
+    String stored;
+    bool isNull = false;
+    contracts::Desired seed;
+    if (publisher.get(rooms[i]->keys.desired, stored, &isNull) && !isNull && contracts::decodeDesired(stored, seed)) {
+      nextVer[i] = seed.ver + 1;
+    }
+  }
+
+  std::vector<std::unique_ptr<SimReceiver>> receivers;
+  for (auto &room : rooms) {
+    receivers.push_back(std::make_unique<SimReceiver>(*room));
+    if (!receivers.back()->start(settings)) {
+      std::fprintf(stderr, "receiver %s: setup failed\n", room->id.c_str());
+      return false;
+    }
+  }
+
+  std::atomic<bool> running{true};
+  std::atomic<unsigned> linkFailures{0};
+  const unsigned threadCount = std::min(settings.receiverThreads, roomCount);
+  std::vector<Samples> samples(threadCount);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&, t] {
+      while (running.load(std::memory_order_relaxed)) {
+        for (unsigned i = t; i < roomCount; i += threadCount) {
+          if (!receivers[i]->pump(samples[t])) {
+            linkFailures.fetch_add(1);
+            running.store(false);
+            return;
+          }
+        }
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  uint64_t sent = 0;
+  uint64_t lost = 0;
+  const uint64_t startNs = bench::nowNs();
+  const uint64_t endNs = startNs + static_cast<uint64_t>(settings.seconds) * 1000000000ULL;
+  contracts::CompactDesired compact;
+  String json;
+  while (running.load(std::memory_order_relaxed) && bench::nowNs() < endNs) {
+    bool idle = true;
+    for (unsigned i = 0; i < roomCount; ++i) {
+      Room &room = *rooms[i];
+      const uint32_t inFlight = room.sentVer.load(std::memory_order_relaxed);
+      if (inFlight && room.doneVer.load(std::memory_order_acquire) < inFlight) {
+        if (bench::nowNs() - room.sentNs.load(std::memory_order_relaxed) < kCommandTimeoutNs) {
+          continue;
+        }
+        ++lost;
+      }
+      contracts::Desired desired;
+      strcpy(desired.mode, "on");
+      desired.brightness = static_cast<uint8_t>(nextVer[i] % 101);
+      desired.ver = nextVer[i];
+      if (!contracts::encodeDesired(desired, &room.id, json)) {
+        running.store(false);
+        break;
+      }
+      contracts::encodeDesiredCompact(desired, compact);
+      room.sentNs.store(bench::nowNs(), std::memory_order_relaxed);
+      room.sentVer.store(desired.ver, std::memory_order_release);
+      uint32_t storedVer = 0;
+      if (!publisher.evalPublishScript(FPSTR(contracts::kPublishScript), room.keys.desired, room.keys.cmd, json,
+                                       desired.ver, kStreamTrimLen, storedVer, compact.args, compact.count)) {
+        std::fprintf(stderr, "publisher: %s\n", publisher.lastError().c_str());
+        running.store(false);
+        break;
+      }
+      if (storedVer != desired.ver) {
+        // Stale (the snapshot moved on): nothing reached the stream, retry at the next version.
+        room.sentVer.store(0, std::memory_order_relaxed);
+        nextVer[i] = storedVer;
+        continue;
+      }
+      nextVer[i] = desired.ver + 1;
+      ++sent;
+      idle = false;
+    }
+    if (idle) {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+  }
+  const double elapsedSec = static_cast<double>(bench::nowNs() - startNs) / 1e9;
+  running.store(false);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  Samples all;
+  for (auto &s : samples) {
+    all.read.insert(all.read.end(), s.read.begin(), s.read.end());
+    all.apply.insert(all.apply.end(), s.apply.begin(), s.apply.end());
+    all.reported.insert(all.reported.end(), s.reported.begin(), s.reported.end());
+  }
+  const size_t done = all.reported.size();
+  std::printf("%6u %9" PRIu64 " %9zu %6" PRIu64 " %10.0f %8u %8u %8u %8u %8u %8u\n", roomCount, sent, done, lost,
+              done / elapsedSec, bench::percentile(all.read, 50), bench::percentile(all.read, 99), bench::percentile(all.apply, 50),
+              bench::percentile(all.apply, 99), bench::percentile(all.reported, 50), bench::percentile(all.reported, 99));
+  if (linkFailures.load()) {
+    std::fprintf(stderr, "rooms=%u: a receiver link failed, results cover the run up to it\n", roomCount);
+  }
+  return !linkFailures.load();
+}
+
+}  // namespace
+
+int main() {
+  const Settings settings = loadSettings();
+  std::printf("redis %s:%u, %us per scenario, %u receiver threads; latencies in us from publish\n",
+              settings.host, settings.port, settings.seconds, settings.receiverThreads);
+  std::printf("%6s %9s %9s %6s %10s %8s %8s %8s %8s %8s %8s\n", "rooms", "sent", "reported", "lost", "cmd/s",
+              "read50", "read99", "apply50", "apply99", "rep50", "rep99");
+  bool ok = true;
+  for (unsigned rooms : settings.rooms) {
+    ok = runScenario(settings, rooms) && ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,349 @@
+// Host check: RedisLink's RESP encoder/parsers and the contracts codecs, built with
+// AddressSanitizer + UBSan.
+//
+//   pio run -d native -e check_redis_link -t exec
+//
+// Commands are encoded into a ScriptedClient and compared byte for byte; canned replies
+// are parsed whole and again split into 1- and 7-byte reads. Then a few thousand
+// truncated or corrupted replies go through the same parsers, which must fail cleanly
+// (the sanitizers flag any out-of-bounds access). Exits non-zero on the first mismatch.
+
+#include <Arduino.h>
+#include <ScriptedClient.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "contracts.hpp"
+#include "metrics.hpp"
+#include "redis_link.hpp"
+#include "scheduler.hpp"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+      ++failures;                                                     \
+    }                                                                 \
+  } while (0)
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t bound) {
+    state = state * 1664525UL + 1013904223UL;
+    return (state >> 8) % bound;
+  }
+};
+
+/** Collects every entry of an XREAD reply as `stream|id|field=value,...` lines. */
+struct RecordingVisitor : RedisLink::StreamVisitor {
+  std::string current;
+  std::vector<std::string> entries;
+  char value[32] = "";
+  std::string stream_;
+  std::vector<uint8_t> at;
+
+  void stream(const char *name) { stream_ = name; }
+  void streamAt(uint8_t index) { at.push_back(index); }
+  bool entry(const char *id) {
+    current = stream_ + "|" + id + "|";
+    return true;
+  }
+  char *field(const char *name, size_t &cap) {
+    flushField();
+    pendingName = name;
+    cap = sizeof(value);
+    value[0] = '\0';
+    return value;
+  }
+  void entryDone(bool complete) {
+    flushField();
+    entries.push_back(current + (complete ? "" : "!"));
+  }
+
+ private:
+  std::string pendingName;
+  void flushField() {
+    if (!pendingName.empty()) {
+      current += pendingName + "=" + value + ",";
+      pendingName.clear();
+    }
+  }
+};
+
+const char kXreadReply[] =
+    "*1\r\n*2\r\n$10\r\ncmd:room:7\r\n*2\r\n"
+    "*2\r\n$3\r\n1-0\r\n*6\r\n$1\r\nm\r\n$1\r\n1\r\n$1\r\nb\r\n$2\r\n42\r\n$1\r\nv\r\n$1\r\n5\r\n"
+    "*2\r\n$3\r\n2-0\r\n*2\r\n$1\r\np\r\n$37\r\n{\"mode\":\"off\",\"brightness\":0,\"ver\":6}\r\n";
+
+void checkEncoding() {
+  ScriptedClient client;
+  RedisLink link(client);
+  client.reset("+OK\r\n");
+  CHECK(link.set("room:1:desired", "{}"));
+  CHECK(client.output == "*3\r\n$3\r\nSET\r\n$14\r\nroom:1:desired\r\n$2\r\n{}\r\n");
+
+  // A payload larger than the frame buffer streams out in chunks but stays one command.
+  std::string big(3 * REDIS_LINK_FRAME_CAPACITY + 5, 'x');
+  client.reset("+OK\r\n");
+  CHECK(link.set("k", big.c_str()));
+  CHECK(client.output == "*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$" + std::to_string(big.size()) + "\r\n" + big + "\r\n");
+}
+
+void checkPipeline(size_t chunk) {
+  ScriptedClient client;
+  client.chunk = chunk;
+  RedisLink link(client);
+  client.reset("+OK\r\n$5\r\nhello\r\n$-1\r\n:3\r\n");
+  String got;
+  String missing;
+  bool missingNull = false;
+  link.beginPipeline();
+  CHECK(link.queueSet("a", "hello"));
+  CHECK(link.queueGet("a", got));
+  CHECK(link.queueGet("b", missing, &missingNull));
+  CHECK(link.queuePublish("evt:room:1", "cfg"));
+  CHECK(link.execPipeline());
+  CHECK(got == "hello");
+  CHECK(missingNull);
+  CHECK(client.readPos == client.input.size());
+
+  // An error reply fails the batch but later replies are still drained.
+  client.reset("-ERR wrong type\r\n:1\r\n");
+  link.beginPipeline();
+  link.queueHset("h", "f", "v");
+  link.queueExpire("h", 30);
+  CHECK(!link.execPipeline());
+  CHECK(link.lastError().startsWith("ERR wrong type"));
+  CHECK(client.readPos == client.input.size());
+}
+
+void checkXread(size_t chunk) {
+  ScriptedClient client;
+  client.chunk = chunk;
+  RedisLink link(client);
+  client.reset(kXreadReply);
+  RecordingVisitor visitor;
+  CHECK(link.xread("cmd:room:7", 0, "0-0", 8, visitor));
+  CHECK(visitor.entries.size() == 2);
+  if (visitor.entries.size() == 2) {
+    CHECK(visitor.entries[0] == "cmd:room:7|1-0|m=1,b=42,v=5,");
+    // 37-byte payload into a 32-byte buffer: kept truncated and flagged incomplete.
+    CHECK(visitor.entries[1].back() == '!');
+  }
+  CHECK(client.output.find("XREAD") != std::string::npos);
+
+  client.reset("*-1\r\n");
+  RecordingVisitor empty;
+  CHECK(link.xread("cmd:room:7", 0, "0-0", 8, empty));
+  CHECK(empty.entries.empty());
+
+  // Streams map to their request position even when their names only differ past the
+  // kept prefix; a stream that was not asked for maps to none.
+  std::string shared = "cmd:ward:" + std::string(64, 'w');
+  std::string first = shared + "1";
+  std::string second = shared + "2";
+  const RedisLink::KeyView streams[] = {"cmd:room:7", first.c_str(), second.c_str()};
+  const char *const since[] = {"0-0", "0-0", "0-0"};
+  auto pair = [](const std::string &name) {
+    return "*2\r\n$" + std::to_string(name.size()) + "\r\n" + name + "\r\n*1\r\n"
+           "*2\r\n$3\r\n1-0\r\n*2\r\n$1\r\nv\r\n$1\r\n1\r\n";
+  };
+  client.reset("*3\r\n" + pair("cmd:room:7") + pair(second) + pair(first));
+  RecordingVisitor positions;
+  CHECK(link.xreadStreams(streams, since, 3, 0, 8, positions));
+  CHECK(positions.at == std::vector<uint8_t>({0, 2, RedisLink::kUnknownStream}));
+  CHECK(client.readPos == client.input.size());
+}
+
+void checkContracts() {
+  contracts::Desired desired;
+  CHECK(contracts::decodeDesiredFast(R"({"mode":"on","brightness":42,"ver":1234,"fade_ms":500})", desired));
+  CHECK(strcmp(desired.mode, "on") == 0 && desired.brightness == 42 && desired.ver == 1234 && desired.fadeMs == 500);
+  contracts::Desired clamped;
+  CHECK(contracts::decodeDesiredFast(R"({"mode":"on","brightness":142,"ver":1})", clamped) && clamped.brightness == 100);
+  CHECK(!contracts::decodeDesiredFast(R"({"mode":"dim","brightness":1,"ver":1})", clamped));
+
+  contracts::Desired ward;
+  CHECK(contracts::decodeDesiredFast(R"({"mode":"on","brightness":5,"ver":3,"scope":"ward","prio":12})", ward));
+  CHECK(ward.scope == contracts::Scope::Ward && ward.priority == contracts::kPriorityMax);
+  CHECK(!contracts::decodeDesiredFast(R"({"mode":"on","brightness":5,"ver":3,"scope":"floor"})", ward));
+  CHECK(contracts::decodeDesiredFast(R"({"mode":"off","brightness":0,"ver":4})", ward));
+  CHECK(ward.scope == contracts::Scope::Room && ward.priority == contracts::kPriorityNormal);
+
+  contracts::CompactDesired compact;
+  contracts::encodeDesiredCompact(desired, compact);
+  contracts::Desired back;
+  CHECK(contracts::decodeDesiredCompact(compact.args[1], compact.args[3], compact.args[5],
+                                        compact.count > contracts::kCompactFieldArgs ? compact.args[7] : nullptr,
+                                        back));
+  CHECK(contracts::sameDesired(desired, back));
+  CHECK(contracts::key_metrics("12") == "room:12:metrics");
+  CHECK(contracts::stream_cmd("12") == "cmd:room:12");
+  CHECK(contracts::stream_ward_cmd("icu") == "cmd:ward:icu");
+  CHECK(contracts::key_ward_desired("icu") == "ward:icu:desired");
+
+  // Prebuilt keys spell every name like the String helpers and fit the longest id.
+  contracts::RoomKeys keys;
+  const String longest(std::string(contracts::kRoomIdMaxLen, '9').c_str());
+  CHECK(keys.assign(longest));
+  CHECK(contracts::key_latest_warning(longest) == keys.latestWarning.c_str());
+  CHECK(keys.latestWarning.length() == strlen(keys.latestWarning.c_str()));
+  CHECK(keys.assign("12"));
+  CHECK(contracts::key_desired("12") == keys.desired.c_str());
+  CHECK(contracts::stream_telemetry("12") == keys.telemetry.c_str());
+  CHECK(contracts::channel_events("12") == keys.events.c_str());
+  CHECK(!keys.assign(std::string(contracts::kRoomIdMaxLen + 1, '9').c_str()) && !keys.cmd.length());
+
+  ScriptedClient client;
+  RedisLink link(client);
+  keys.assign("12");
+  client.reset("+OK\r\n");
+  CHECK(link.set(keys.override_, "{}"));
+  CHECK(client.output == "*3\r\n$3\r\nSET\r\n$16\r\nroom:12:override\r\n$2\r\n{}\r\n");
+}
+
+void checkPrecedence() {
+  using contracts::Scope;
+  CHECK(contracts::compareStreamIds("10-2", "9-5") > 0 && contracts::compareStreamIds("10-2", "10-10") < 0);
+  CHECK(contracts::compareStreamIds("1-0", "") > 0 && contracts::compareStreamIds("7-1", "7-1") == 0);
+
+  contracts::Desired room;
+  contracts::Desired ward;
+  ward.scope = Scope::Ward;
+  // Nothing shown yet: either scope takes over.
+  CHECK(contracts::outranks(room, "1-0", Scope::Room, contracts::kPriorityNormal, ""));
+  CHECK(contracts::outranks(ward, "1-0", Scope::Room, contracts::kPriorityNormal, ""));
+  // A ward broadcast at priority 2 is shown: later room commands are held back...
+  CHECK(!contracts::outranks(room, "3-0", Scope::Ward, 2, "2-0"));
+  // ...unless they rank higher, while any newer broadcast of the ward replaces its hold.
+  room.priority = 3;
+  CHECK(contracts::outranks(room, "3-0", Scope::Ward, 2, "2-0"));
+  room.priority = contracts::kPriorityNormal;
+  CHECK(contracts::outranks(ward, "4-0", Scope::Ward, 2, "2-0"));
+  ward.priority = 1;
+  CHECK(contracts::outranks(ward, "4-0", Scope::Ward, 2, "2-0"));
+  // Released at normal priority, the next room command wins again; an older one does not.
+  CHECK(contracts::outranks(room, "5-0", Scope::Ward, contracts::kPriorityNormal, "4-0"));
+  CHECK(!contracts::outranks(room, "3-9", Scope::Ward, contracts::kPriorityNormal, "4-0"));
+  // A room command always replaces the room's own, whatever its priority.
+  CHECK(contracts::outranks(room, "6-0", Scope::Room, 5, "5-0"));
+}
+
+void checkHistogram() {
+  using metrics::Histogram;
+  for (uint32_t v = 1; v < (1UL << 22); v += 1 + v / 64) {
+    uint8_t b = Histogram::bucketOf(v);
+    CHECK(v <= Histogram::upperEdge(b) || b == Histogram::kBuckets - 1);
+    CHECK(b == 0 || v > Histogram::upperEdge(b - 1));
+  }
+  Histogram h;
+  for (uint32_t i = 1; i <= 100; ++i) {
+    h.record(i);
+  }
+  CHECK(h.count() == 100 && h.max() == 100);
+  CHECK(h.percentile(50) >= 50 && h.percentile(50) < 63);
+  CHECK(h.percentile(100) == 100);
+}
+
+int taskRuns = 0;
+bool taskResult = true;
+bool taskChanged = false;
+bool countRun(unsigned long) {
+  ++taskRuns;
+  return taskResult;
+}
+unsigned long thousandMs() { return 1000; }
+
+void checkScheduler() {
+  sched::Cadence cadence;
+  CHECK(cadence.update(0, true, 0) && cadence.pace() == sched::Pace::Active);
+  CHECK(cadence.scale(2000) == 500 && cadence.scale(400) == 250 && cadence.scale(100) == 100);
+  cadence.update(sched::Cadence::kActiveHoldMs, false, 0);
+  CHECK(cadence.pace() == sched::Pace::Normal && cadence.scale(2000) == 2000);
+  cadence.update(SCHED_IDLE_AFTER_MS, false, 0);
+  CHECK(cadence.pace() == sched::Pace::Idle && cadence.scale(2000) == 8000);
+  // Long idle stays idle across millis() wrap-around; activity or latency moves it.
+  cadence.update(SCHED_IDLE_AFTER_MS + 0xFFFFFF00UL, false, 0);
+  CHECK(cadence.pace() == sched::Pace::Idle);
+  cadence.touch(100);
+  cadence.update(200, false, SCHED_SLOW_RTT_MS * 1000UL + 1);
+  CHECK(cadence.pace() == sched::Pace::Normal);
+
+  sched::Task list[] = {{countRun, thousandMs, &taskChanged, 0}};
+  sched::TaskTable table(list);
+  table.runDue(999);
+  CHECK(taskRuns == 0 && table.nextDueMs(999, 5000) == 1);
+  table.runDue(1000);
+  CHECK(taskRuns == 1 && table.nextDueMs(1000, 5000) == 1000 && table.nextDueMs(1000, 300) == 300);
+  taskChanged = true;
+  CHECK(table.nextDueMs(1001, 5000) == 0);
+  taskResult = false;  // a failed run stays due
+  table.runDue(1001);
+  table.runDue(1002);
+  CHECK(taskRuns == 3 && table.nextDueMs(1002, 5000) == 0);
+}
+
+/** Truncated and corrupted replies must fail (or parse) without touching bad memory. */
+void checkCorruptReplies() {
+  const std::string valid[] = {kXreadReply, "+OK\r\n$5\r\nhello\r\n$-1\r\n:3\r\n"};
+  Lcg rng{12345};
+  unsigned rounds = 0;
+  for (int i = 0; i < 4000; ++i) {
+    std::string reply = valid[i & 1];
+    if (rng.next(2)) {
+      reply.resize(rng.next(static_cast<uint32_t>(reply.size())));
+    }
+    for (uint32_t flips = rng.next(4); flips; --flips) {
+      reply[rng.next(static_cast<uint32_t>(reply.size() + 1)) % (reply.size() ? reply.size() : 1)] =
+          static_cast<char>(rng.next(256));
+    }
+    ScriptedClient client;
+    client.chunk = 1 + rng.next(9);
+    RedisLink link(client);
+    link.setTimeout(1);
+    client.reset(reply);
+    client.open = false;
+    if (i & 1) {
+      String a;
+      String b;
+      link.beginPipeline();
+      link.queueSet("a", "hello");
+      link.queueGet("a", a);
+      link.queueGet("b", b);
+      link.queuePublish("c", "d");
+      link.execPipeline();
+    } else {
+      RecordingVisitor visitor;
+      link.xread("cmd:room:7", 0, "0-0", 8, visitor);
+    }
+    ++rounds;
+  }
+  std::printf("corrupt replies: %u parsed without faults\n", rounds);
+}
+
+}  // namespace
+
+int main() {
+  checkEncoding();
+  for (size_t chunk : {size_t{0}, size_t{1}, size_t{7}}) {
+    checkPipeline(chunk);
+    checkXread(chunk);
+  }
+  checkContracts();
+  checkPrecedence();
+  checkHistogram();
+  checkScheduler();
+  checkCorruptReplies();
+  if (failures) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("ok\n");
+  return 0;
+}
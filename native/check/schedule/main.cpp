@@ -0,0 +1,170 @@
+// Host check: the sender's compiled schedule table vs the reference evaluator.
+//
+//   pio run -d native -e check_schedule -t exec
+//
+// For a spread of schedules (defaults, midnight wraps, disabled windows, overlapping
+// sunrise/quiet ramps, random configs) every second of the day is looked up through the
+// compiled table and compared with evaluateScheduleBrightness(). secondsUntilScheduleChange()
+// is checked against the reference's actual next change at sampled seconds and at every
+// segment edge, and scheduleRampAt() must land on the reference value at the end of
+// every fade it describes. Exits non-zero on the first schedule that disagrees.
+
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+#include "schedule.hpp"
+
+namespace {
+
+using scheduling::CompiledSchedule;
+using scheduling::kSecondsPerDay;
+using scheduling::RoomSchedule;
+
+constexpr uint32_t kProbeStride = 13;
+constexpr int kRandomSchedules = 400;
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t bound) {
+    state = state * 1664525UL + 1013904223UL;
+    return (state >> 8) % bound;
+  }
+};
+
+RoomSchedule makeSchedule(bool wake, uint16_t wakeStart, uint16_t wakeDuration, uint8_t peak, bool night,
+                          uint16_t nightStart, uint8_t nightLevel, uint8_t baseline) {
+  RoomSchedule cfg;
+  cfg.wakeEnabled = wake;
+  cfg.wakeStartMin = wakeStart;
+  cfg.wakeDurationMin = wakeDuration;
+  cfg.wakePeakBrightness = peak;
+  cfg.nightEnabled = night;
+  cfg.nightStartMin = nightStart;
+  cfg.nightBrightness = nightLevel;
+  cfg.baselineBrightness = baseline;
+  return cfg;
+}
+
+void describe(const RoomSchedule &cfg) {
+  std::printf("  wake[%d] %u +%um -> %u%%  night[%d] %u -> %u%%  baseline %u%%\n", cfg.wakeEnabled,
+              cfg.wakeStartMin, cfg.wakeDurationMin, cfg.wakePeakBrightness, cfg.nightEnabled, cfg.nightStartMin,
+              cfg.nightBrightness, cfg.baselineBrightness);
+}
+
+/** Returns false (after printing the first discrepancy) when the table disagrees. */
+bool checkSchedule(const RoomSchedule &cfg) {
+  CompiledSchedule compiled;
+  scheduling::compileSchedule(cfg, compiled);
+  if (compiled.count == 0 || compiled.count > scheduling::kMaxScheduleSegments || compiled.segments[0].start != 0) {
+    std::printf("bad table (%u segments)\n", compiled.count);
+    describe(cfg);
+    return false;
+  }
+
+  std::vector<uint8_t> reference(kSecondsPerDay);
+  for (uint32_t s = 0; s < kSecondsPerDay; ++s) {
+    reference[s] = scheduling::evaluateScheduleBrightness(cfg, s);
+    uint8_t looked = scheduling::lookupScheduleBrightness(compiled, s);
+    if (looked != reference[s]) {
+      std::printf("lookup mismatch at %" PRIu32 "s: table %u reference %u\n", s, looked, reference[s]);
+      describe(cfg);
+      return false;
+    }
+  }
+
+  // untilChange[s]: seconds until the reference output first differs from reference[s],
+  // following the day wrap; kSecondsPerDay when the output never changes.
+  std::vector<uint32_t> untilChange(kSecondsPerDay, kSecondsPerDay);
+  uint32_t nextDiffer = UINT32_MAX;
+  for (uint32_t i = 2 * kSecondsPerDay; i-- > 0;) {
+    uint32_t s = i % kSecondsPerDay;
+    uint32_t after = (i + 1) % kSecondsPerDay;
+    if (i + 1 < 2 * kSecondsPerDay && reference[after] != reference[s]) {
+      nextDiffer = i + 1;
+    }
+    if (i < kSecondsPerDay && nextDiffer != UINT32_MAX) {
+      untilChange[s] = nextDiffer - i;
+    }
+  }
+
+  auto probe = [&](uint32_t s) {
+    s %= kSecondsPerDay;
+    uint32_t got = scheduling::secondsUntilScheduleChange(compiled, s);
+    if (got != untilChange[s]) {
+      std::printf("next-change mismatch at %" PRIu32 "s: table %" PRIu32 " reference %" PRIu32 "\n", s, got,
+                  untilChange[s]);
+      describe(cfg);
+      return false;
+    }
+    return true;
+  };
+  for (uint32_t s = 0; s < kSecondsPerDay; s += kProbeStride) {
+    if (!probe(s)) {
+      return false;
+    }
+    scheduling::ScheduleRamp ramp = scheduling::scheduleRampAt(compiled, s);
+    uint32_t end = s + ramp.durationSec;
+    if (end >= kSecondsPerDay || (ramp.durationSec == 0 && ramp.target != reference[s]) ||
+        ramp.target != reference[end]) {
+      std::printf("ramp mismatch at %" PRIu32 "s: target %u after %" PRIu32 "s\n", s, ramp.target,
+                  ramp.durationSec);
+      describe(cfg);
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < compiled.count; ++i) {
+    uint32_t edge = compiled.segments[i].start;
+    if (!probe(edge) || !probe(edge + 1) || !probe(edge + kSecondsPerDay - 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<RoomSchedule> cases;
+  cases.push_back(RoomSchedule());
+  for (int wake = 0; wake < 2; ++wake) {
+    for (int night = 0; night < 2; ++night) {
+      cases.push_back(makeSchedule(wake, 7 * 60, 20, 100, night, 22 * 60, 5, 0));
+      cases.push_back(makeSchedule(wake, 7 * 60, 45, 80, night, 22 * 60, 0, 10));
+    }
+  }
+  // Sunrise ramp wrapping midnight, quiet ramp wrapping midnight, edges on midnight.
+  cases.push_back(makeSchedule(true, 10, 30, 100, true, 22 * 60, 5, 0));
+  cases.push_back(makeSchedule(true, 0, 30, 100, true, 0, 5, 0));
+  cases.push_back(makeSchedule(true, 7 * 60, 20, 100, true, 30, 5, 0));
+  cases.push_back(makeSchedule(true, 23 * 60 + 59, 1440, 60, true, 23 * 60 + 59, 2, 1));
+  // Quiet ramp overlapping the sunrise ramp, night starting inside the sunrise window.
+  cases.push_back(makeSchedule(true, 7 * 60, 120, 100, true, 7 * 60, 5, 0));
+  cases.push_back(makeSchedule(true, 7 * 60, 60, 100, true, 6 * 60 + 30, 20, 0));
+  cases.push_back(makeSchedule(true, 6 * 60, 30, 100, true, 6 * 60 + 30, 40, 50));
+  // Flat days and night brighter than day.
+  cases.push_back(makeSchedule(true, 7 * 60, 30, 0, true, 22 * 60, 0, 0));
+  cases.push_back(makeSchedule(true, 7 * 60, 30, 30, true, 22 * 60, 90, 30));
+
+  Lcg rng{0x5eed1234UL};
+  for (int i = 0; i < kRandomSchedules; ++i) {
+    cases.push_back(makeSchedule(rng.next(4) != 0, static_cast<uint16_t>(rng.next(scheduling::kMinutesPerDay)),
+                                 static_cast<uint16_t>(rng.next(8) == 0 ? rng.next(1441) : rng.next(181)),
+                                 static_cast<uint8_t>(rng.next(101)), rng.next(4) != 0,
+                                 static_cast<uint16_t>(rng.next(scheduling::kMinutesPerDay)),
+                                 static_cast<uint8_t>(rng.next(101)), static_cast<uint8_t>(rng.next(101))));
+  }
+
+  size_t segments = 0;
+  for (const RoomSchedule &cfg : cases) {
+    if (!checkSchedule(cfg)) {
+      return 1;
+    }
+    CompiledSchedule compiled;
+    scheduling::compileSchedule(cfg, compiled);
+    segments += compiled.count;
+  }
+  std::printf("ok: %zu schedules x %" PRIu32 " seconds, %.1f segments/table on average\n", cases.size(),
+              kSecondsPerDay, static_cast<double>(segments) / cases.size());
+  return 0;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+// Minimal Arduino core surface for building shared headers (contracts, RedisLink) on the
+// host. Only what the firmware headers and host tools actually use is provided.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#define PROGMEM
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+
+#include "pgmspace.h"
+
+/** std::string-backed stand-in for the Arduino `String` class. */
+class String {
+ public:
+  String() = default;
+  String(const char *c) : s_(c ? c : "") {}
+  String(const __FlashStringHelper *c) : s_(reinterpret_cast<const char *>(c)) {}
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int v) : s_(std::to_string(v)) {}
+  explicit String(unsigned v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+  String &operator=(const char *c) {
+    s_ = c ? c : "";
+    return *this;
+  }
+  String &operator=(const __FlashStringHelper *c) { return *this = reinterpret_cast<const char *>(c); }
+
+  bool reserve(unsigned n) {
+    s_.reserve(n);
+    return true;
+  }
+  unsigned length() const { return static_cast<unsigned>(s_.size()); }
+  const char *c_str() const { return s_.c_str(); }
+  char operator[](unsigned i) const { return i < s_.size() ? s_[i] : '\0'; }
+  void remove(unsigned index) {
+    if (index < s_.size()) {
+      s_.erase(index);
+    }
+  }
+  void remove(unsigned index, unsigned count) {
+    if (index < s_.size()) {
+      s_.erase(index, count);
+    }
+  }
+  bool concat(const char *c) {
+    s_.append(c ? c : "");
+    return true;
+  }
+  bool concat(const char *c, unsigned n) {
+    s_.append(c, n);
+    return true;
+  }
+  bool concat(const String &o) {
+    s_ += o.s_;
+    return true;
+  }
+  bool concat(char c) {
+    s_ += c;
+    return true;
+  }
+  String &operator+=(const String &o) {
+    concat(o);
+    return *this;
+  }
+  String &operator+=(const char *c) {
+    concat(c);
+    return *this;
+  }
+  String &operator+=(char c) {
+    concat(c);
+    return *this;
+  }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  bool operator!=(const String &o) const { return s_ != o.s_; }
+  bool operator==(const char *c) const { return s_ == (c ? c : ""); }
+  bool operator!=(const char *c) const { return !(*this == c); }
+  bool startsWith(const char *prefix) const { return s_.compare(0, strlen(prefix), prefix) == 0; }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+
+ private:
+  std::string s_;
+};
+
+/** ArduinoJson's String adapters also name this helper type. */
+class StringSumHelper : public String {
+ public:
+  using String::String;
+};
+
+inline unsigned long millis() {
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return static_cast<unsigned long>(duration_cast<milliseconds>(steady_clock::now() - start).count());
+}
+
+inline unsigned long micros() {
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return static_cast<unsigned long>(duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void yield() {}
+
+/** Byte sink with the `print`/`printf_P` helpers the firmware headers log through. */
+class Print {
+ public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *data, size_t size) {
+    size_t n = 0;
+    while (n < size && write(data[n])) {
+      ++n;
+    }
+    return n;
+  }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t write(const char *s) { return write(reinterpret_cast<const uint8_t *>(s), strlen(s)); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+  size_t println(const char *s = "") { return print(s) + write("\n"); }
+  size_t println(const __FlashStringHelper *s) { return print(s) + write("\n"); }
+  size_t printf_P(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) {
+      return 0;
+    }
+    return write(reinterpret_cast<const uint8_t *>(buf), static_cast<size_t>(n) < sizeof(buf) ? n : sizeof(buf) - 1);
+  }
+};
+
+/** `Serial` goes straight to stdout and never reports a full FIFO. */
+class HardwareSerial : public Print {
+ public:
+  using Print::write;
+  size_t write(uint8_t c) override { return std::fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t write(const uint8_t *data, size_t size) override { return std::fwrite(data, 1, size, stdout); }
+  int availableForWrite() override { return 4096; }
+  void flush() override { std::fflush(stdout); }
+  void begin(unsigned long) {}
+};
+
+inline HardwareSerial Serial;
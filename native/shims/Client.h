@@ -0,0 +1,43 @@
+#pragma once
+
+// Arduino `Client` interface as used by RedisLink: a byte stream with a read timeout.
+
+#include "Arduino.h"
+
+class Client : public Print {
+ public:
+  using Print::write;
+
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual uint8_t connected() = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int read(uint8_t *buf, size_t size) = 0;
+  virtual void stop() = 0;
+
+  void setTimeout(unsigned long ms) { timeoutMs_ = ms; }
+
+  /** Reads up to `length` bytes, waiting up to the timeout for each chunk (Arduino `Stream`). */
+  size_t readBytes(char *buffer, size_t length) {
+    size_t got = 0;
+    unsigned long start = millis();
+    while (got < length) {
+      if (available() > 0) {
+        int n = read(reinterpret_cast<uint8_t *>(buffer) + got, length - got);
+        if (n > 0) {
+          got += static_cast<size_t>(n);
+          start = millis();
+          continue;
+        }
+      }
+      if (!connected() || millis() - start >= timeoutMs_) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return got;
+  }
+
+ protected:
+  unsigned long timeoutMs_ = 1000;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+// `Client` over a blocking POSIX TCP socket, so host tools can drive RedisLink against a
+// real Redis. `available()` asks the kernel (FIONREAD) instead of blocking, which keeps
+// RedisLink's asynchronous `pollXread()` non-blocking exactly as on the ESP8266.
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include "Client.h"
+
+class PosixClient : public Client {
+ public:
+  PosixClient() = default;
+  PosixClient(const PosixClient &) = delete;
+  PosixClient &operator=(const PosixClient &) = delete;
+  ~PosixClient() override { stop(); }
+
+  int connect(const char *host, uint16_t port) override {
+    stop();
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *found = nullptr;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &found) != 0) {
+      return 0;
+    }
+    for (addrinfo *ai = found; ai; ai = ai->ai_next) {
+      int fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0) {
+        continue;
+      }
+      if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+        fd_ = fd;
+        break;
+      }
+      ::close(fd);
+    }
+    freeaddrinfo(found);
+    if (fd_ < 0) {
+      return 0;
+    }
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return 1;
+  }
+
+  uint8_t connected() override {
+    if (fd_ < 0) {
+      return 0;
+    }
+    if (available() > 0) {
+      return 1;
+    }
+    // A readable socket with nothing to read has been closed by the peer.
+    char probe;
+    ssize_t n = ::recv(fd_, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+
+  int available() override {
+    if (fd_ < 0) {
+      return 0;
+    }
+    int pending = 0;
+    if (ioctl(fd_, FIONREAD, &pending) != 0) {
+      return 0;
+    }
+    return pending;
+  }
+
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  int read(uint8_t *buf, size_t size) override {
+    if (fd_ < 0) {
+      return -1;
+    }
+    ssize_t n = ::recv(fd_, buf, size, MSG_DONTWAIT);
+    return n > 0 ? static_cast<int>(n) : -1;
+  }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t *data, size_t size) override {
+    size_t sent = 0;
+    while (fd_ >= 0 && sent < size) {
+      ssize_t n = ::send(fd_, data + sent, size - sent, MSG_NOSIGNAL);
+      if (n <= 0) {
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        stop();
+        break;
+      }
+      sent += static_cast<size_t>(n);
+    }
+    return sent;
+  }
+
+  void stop() override {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+ private:
+  int fd_ = -1;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+// In-memory `Client` for host checks and microbenchmarks: replies are queued up front,
+// everything RedisLink writes is captured, and `chunk` limits how many bytes each
+// `available()`/`read()` exposes so parsers see replies split at arbitrary points.
+
+#include <string>
+
+#include "Client.h"
+
+class ScriptedClient : public Client {
+ public:
+  std::string input;
+  std::string output;
+  size_t readPos = 0;
+  size_t chunk = 0;  // 0 = expose everything queued
+  bool open = true;
+
+  /** Replaces the queued replies and clears what was written. */
+  void reset(const std::string &replies) {
+    input = replies;
+    readPos = 0;
+    output.clear();
+    open = true;
+  }
+
+  int connect(const char *, uint16_t) override {
+    open = true;
+    return 1;
+  }
+  uint8_t connected() override { return open || readPos < input.size(); }
+
+  int available() override {
+    size_t left = input.size() - readPos;
+    return static_cast<int>(chunk && left > chunk ? chunk : left);
+  }
+
+  int read() override {
+    if (readPos >= input.size()) {
+      return -1;
+    }
+    return static_cast<uint8_t>(input[readPos++]);
+  }
+
+  int read(uint8_t *buf, size_t size) override {
+    size_t n = std::min(size, static_cast<size_t>(available()));
+    if (!n) {
+      return -1;
+    }
+    memcpy(buf, input.data() + readPos, n);
+    readPos += n;
+    return static_cast<int>(n);
+  }
+
+  size_t write(uint8_t c) override {
+    output.push_back(static_cast<char>(c));
+    return 1;
+  }
+  size_t write(const uint8_t *data, size_t size) override {
+    output.append(reinterpret_cast<const char *>(data), size);
+    return size;
+  }
+
+  void stop() override { open = false; }
+};
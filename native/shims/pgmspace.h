@@ -0,0 +1,11 @@
+#pragma once
+
+// Flash and RAM share one address space on the host.
+
+#include <cstring>
+
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+#define vsnprintf_P vsnprintf
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
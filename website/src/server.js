@@ -11,6 +11,60 @@ const appConfig = {
   redisPassword: process.env.REDIS_PASSWORD || ''
 };
 const STREAM_TRIM_LENGTH = 200;
+/** Rooms whose snapshot keys share one `MGET` when loading several rooms at once. */
+const MGET_ROOMS_PER_COMMAND = 100;
+/** Upper bound on the rooms one `GET /api/rooms` request may ask for (or return per page). */
+const FLEET_MAX_ROOMS = 1000;
+/**
+ * Sorted set of every room id (all scores 0, so members sort by id), kept by the
+ * receiver's provisioning script and every website write; `GET /api/rooms` pages it.
+ */
+const ROOM_INDEX_KEY = 'rooms:index';
+/**
+ * `contracts::kWireCompact`: receivers that advertise this in `room:{id}:wire` also accept
+ * the packed `m`/`b`/`v` stream fields instead of JSON in `p`.
+ */
+const WIRE_COMPACT = 2;
+/** Event names published on `evt:room:{id}` (`contracts::kEventCfg` / `kEventOverride`). */
+const EVENT_CFG = 'cfg';
+const EVENT_OVERRIDE = 'override';
+/** `contracts::kEventWard`: `room:{id}:ward` changed, receivers re-read it. */
+const EVENT_WARD = 'ward';
+/**
+ * `contracts::kRoomIdMaxLen`: receivers ignore longer ward ids, since the ward's stream
+ * key must fit the buffers they parse it into.
+ */
+const WARD_ID_MAX_LEN = 15;
+/** `contracts::kPriorityMax`: ward broadcasts carry a `prio` from 0 (normal) to this. */
+const PRIORITY_MAX = 9;
+
+/**
+ * Same script as `contracts::kPublishScript` in the firmware: overwrites the snapshot key,
+ * appends the trimmed stream entry (the JSON `p` field, or the field/value pairs passed
+ * after ARGV[4]), and rejects versions not newer than the stored snapshot (ARGV[4] = 1
+ * also accepts an equal one). Returns `ver` when it wrote, otherwise the stored version
+ * + 1, the lowest version worth retrying with.
+ */
+const PUBLISH_SCRIPT = `
+local ver = tonumber(ARGV[2]) or 0
+local cur = redis.call('GET', KEYS[1])
+if cur then
+  local ok, doc = pcall(cjson.decode, cur)
+  if ok and type(doc) == 'table' then
+    local stored = tonumber(doc['ver'])
+    if stored and (stored > ver or (stored == ver and ARGV[4] ~= '1')) then
+      return stored + 1
+    end
+  end
+end
+redis.call('SET', KEYS[1], ARGV[1])
+if #ARGV > 4 then
+  redis.call('XADD', KEYS[2], 'MAXLEN', '~', ARGV[3], '*', unpack(ARGV, 5))
+else
+  redis.call('XADD', KEYS[2], 'MAXLEN', '~', ARGV[3], '*', 'p', ARGV[1])
+end
+return ver
+`;
 
 /**
  * Tiny RESP client that speaks enough of the Redis protocol for this project.
@@ -29,6 +83,7 @@ class RedisClient {
     this.ready = false;
     this.connectPromise = null;
     this.closed = false;
+    this.scriptShas = new Map();
   }
 
   /**
@@ -114,6 +169,30 @@ class RedisClient {
     });
   }
 
+  /**
+   * Writes every command in one socket write and resolves with the replies in order,
+   * so N commands cost one round-trip instead of N. Error replies do not stop the batch;
+   * once all replies are in, the first error (if any) is thrown.
+   * @param {Array<Array<string|Buffer>>} commands
+   * @returns {Promise<Array<*>>}
+   */
+  async pipeline(commands) {
+    await this.ensureConnected();
+    if (!this.socket) {
+      throw new Error('Redis socket unavailable');
+    }
+    const replies = commands.map(() => new Promise((resolve, reject) => {
+      this.queue.push({ resolve, reject });
+    }));
+    this.socket.write(Buffer.concat(commands.map(encodeCommand)));
+    const settled = await Promise.allSettled(replies);
+    const failed = settled.find((result) => result.status === 'rejected');
+    if (failed) {
+      throw failed.reason;
+    }
+    return settled.map((result) => result.value);
+  }
+
   /**
    * Appends new data to the buffer and tries to parse queued replies.
    * @param {Buffer} chunk
@@ -159,6 +238,76 @@ class RedisClient {
     return this.sendCommand(['SET', key, value]);
   }
 
+  /**
+   * Issues `MGET key...`; missing keys come back as `null`.
+   * @param {string[]} keys
+   * @returns {Promise<Array<string|null>>}
+   */
+  async mget(keys) {
+    return this.sendCommand(['MGET', ...keys]);
+  }
+
+  /**
+   * Issues `HGETALL key` and folds the flat reply into an object.
+   * @param {string} key
+   * @returns {Promise<Object<string, string>>}
+   */
+  async hgetall(key) {
+    return foldHashReply(await this.sendCommand(['HGETALL', key]));
+  }
+
+  /**
+   * Walks `SCAN cursor MATCH pattern` to completion and returns the matching keys.
+   * @param {string} pattern
+   * @param {number} [limit] stop once this many keys were collected
+   * @returns {Promise<string[]>}
+   */
+  async scanKeys(pattern, limit = Infinity) {
+    const keys = new Set();
+    let cursor = '0';
+    do {
+      const [next, batch] = await this.sendCommand(['SCAN', cursor, 'MATCH', pattern, 'COUNT', '500']);
+      batch.forEach((key) => keys.add(key));
+      cursor = next;
+    } while (cursor !== '0' && keys.size < limit);
+    return [...keys];
+  }
+
+  /**
+   * Issues `PUBLISH channel message`.
+   * @param {string} channel
+   * @param {string} message
+   */
+  async publish(channel, message) {
+    return this.sendCommand(['PUBLISH', channel, message]);
+  }
+
+  /**
+   * Runs a Lua script through `EVALSHA`, loading it with `SCRIPT LOAD` on first use and
+   * again whenever the server answers `NOSCRIPT`.
+   * @param {string} script
+   * @param {string[]} keys
+   * @param {Array<string|number>} args
+   */
+  async evalScript(script, keys, args) {
+    for (let attempt = 0; attempt < 2; attempt += 1) {
+      let sha = this.scriptShas.get(script);
+      if (!sha) {
+        sha = await this.sendCommand(['SCRIPT', 'LOAD', script]);
+        this.scriptShas.set(script, sha);
+      }
+      try {
+        return await this.sendCommand(['EVALSHA', sha, String(keys.length), ...keys, ...args.map(String)]);
+      } catch (err) {
+        if (!/^NOSCRIPT/.test(err.message) || attempt > 0) {
+          throw err;
+        }
+        this.scriptShas.delete(script);
+      }
+    }
+    return null;
+  }
+
   /** Gracefully shuts down the socket and rejects future commands. */
   close() {
     this.closed = true;
@@ -169,6 +318,22 @@ class RedisClient {
   }
 }
 
+/**
+ * Folds a flat `HGETALL` reply (`[field, value, ...]`) into an object.
+ * @param {Array<string>|null} flat
+ * @returns {Object<string, string>}
+ */
+function foldHashReply(flat) {
+  const fields = {};
+  if (!flat) {
+    return fields;
+  }
+  for (let i = 0; i + 1 < flat.length; i += 2) {
+    fields[flat[i]] = flat[i + 1];
+  }
+  return fields;
+}
+
 /**
  * Encodes an array of strings/buffers into a RESP bulk command.
  * @param {Array<string|Buffer>} parts
@@ -501,10 +666,24 @@ async function loadSchedule(roomId) {
   return readSchedulePayload(payload);
 }
 
-/** Pulls the most recent quiet-hour sound warning for the room. */
-async function loadLatestWarning(roomId) {
-  const payload = await redis.get(roomWarningKey(roomId));
-  return readWarningPayload(payload);
+/**
+ * Parses the per-device timing snapshots from a `room:{id}:metrics` hash as
+ * `{ receiver, sender }`; a device that has not reported (or whose snapshot expired)
+ * is `null`.
+ */
+function readMetricsFields(roomId, fields) {
+  const metrics = { receiver: null, sender: null };
+  for (const device of Object.keys(metrics)) {
+    if (!fields[device]) {
+      continue;
+    }
+    try {
+      metrics[device] = JSON.parse(fields[device]);
+    } catch (err) {
+      console.warn(`[website] invalid ${device} metrics for room ${roomId}, ignoring`);
+    }
+  }
+  return metrics;
 }
 
 /** Persists the merged schedule JSON back to Redis. */
@@ -515,6 +694,8 @@ async function saveSchedule(roomId, schedule) {
   }
   const serialized = JSON.stringify(schedule);
   await redis.set(key, serialized);
+  await indexRoom(roomId);
+  await notifyRoom(roomId, EVENT_CFG);
 }
 
 /** Helper for `room:{id}:cfg`. */
@@ -532,11 +713,72 @@ function roomDesiredKey(roomId) {
   return `room:${roomId}:desired`;
 }
 
+/** Helper for `room:{id}:wire`. */
+function roomWireKey(roomId) {
+  return `room:${roomId}:wire`;
+}
+
+/** Helper for `room:{id}:metrics`. */
+function roomMetricsKey(roomId) {
+  return `room:${roomId}:metrics`;
+}
+
+/** Helper for `room:{id}:ward` (the ward whose broadcasts the room follows). */
+function roomWardKey(roomId) {
+  return `room:${roomId}:ward`;
+}
+
+/** Helper for `ward:{ward}:desired`. */
+function wardDesiredKey(wardId) {
+  return `ward:${wardId}:desired`;
+}
+
+/** Helper for `cmd:ward:{ward}`. */
+function wardCommandStream(wardId) {
+  return `cmd:ward:${wardId}`;
+}
+
 /** Helper for `cmd:room:{id}`. */
 function roomCommandStream(roomId) {
   return `cmd:room:${roomId}`;
 }
 
+/** Helper for `evt:room:{id}` (pub/sub change notifications). */
+function roomEventChannel(roomId) {
+  return `evt:room:${roomId}`;
+}
+
+/**
+ * Tells subscribed devices that a room key changed. Devices fall back to slow polling,
+ * so a failed notification only delays the update and never fails the request.
+ */
+async function notifyRoom(roomId, event) {
+  try {
+    await redis.publish(roomEventChannel(roomId), event);
+  } catch (err) {
+    console.warn(`[website] event ${event} for room ${roomId} not published: ${err.message}`);
+  }
+}
+
+/** Adds a room to `ROOM_INDEX_KEY` (a no-op when it is already listed). */
+async function indexRoom(roomId) {
+  await redis.sendCommand(['ZADD', ROOM_INDEX_KEY, '0', roomId]);
+}
+
+/**
+ * Lists rooms provisioned before `ROOM_INDEX_KEY` existed: one `SCAN` of the
+ * `room:{id}:desired` keys every room has, run once at startup.
+ */
+async function backfillRoomIndex() {
+  const keys = await redis.scanKeys('room:*:desired');
+  const roomIds = keys.map((key) => key.slice('room:'.length, -':desired'.length)).filter(isValidRoomId);
+  for (let i = 0; i < roomIds.length; i += FLEET_MAX_ROOMS) {
+    const members = roomIds.slice(i, i + FLEET_MAX_ROOMS).flatMap((roomId) => ['0', roomId]);
+    await redis.sendCommand(['ZADD', ROOM_INDEX_KEY, ...members]);
+  }
+  return roomIds.length;
+}
+
 /** Helper for `room:{id}:latest_warning`. */
 function roomWarningKey(roomId) {
   return `room:${roomId}:latest_warning`;
@@ -546,7 +788,11 @@ function roomWarningKey(roomId) {
  * Reads the override snapshot or returns a default placeholder.
  */
 async function getOverrideState(roomId) {
-  const payload = await redis.get(roomOverrideKey(roomId));
+  return readOverridePayload(await redis.get(roomOverrideKey(roomId)));
+}
+
+/** Parses the stored override JSON, falling back to a disabled placeholder. */
+function readOverridePayload(payload) {
   if (!payload) {
     return { enabled: false, ver: 0, updated_at: 0, source: 'unknown' };
   }
@@ -576,6 +822,8 @@ async function setOverrideState(roomId, enabled, source = 'website') {
     source
   };
   await redis.set(roomOverrideKey(roomId), JSON.stringify(next));
+  await indexRoom(roomId);
+  await notifyRoom(roomId, EVENT_OVERRIDE);
   return next;
 }
 
@@ -585,36 +833,171 @@ async function setOverrideState(roomId, enabled, source = 'website') {
 async function sendBrightnessCommand(roomId, brightness, source = 'website') {
   const clamped = clampBrightness(brightness);
   const desiredKey = roomDesiredKey(roomId);
-  const payload = await redis.get(desiredKey);
+  const streamKey = roomCommandStream(roomId);
+  const [payload, wire] = await Promise.all([redis.get(desiredKey), redis.get(roomWireKey(roomId))]);
   const current = readDesiredPayload(payload);
-  const ver = Number.isInteger(current.ver) ? current.ver + 1 : 1;
-  const desired = {
-    room: roomId,
-    mode: clamped > 0 ? 'on' : 'off',
-    brightness: clamped,
-    ver,
-    source
+  // Receivers that never advertised a wire format only understand the JSON `p` field.
+  const compact = Number(wire) >= WIRE_COMPACT;
+  let ver = Number.isInteger(current.ver) ? current.ver + 1 : 1;
+  // Retry once if a device published a newer version between our GET and the script.
+  for (let attempt = 0; attempt < 2; attempt += 1) {
+    const desired = {
+      room: roomId,
+      mode: clamped > 0 ? 'on' : 'off',
+      brightness: clamped,
+      ver,
+      source
+    };
+    const serialized = JSON.stringify(desired);
+    const args = [serialized, ver, STREAM_TRIM_LENGTH, 0];
+    if (compact) {
+      args.push('m', desired.mode === 'on' ? 1 : 0, 'b', clamped, 'v', ver);
+    }
+    const storedVer = await redis.evalScript(PUBLISH_SCRIPT, [desiredKey, streamKey], args);
+    if (storedVer === ver) {
+      await indexRoom(roomId);
+      return desired;
+    }
+    ver = storedVer;
+  }
+  throw new Error(`desired version for room ${roomId} kept moving`);
+}
+
+/**
+ * Assigns the room to a ward (or removes it from any when `wardId` is empty) and tells
+ * its receiver to start following the ward's broadcasts. Ward ids must pass
+ * `isValidWardId()`.
+ */
+async function setRoomWard(roomId, wardId) {
+  if (wardId && !isValidWardId(wardId)) {
+    throw new Error(`invalid ward id: ${wardId}`);
+  }
+  if (wardId) {
+    await redis.set(roomWardKey(roomId), wardId);
+  } else {
+    await redis.sendCommand(['DEL', roomWardKey(roomId)]);
+  }
+  await indexRoom(roomId);
+  await notifyRoom(roomId, EVENT_WARD);
+}
+
+/**
+ * Broadcasts a brightness command to every room of a ward with one write: the shared
+ * publish script updates `ward:{ward}:desired` and appends to `cmd:ward:{ward}`, which
+ * each receiver in the ward reads next to its own room stream. Broadcasts are versioned
+ * per ward and always use the JSON `p` field, since a ward mixes receivers of every wire
+ * format. Receivers show a broadcast unless the room is held by a higher `prio`.
+ */
+async function sendWardCommand(wardId, brightness, priority, source = 'website') {
+  const clamped = clampBrightness(brightness);
+  const desiredKey = wardDesiredKey(wardId);
+  const current = readDesiredPayload(await redis.get(desiredKey));
+  let ver = Number.isInteger(current.ver) ? current.ver + 1 : 1;
+  for (let attempt = 0; attempt < 2; attempt += 1) {
+    const desired = {
+      ward: wardId,
+      mode: clamped > 0 ? 'on' : 'off',
+      brightness: clamped,
+      ver,
+      scope: 'ward',
+      prio: priority,
+      source
+    };
+    const args = [JSON.stringify(desired), ver, STREAM_TRIM_LENGTH, 0];
+    const storedVer = await redis.evalScript(PUBLISH_SCRIPT, [desiredKey, wardCommandStream(wardId)], args);
+    if (storedVer === ver) {
+      return desired;
+    }
+    ver = storedVer;
+  }
+  throw new Error(`desired version for ward ${wardId} kept moving`);
+}
+
+/** Snapshot keys read for every room, in the order `roomStateFromPayloads()` expects. */
+function roomStateKeys(roomId) {
+  return [
+    roomConfigKey(roomId), roomOverrideKey(roomId), roomWarningKey(roomId), roomDesiredKey(roomId),
+    roomWardKey(roomId)
+  ];
+}
+
+/** Builds the rendered room state from the `roomStateKeys()` payloads. */
+function roomStateFromPayloads([cfg, override, warning, desired, ward]) {
+  const schedule = readSchedulePayload(cfg);
+  return {
+    schedule,
+    quiet: quietTimesFromSchedule(schedule),
+    override: readOverridePayload(override),
+    warning: readWarningPayload(warning),
+    desired: readDesiredPayload(desired),
+    ward: ward || null
   };
-  const serialized = JSON.stringify(desired);
-  await redis.set(desiredKey, serialized);
-  const streamKey = roomCommandStream(roomId);
-  await redis.sendCommand(['XADD', streamKey, '*', 'p', serialized]);
-  await redis.sendCommand([
-    'XTRIM',
-    streamKey,
-    'MAXLEN',
-    '~',
-    String(STREAM_TRIM_LENGTH)
-  ]);
-  return desired;
-}
-
-/** Loads schedule, override, and warning payloads in parallel for UI rendering. */
+}
+
+/**
+ * Loads the state of several rooms in one round-trip: their snapshot keys are split
+ * into `MGET`s of `MGET_ROOMS_PER_COMMAND` rooms and, with `withMetrics`, followed by
+ * one `HGETALL room:{id}:metrics` per room, all written as a single pipeline.
+ * @param {string[]} roomIds
+ * @param {{ withMetrics?: boolean }} [options]
+ * @returns {Promise<Array<Object>>} one state object per room, in `roomIds` order
+ */
+async function loadRoomStates(roomIds, { withMetrics = false } = {}) {
+  const commands = [];
+  for (let i = 0; i < roomIds.length; i += MGET_ROOMS_PER_COMMAND) {
+    commands.push(['MGET', ...roomIds.slice(i, i + MGET_ROOMS_PER_COMMAND).flatMap(roomStateKeys)]);
+  }
+  const mgetCount = commands.length;
+  if (withMetrics) {
+    roomIds.forEach((roomId) => commands.push(['HGETALL', roomMetricsKey(roomId)]));
+  }
+  const replies = await redis.pipeline(commands);
+  const payloads = replies.slice(0, mgetCount).flat();
+  const keysPerRoom = roomStateKeys('').length;
+  return roomIds.map((roomId, index) => {
+    const state = roomStateFromPayloads(payloads.slice(index * keysPerRoom, (index + 1) * keysPerRoom));
+    if (withMetrics) {
+      state.metrics = readMetricsFields(roomId, foldHashReply(replies[mgetCount + index]));
+    }
+    return state;
+  });
+}
+
+/** Loads schedule, override, warning, desired, and ward payloads with a single `MGET`. */
 async function loadRoomState(roomId) {
-  const [schedule, override, warning] =
-      await Promise.all([loadSchedule(roomId), getOverrideState(roomId), loadLatestWarning(roomId)]);
-  const quiet = quietTimesFromSchedule(schedule);
-  return { schedule, quiet, override, warning };
+  const [state] = await loadRoomStates([roomId]);
+  return state;
+}
+
+/**
+ * Room ids for the fleet endpoint. With `ids`, the comma-separated list (at most
+ * `FLEET_MAX_ROOMS`). Otherwise one page of `ROOM_INDEX_KEY`, in id order: up to `limit`
+ * (default and cap `FLEET_MAX_ROOMS`) rooms after the `after` cursor, read with one
+ * `ZRANGEBYLEX`. `next` is the cursor of the following page, null on the last one.
+ * Returns null when an id, the cursor or the limit is invalid.
+ */
+async function resolveFleetRoomIds(params) {
+  const idsParam = params.get('ids');
+  if (idsParam !== null) {
+    const roomIds = [...new Set(idsParam.split(',').map((id) => id.trim()).filter(Boolean))];
+    if (!roomIds.every(isValidRoomId) || roomIds.length > FLEET_MAX_ROOMS) {
+      return null;
+    }
+    return { roomIds, next: null };
+  }
+  const after = params.get('after');
+  const limitParam = params.get('limit');
+  const limit = limitParam === null ? FLEET_MAX_ROOMS : Number(limitParam);
+  if ((after !== null && !isValidRoomId(after)) || !Number.isInteger(limit) || limit < 1 ||
+      limit > FLEET_MAX_ROOMS) {
+    return null;
+  }
+  // One extra member tells whether another page follows.
+  const members = await redis.sendCommand(
+      ['ZRANGEBYLEX', ROOM_INDEX_KEY, after === null ? '-' : `(${after}`, '+', 'LIMIT', '0', String(limit + 1)]);
+  const next = members.length > limit ? members[limit - 1] : null;
+  const roomIds = members.slice(0, limit).filter(isValidRoomId);
+  return { roomIds, next };
 }
 
 /**
@@ -663,6 +1046,8 @@ function renderStatusMessage(code) {
       return 'Requested full brightness.';
     case 'brightness-min':
       return 'Requested minimum brightness.';
+    case 'ward-updated':
+      return 'Ward assignment saved.';
     default:
       return null;
   }
@@ -782,6 +1167,18 @@ function renderRoomPage(roomId, state, statusCode) {
       </form>
     </div>
   </section>
+  <section id="ward">
+    <h2>Ward</h2>
+    <p>${state.ward ? `Follows broadcasts for ward <strong>${htmlEscape(state.ward)}</strong>.`
+                    : 'Not assigned to a ward.'}</p>
+    <form method="POST" action="/room/${encodeURIComponent(roomId)}/ward">
+      <input type="hidden" name="anchor" value="ward">
+      <label>Ward id
+        <input type="text" name="ward" maxlength="${WARD_ID_MAX_LEN}" value="${htmlEscape(state.ward || '')}" placeholder="(none)">
+      </label>
+      <button type="submit" class="primary">Save Ward</button>
+    </form>
+  </section>
   <section id="brightness">
     <h2>Instant Brightness (For Testing Purposes)</h2>
     <p>Send an immediate brightness command to the room light.</p>
@@ -831,7 +1228,7 @@ function renderIndexPage() {
 
 /** Parses `/room/{id}` and optional action suffixes. */
 function matchRoomRoute(pathname) {
-  const match = pathname.match(/^\/room\/([^/]+)(?:\/(quiet-hours|override|brightness))?\/?$/);
+  const match = pathname.match(/^\/room\/([^/]+)(?:\/(quiet-hours|override|brightness|ward))?\/?$/);
   if (!match) {
     return null;
   }
@@ -855,11 +1252,48 @@ function matchApiRoute(pathname) {
   return { roomId };
 }
 
+/** Parses `/api/wards/{ward}/command`. */
+function matchWardCommandRoute(pathname) {
+  const match = pathname.match(/^\/api\/wards\/([^/]+)\/command\/?$/);
+  if (!match) {
+    return null;
+  }
+  const wardId = decodeURIComponent(match[1]);
+  if (!isValidWardId(wardId)) {
+    return null;
+  }
+  return { wardId };
+}
+
+/**
+ * Reads the brightness of a broadcast: `level=max|min` like the room buttons, or an
+ * explicit `brightness=0..100`. Returns null when neither is valid.
+ */
+function parseBroadcastBrightness(params) {
+  const level = params.get('level');
+  if (level === 'max') {
+    return 100;
+  }
+  if (level === 'min') {
+    return 0;
+  }
+  const value = params.get('brightness');
+  if (value === null || !/^\d{1,3}$/.test(value) || Number(value) > 100) {
+    return null;
+  }
+  return Number(value);
+}
+
 /** Returns true when a given room id string is syntactically valid. */
 function isValidRoomId(value) {
   return typeof value === 'string' && /^[A-Za-z0-9_-]+$/.test(value);
 }
 
+/** Returns true when a ward id is a valid room id no longer than receivers accept. */
+function isValidWardId(value) {
+  return isValidRoomId(value) && value.length <= WARD_ID_MAX_LEN;
+}
+
 /** Primary HTTP request handler for UI, API, and health checks. */
 async function handleRequest(req, res) {
   const url = new URL(req.url, `http://${req.headers.host || 'localhost'}`);
@@ -957,11 +1391,59 @@ async function handleRequest(req, res) {
       res.end();
       return;
     }
+    if (req.method === 'POST' && action === 'ward') {
+      const body = await readRequestBody(req);
+      const params = new URLSearchParams(body);
+      const wardId = (params.get('ward') || '').trim();
+      if (wardId && !isValidWardId(wardId)) {
+        res.writeHead(400, { 'Content-Type': 'text/plain; charset=utf-8' });
+        res.end('Invalid ward id');
+        return;
+      }
+      await setRoomWard(roomId, wardId);
+      const location = roomRedirectLocation(roomId, 'ward-updated', params.get('anchor'));
+      res.writeHead(303, { Location: location });
+      res.end();
+      return;
+    }
+  }
+
+  const wardRoute = matchWardCommandRoute(pathname);
+  if (wardRoute && req.method === 'POST') {
+    const body = await readRequestBody(req);
+    const params = new URLSearchParams(body);
+    const brightness = parseBroadcastBrightness(params);
+    const priorityParam = params.get('priority') || '0';
+    const priority = /^\d$/.test(priorityParam) ? Number(priorityParam) : -1;
+    if (brightness === null || priority < 0 || priority > PRIORITY_MAX) {
+      res.writeHead(400, { 'Content-Type': 'text/plain; charset=utf-8' });
+      res.end(`Expected level=max|min or brightness=0..100, and priority=0..${PRIORITY_MAX}`);
+      return;
+    }
+    const desired = await sendWardCommand(wardRoute.wardId, brightness, priority, 'website');
+    res.writeHead(200, { 'Content-Type': 'application/json; charset=utf-8' });
+    res.end(JSON.stringify({ ward: wardRoute.wardId, desired }));
+    return;
+  }
+
+  if (req.method === 'GET' && (pathname === '/api/rooms' || pathname === '/api/rooms/')) {
+    const page = await resolveFleetRoomIds(url.searchParams);
+    if (!page) {
+      res.writeHead(400, { 'Content-Type': 'text/plain; charset=utf-8' });
+      res.end(`Invalid room ids, cursor or limit (at most ${FLEET_MAX_ROOMS} per request)`);
+      return;
+    }
+    const { roomIds, next } = page;
+    const states = await loadRoomStates(roomIds, { withMetrics: true });
+    const rooms = roomIds.map((roomId, index) => ({ room: roomId, ...states[index] }));
+    res.writeHead(200, { 'Content-Type': 'application/json; charset=utf-8' });
+    res.end(JSON.stringify({ count: rooms.length, next, rooms }));
+    return;
   }
 
   const apiRoute = matchApiRoute(pathname);
   if (apiRoute && req.method === 'GET') {
-    const data = await loadRoomState(apiRoute.roomId);
+    const [data] = await loadRoomStates([apiRoute.roomId], { withMetrics: true });
     res.writeHead(200, { 'Content-Type': 'application/json; charset=utf-8' });
     res.end(JSON.stringify({ room: apiRoute.roomId, ...data }));
     return;
@@ -997,6 +1479,9 @@ const server = http.createServer((req, res) => {
 server.listen(appConfig.port, () => {
   console.log(
       `[website] listening on port ${appConfig.port} (Redis ${appConfig.redisHost}:${appConfig.redisPort})`);
+  backfillRoomIndex()
+      .then((count) => console.log(`[website] room index holds ${count} scanned room(s)`))
+      .catch((err) => console.warn(`[website] room index backfill failed: ${err.message}`));
 });
 
 process.on('SIGINT', () => {